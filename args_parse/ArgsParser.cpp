@@ -3,15 +3,41 @@
 #include <string>
 #include <string_view>
 #include <algorithm>
+#include <iterator>
+#include <utility>
+#include <stdexcept>
+#include <array>
+#include <cctype>
 
 namespace args_parse {
 	const static int StartingPosition = 0;
 	const static int LenghtOneChar = 1;
 	const static int LenghtTwoChar = 2;
+	const static char ResponseFilePrefix = '@';
+	const static size_t MaxResponseFileDepth = 32;
+
+	namespace {
+		/// Все значения char подряд: подсказка с коротким именем указывает на свой символ в этой таблице
+		constexpr std::array<char, 256> ShortNameTable = [] {
+			std::array<char, 256> table{};
+			for (std::size_t k = 0; k < table.size(); ++k)
+				table[k] = static_cast<char>(k);
+			return table;
+		}();
+
+		/// @brief Строка из одного короткого имени, живущая все время работы программы
+		std::string_view ShortNameView(char shortName) {
+			return { &ShortNameTable[static_cast<unsigned char>(shortName)], 1 };
+		}
+	}
 
 	ArgsParser::ArgsParser(int argc, const char** argv) : _argc(argc), _argv(argv) {}
 
 	void ArgsParser::Add(ArgumentBase* arg) {
+		// Индекс неизменяем после заморозки
+		if (_frozen) {
+			throw std::logic_error("Cannot add argument to a frozen parser");
+		}
 		// Такое имя аргумента может уже существовать
 		for (const auto& existingArg : _args) {
 			if (existingArg->GetLongName() == arg->GetLongName()) {
@@ -21,6 +47,26 @@ namespace args_parse {
 		_args.push_back(arg);
 	}
 
+	void ArgsParser::Freeze()
+	{
+		if (_frozen)
+			return;
+		_shortIndex.fill(nullptr);
+		_longIndex.clear();
+		_longIndex.reserve(_args.size());
+		for (const auto& arg : _args)
+		{
+			const auto shortName = static_cast<unsigned char>(arg->GetShortName());
+			//при совпадении коротких имен побеждает первый добавленный аргумент
+			if (shortName != '\0' && _shortIndex[shortName] == nullptr)
+				_shortIndex[shortName] = arg;
+			_longIndex.emplace_back(arg->GetLongName(), arg);
+		}
+		std::sort(_longIndex.begin(), _longIndex.end(),
+			[](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+		_frozen = true;
+	}
+
 	void ArgsParser::ShowHelp() const
 	{
 		std::cout << "\nSupported commands:" << std::endl;
@@ -63,66 +109,161 @@ namespace args_parse {
 		return OperatorType::Nope;
 	}
 
-	ArgumentBase* ArgsParser::FindLongNameArg(std::string_view item) const
+	std::pair<ArgumentBase*, LookupStatus> ArgsParser::LookupLongName(std::string_view item) const
 	{
-		ArgumentBase* foundArg = nullptr;
-		int matchingCount = 0;
+		//строка может быть префиксом
+		if (item.length() <= 1) {
+			return { nullptr, LookupStatus::NotFound };
+		}
+		if (!_frozen) {
+			ArgumentBase* foundArg = nullptr;
+			int matchingCount = 0;
+			for (const auto& arg : _args)
+			{
+				std::string_view longArg = arg->GetLongName();
+				if (longArg == item)
+					return { arg, LookupStatus::Found };
+				if (longArg.substr(StartingPosition, item.length()) == item) {
+					matchingCount++;
+					foundArg = arg;
+				}
+			}
+			if (matchingCount == 0) {
+				return { nullptr, LookupStatus::NotFound };
+			}
+			else if (matchingCount > 1) {
+				return { nullptr, LookupStatus::Ambiguous };
+			}
+			return { foundArg, LookupStatus::Found };
+		}
 
+		// Первый элемент, не меньший префикса, - единственный кандидат на точное совпадение
+		auto it = std::lower_bound(_longIndex.begin(), _longIndex.end(), item,
+			[](const auto& entry, std::string_view key) { return entry.first < key; });
+		if (it == _longIndex.end() || it->first.substr(StartingPosition, item.length()) != item) {
+			return { nullptr, LookupStatus::NotFound };
+		}
+		//точное совпадение имеет приоритет над префиксом
+		if (it->first.length() == item.length()) {
+			return { it->second, LookupStatus::Found };
+		}
+		auto next = std::next(it);
+		if (next != _longIndex.end() && next->first.substr(StartingPosition, item.length()) == item) {
+			return { nullptr, LookupStatus::Ambiguous };
+		}
+		return { it->second, LookupStatus::Found };
+	}
+
+	ArgumentBase* ArgsParser::LookupShortName(std::string_view item) const
+	{
+		if (item.empty())
+			return nullptr;
+		if (_frozen)
+			return _shortIndex[static_cast<unsigned char>(item[StartingPosition])];
 		for (const auto& arg : _args)
 		{
-			auto longArg = arg->GetLongName();
-			//строка может быть префиксом
-			if (item.length() > 1 && item.length() <= longArg.length()
-				&& longArg.compare(StartingPosition, item.length(), item) == 0) {
-				matchingCount++;
-				foundArg = arg;
-			}
+			if (arg->GetShortName() != '\0' && arg->GetShortName() == item[StartingPosition])
+				return arg;
 		}
-		if (matchingCount == 0) {
+		return nullptr;
+	}
+
+	ArgumentBase* ArgsParser::FindLongNameArg(std::string_view item) const
+	{
+		const auto [arg, status] = LookupLongName(item);
+		if (status == LookupStatus::NotFound) {
 			throw std::invalid_argument("Not found");
 		}
-		else if (matchingCount > 1) {
+		else if (status == LookupStatus::Ambiguous) {
 			throw std::invalid_argument("Prefix is not unique");
 		}
-
-		return foundArg;
+		return arg;
 	}
 
 	ArgumentBase* ArgsParser::FindShortNameArg(std::string_view item) const
 	{
-		for (const auto& arg : _args)
-		{
-			size_t position = item.find(arg->GetShortName());
-			if (position == StartingPosition)
-			{
-				return arg;
-			}
+		ArgumentBase* arg = LookupShortName(item);
+		if (arg == nullptr) {
+			throw std::invalid_argument("Transferring multiple values");
 		}
-		throw std::invalid_argument("Transferring multiple values");
+		return arg;
 	}
 
-	bool ArgsParser::Parse()
+	ParseResult ArgsParser::Parse()
 	{
+		Freeze();
+		_responseChain.clear();
+		// Пути могли появиться или исчезнуть с прошлого разбора
+		_pathCache.Clear();
+		ParseResult result;
 		for (int i = 1; i < _argc; ++i) {
 			std::string_view argStr(_argv[i]);
-			OperatorType o_type = IsOperator(argStr);
-			std::string_view argName;
-			std::string_view argValue;
-			BaseParametrs parametrs{ argStr, argName, argValue };
-			//обработка длинного аргумента
-			if (argStr.substr(StartingPosition, LenghtTwoChar) == "--")
-				parametrs = ParseLongArgument(parametrs);
-			//обработка короткого аргумента
-			else if (argStr[0] == '-')
-				parametrs = ParseShortArgument(parametrs);
-			//строка может быть без аргументов
-			else {
-				std::string errorMessage = "Invalid argument format: " + std::string(parametrs.argStr);
-				throw std::invalid_argument(errorMessage);
-			}
-			ProcessArgument(parametrs, i);
+			//аргумент может быть ссылкой на файл ответов
+			if (!argStr.empty() && argStr[0] == ResponseFilePrefix)
+				ExpandResponseFile(argStr, i, result);
+			else
+				ParseToken(argStr, i, result);
+		}
+		return result;
+	}
+
+	void ArgsParser::ParseToken(std::string_view argStr, int& i, ParseResult& result)
+	{
+		std::string_view argName;
+		std::string_view argValue;
+		BaseParametrs parametrs{ argStr, argName, argValue };
+		//обработка длинного аргумента
+		if (argStr.substr(StartingPosition, LenghtTwoChar) == "--")
+			parametrs = ParseLongArgument(parametrs);
+		//обработка короткого аргумента
+		else if (!argStr.empty() && argStr[0] == '-')
+			parametrs = ParseShortArgument(parametrs);
+		//строка может быть без аргументов
+		else {
+			Report(result, { i, DiagnosticKind::InvalidFormat, argStr, argStr, {} });
+			return;
 		}
-		return true;
+		ProcessArgument(parametrs, i, result);
+	}
+
+	void ArgsParser::ExpandResponseFile(std::string_view token, int& i, ParseResult& result)
+	{
+		const std::string_view path = token.substr(LenghtOneChar);
+		if (_responseChain.size() >= MaxResponseFileDepth) {
+			Report(result, { i, DiagnosticKind::ResponseFileTooDeep, token, path, {} });
+			return;
+		}
+		std::unique_ptr<MappedFile> mapped;
+		try {
+			mapped = std::make_unique<MappedFile>(std::filesystem::path(path));
+		}
+		catch (const std::invalid_argument&) {
+			Report(result, { i, DiagnosticKind::ResponseFileUnreadable, token, path, {} });
+			return;
+		}
+		// Файл уже может разбираться выше по цепочке вложенности
+		if (std::find(_responseChain.begin(), _responseChain.end(), mapped->Id()) != _responseChain.end()) {
+			Report(result, { i, DiagnosticKind::ResponseFileCycle, token, path, {} });
+			return;
+		}
+		// Аргументы и ошибки указывают внутрь отображения, поэтому оно живет вместе с результатом
+		const MappedFile& file = *result.responseFiles.emplace_back(std::move(mapped));
+		_responseChain.push_back(file.Id());
+		TokenizeResponseBuffer(file.Data(), file.Size(), [this, &i, &result](std::string_view argument) {
+			if (!argument.empty() && argument[0] == ResponseFilePrefix)
+				ExpandResponseFile(argument, i, result);
+			else
+				ParseToken(argument, i, result);
+		});
+		_responseChain.pop_back();
+	}
+
+	void ArgsParser::Report(ParseResult& result, const Diagnostic& diagnostic) const
+	{
+		if (_sink != nullptr)
+			_sink->Report(diagnostic);
+		else
+			result.Add(diagnostic);
 	}
 
 	BaseParametrs ArgsParser::ParseLongArgument(BaseParametrs p_param)
@@ -148,7 +289,7 @@ namespace args_parse {
 		return p_param;
 	}
 
-	BaseParametrs ArgsParser::ParseShortArgument(BaseParametrs p_param) const
+	BaseParametrs ArgsParser::ParseShortArgument(BaseParametrs p_param)
 	{
 		p_param.argName = p_param.argStr.substr(LenghtOneChar, LenghtOneChar);
 		if (p_param.argStr.length() > LenghtTwoChar && (p_param.argStr[2] == '=' || p_param.argStr[2] == ' '))
@@ -158,38 +299,110 @@ namespace args_parse {
 		return p_param;
 	}
 
-	void ArgsParser::ProcessArgument(BaseParametrs p_param, int& i) const
+	void ArgsParser::ProcessArgument(BaseParametrs p_param, int& i, ParseResult& result) const
 	{
-		ArgumentBase* arg = FindArgument(p_param);
-		//ссылка может быть null
-		if (arg != nullptr) {
-			arg->SetIsDefined(true);
-			//аргумент может не содержать параметр
-			if (arg->HasValue()) {
-				if (p_param.argValue.empty()) {
-					std::string errorMessage = "Missing value for argument: " + std::string(p_param.argName);
-					std::cerr << errorMessage << std::endl;
-					return;
-				}
-				if(arg->IsValidatorExist());
-					ValidationValue(p_param, arg, i);
+		ArgumentBase* arg = nullptr;
+		if (IsOperator(p_param.argStr) == OperatorType::Long) {
+			const auto [found, status] = LookupLongName(p_param.argName);
+			if (status == LookupStatus::Ambiguous) {
+				Report(result, { i, DiagnosticKind::AmbiguousPrefix, p_param.argStr, p_param.argName, p_param.argValue });
+				return;
 			}
+			arg = found;
 		}
 		else {
-			std::cerr << "Unknown argument: " << p_param.argStr << std::endl;
+			arg = LookupShortName(p_param.argName);
+		}
+		//ссылка может быть null
+		if (arg == nullptr) {
+			// Для короткого аргумента сравниваем весь текст после '-' ("-verbos" -> "verbos")
+			std::string_view typed = p_param.argName;
+			if (IsOperator(p_param.argStr) == OperatorType::Short) {
+				typed = p_param.argStr.substr(LenghtOneChar);
+				typed = typed.substr(StartingPosition, typed.find('='));
+			}
+			Diagnostic diagnostic{ i, DiagnosticKind::UnknownArgument, p_param.argStr, p_param.argName, p_param.argValue };
+			const char shortName = p_param.argName.length() == LenghtOneChar ? p_param.argName.front() : '\0';
+			FillSuggestions(typed, shortName, diagnostic.suggestions);
+			Report(result, diagnostic);
+			return;
+		}
+		arg->SetIsDefined(true);
+		//аргумент может не содержать параметр
+		if (arg->HasValue()) {
+			if (p_param.argValue.empty()) {
+				Report(result, { i, DiagnosticKind::MissingValue, p_param.argStr, p_param.argName, p_param.argValue });
+				return;
+			}
+			if (arg->IsValidatorExist())
+				ValidationValue(p_param, arg, i, result);
 		}
 	}
 
-	void ArgsParser::ValidationValue(BaseParametrs parametrs, ArgumentBase* arg, int& i) const {
-		std::cout << "\nString: " << parametrs.argStr << " ; Name: " << parametrs.argName << " ;" << std::endl;
-		//в случае, если аргумент принимает значение, значение может быть пустым		
-		bool result = arg->ValidationAndSetValue(parametrs.argValue);
-		if (result) {
-			std::cout << "Value: " << parametrs.argValue << std::endl;
+	void ArgsParser::ValidationValue(BaseParametrs parametrs, ArgumentBase* arg, int& i, ParseResult& result) const {
+		//в случае, если аргумент принимает значение, значение может быть пустым
+		if (!arg->ValidationAndSetValue(parametrs.argValue, _pathCache)) {
+			Report(result, { i, DiagnosticKind::InvalidValue, parametrs.argStr, parametrs.argName, parametrs.argValue });
 		}
-		else {
-			std::cerr << "Invalid value for argument: " << parametrs.argStr << std::endl;
+	}
+
+	std::vector<Suggestion> ArgsParser::Suggest(std::string_view name) const
+	{
+		std::array<Suggestion, MaxSuggestions> suggestions{};
+		FillSuggestions(name, name.length() == LenghtOneChar ? name.front() : '\0', suggestions);
+		std::vector<Suggestion> found;
+		for (const auto& suggestion : suggestions)
+			if (!suggestion.name.empty())
+				found.push_back(suggestion);
+		return found;
+	}
+
+	void ArgsParser::FillSuggestions(std::string_view name, char shortName, std::array<Suggestion, MaxSuggestions>& suggestions) const
+	{
+		// Лучшие подсказки держатся упорядоченными в массиве фиксированного размера
+		std::array<std::size_t, MaxSuggestions> distances{};
+		std::size_t count = 0;
+		const auto precedes = [&](std::size_t distance, const Suggestion& lhs, std::size_t k) {
+			if (distance != distances[k])
+				return distance < distances[k];
+			if (lhs.name != suggestions[k].name)
+				return lhs.name < suggestions[k].name;
+			return lhs.isShort && !suggestions[k].isShort;
+		};
+		const auto offer = [&](std::size_t distance, Suggestion candidate) {
+			std::size_t position = count;
+			while (position > 0 && precedes(distance, candidate, position - 1))
+				--position;
+			if (position >= MaxSuggestions)
+				return;
+			if (count < MaxSuggestions)
+				++count;
+			for (std::size_t k = count - 1; k > position; --k) {
+				suggestions[k] = suggestions[k - 1];
+				distances[k] = distances[k - 1];
+			}
+			suggestions[position] = candidate;
+			distances[position] = distance;
+		};
+
+		// Образец строится один раз и сравнивается со всеми именами
+		const EditDistancePattern pattern(name);
+		const auto lowered = [](char symbol) { return static_cast<char>(std::tolower(static_cast<unsigned char>(symbol))); };
+		for (const auto& arg : _args)
+		{
+			std::string_view longName = arg->GetLongName();
+			const std::size_t distance = pattern.Distance(longName, MaxSuggestionDistance);
+			//слишком короткие имена совпадают с чем угодно
+			if (distance <= MaxSuggestionDistance && distance < longName.length())
+				offer(distance, { longName, false });
+
+			// Одна буква отличается от любой другой на 1, поэтому короткие имена сравниваются без учета регистра
+			const char argShortName = arg->GetShortName();
+			if (shortName != '\0' && argShortName != '\0' && lowered(argShortName) == lowered(shortName))
+				offer(argShortName == shortName ? 0 : 1, { ShortNameView(argShortName), true });
 		}
+		for (std::size_t k = count; k < MaxSuggestions; ++k)
+			suggestions[k] = {};
 	}
 
 	ArgumentBase* ArgsParser::FindArgument(BaseParametrs param) const
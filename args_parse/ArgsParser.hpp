@@ -1,5 +1,8 @@
 #pragma once
 #include "argument.hpp"
+#include "Diagnostics.hpp"
+#include "EditDistance.hpp"
+#include "ResponseFile.hpp"
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -8,6 +11,9 @@
 #include <string_view>
 #include <optional>
 #include <tuple>
+#include <array>
+#include <memory>
+#include <utility>
 
 namespace args_parse {
 	class ArgumentBase;
@@ -18,6 +24,12 @@ namespace args_parse {
 		Short,
 		Nope
 	};
+	/// @brief Результат поиска аргумента по имени
+	enum class LookupStatus {
+		Found,
+		NotFound,
+		Ambiguous
+	};
 	/// @brief Структура для определения параметров
 	struct BaseParametrs {
 		std::string_view argStr;
@@ -32,11 +44,32 @@ namespace args_parse {
 		ArgsParser(int argc, const char** argv);
 
 		/// @brief Добавление аргумента командной строки в вектор
+		/// После вызова Freeze() добавлять аргументы нельзя.
 		void Add(ArgumentBase* arg);
 
+		/// @brief Заморозка набора аргументов.
+		/// Строит неизменяемый индекс: прямую таблицу коротких имен и отсортированный массив длинных имен.
+		/// Вызывается автоматически из Parse(), если не был вызван явно.
+		void Freeze();
+
+		/// @brief Проверка, заморожен ли набор аргументов
+		[[nodiscard]] bool IsFrozen() const { return _frozen; }
+
 		/// @brief Парсинг аргументов командной строки.
-		/// Проходит по каждому аргументу командной строки и проверяет, был ли найден аргумент в векторе
-		[[nodiscard]] bool Parse();
+		/// Проходит по каждому аргументу командной строки и проверяет, был ли найден аргумент в векторе.
+		/// Аргумент вида @path заменяется содержимым файла ответов (см. TokenizeResponseBuffer),
+		/// файлы могут быть вложенными. Нечитаемый файл, цикл и слишком глубокая вложенность
+		/// сообщаются так же, как ошибки аргументов; отображения файлов принадлежат ParseResult.
+		/// Ошибки отдельных аргументов ничего не выводят: они передаются в DiagnosticsSink,
+		/// а если он не задан - собираются в возвращаемый ParseResult.
+		/// Кэш состояний путей принадлежит парсеру и очищается в начале разбора.
+		/// Успешный разбор замороженного набора флагов, числовых аргументов и длительностей
+		/// не выделяет память в куче (проверяется тестом _unit_test_args_parse_alloc).
+		[[nodiscard]] ParseResult Parse();
+
+		/// @brief Установка получателя ошибок разбора.
+		/// nullptr возвращает поведение по умолчанию (сбор ошибок в ParseResult).
+		void SetDiagnosticsSink(DiagnosticsSink* sink) { _sink = sink; }
 
 		/// @brief Вывод справки об использовании программы.
 		/// Выводит описание всех добавленных аргументов командной строки
@@ -50,21 +83,50 @@ namespace args_parse {
 		/// В зависимости от оператора вызывает поиск короткого или длинного имени.
 		[[nodiscard]] ArgumentBase* FindArgument(BaseParametrs param) const;
 
-	private:
+		/// @brief Подбор похожих имен для неизвестного имени (не больше MaxSuggestions).
+		/// Длинные имена ранжируются по расстоянию Левенштейна (не больше MaxSuggestionDistance);
+		/// односимвольное имя сравнивается и с короткими именами без учета регистра ("T" -> -t).
+		/// При равном расстоянии имена упорядочены по алфавиту, короткое раньше длинного.
+		[[nodiscard]] std::vector<Suggestion> Suggest(std::string_view name) const;
+
+		/// Максимальное расстояние Левенштейна для подсказки
+		static constexpr std::size_t MaxSuggestionDistance = 3;
+
 		/// @brief Разбор длинных аргументов командной строки.
 		/// Извлекает имя и значение аргумента для дальнейшей обработки.
-		[[nodiscard]] BaseParametrs ParseLongArgument(BaseParametrs p_param);
+		[[nodiscard]] static BaseParametrs ParseLongArgument(BaseParametrs p_param);
 
 		/// @brief Разбор коротких аргументов командной строки.
 		/// Извлекает имя и значение аргумента для дальнейшей обработки.
-		[[nodiscard]] BaseParametrs ParseShortArgument(BaseParametrs p_param) const;
+		[[nodiscard]] static BaseParametrs ParseShortArgument(BaseParametrs p_param);
+
+	private:
+		/// @brief Разбор одного аргумента командной строки или файла ответов
+		void ParseToken(std::string_view argStr, int& i, ParseResult& result);
+
+		/// @brief Подстановка аргументов из файла ответов (token - аргумент вместе с '@').
+		/// Файл отображается в память и остается отображенным, пока существует result.
+		void ExpandResponseFile(std::string_view token, int& i, ParseResult& result);
+
+		/// @brief Передача ошибки в DiagnosticsSink или в результат разбора
+		void Report(ParseResult& result, const Diagnostic& diagnostic) const;
 
 		/// @brief Обработка одного аргумента командной строки.
 		/// Также проверяет его наличие, наличие у него значени¤, если да, то его проверку.
-		void ProcessArgument(BaseParametrs p_param, int& i) const;
+		void ProcessArgument(BaseParametrs p_param, int& i, ParseResult& result) const;
 
 		/// @brief Валидация значения
-		void ValidationValue(BaseParametrs p_param, ArgumentBase* arg, int& i) const;
+		void ValidationValue(BaseParametrs p_param, ArgumentBase* arg, int& i, ParseResult& result) const;
+
+		/// @brief Поиск длинного имени или его уникального префикса без исключений
+		[[nodiscard]] std::pair<ArgumentBase*, LookupStatus> LookupLongName(std::string_view item) const;
+
+		/// @brief Поиск короткого имени без исключений (nullptr, если не найдено)
+		[[nodiscard]] ArgumentBase* LookupShortName(std::string_view item) const;
+
+		/// @brief Заполнение подсказок без выделения памяти.
+		/// shortName - набранное короткое имя ('\0' - сравнивать только длинные имена)
+		void FillSuggestions(std::string_view name, char shortName, std::array<Suggestion, MaxSuggestions>& suggestions) const;
 
 		/// @brief Поиск длинного имени, если оно есть
 		[[nodiscard]] ArgumentBase* FindLongNameArg(std::string_view item) const;
@@ -82,5 +144,17 @@ namespace args_parse {
 		const char** _argv;
 		/// Вектор аргументов командной строки
 		std::vector<ArgumentBase*> _args;
+		/// Прямая таблица коротких имен (индекс - код символа)
+		std::array<ArgumentBase*, 256> _shortIndex{};
+		/// Длинные имена, отсортированные для поиска по префиксу
+		std::vector<std::pair<std::string_view, ArgumentBase*>> _longIndex;
+		/// Флаг построенного индекса
+		bool _frozen = false;
+		/// Файлы ответов, разбираемые в данный момент (для обнаружения циклов)
+		std::vector<FileId> _responseChain;
+		/// Получатель ошибок разбора (nullptr - сбор в ParseResult)
+		DiagnosticsSink* _sink = nullptr;
+		///Кэш состояний путей текущего разбора (заполняется и из const-проверок значений)
+		mutable PathStatusCache _pathCache;
 	};
 }
\ No newline at end of file
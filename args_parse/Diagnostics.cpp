@@ -0,0 +1,54 @@
+#include "Diagnostics.hpp"
+#include <string>
+
+namespace args_parse {
+	void ParseResult::Render(std::ostream& os) const
+	{
+		if (diagnostics.empty())
+			return;
+		std::string text;
+		for (const auto& diagnostic : diagnostics) {
+			switch (diagnostic.kind) {
+			case DiagnosticKind::InvalidFormat:
+				text += "Invalid argument format: ";
+				break;
+			case DiagnosticKind::UnknownArgument:
+				text += "Unknown argument: ";
+				break;
+			case DiagnosticKind::AmbiguousPrefix:
+				text += "Prefix is not unique: ";
+				break;
+			case DiagnosticKind::MissingValue:
+				text += "Missing value for argument: ";
+				break;
+			case DiagnosticKind::InvalidValue:
+				text += "Invalid value for argument: ";
+				break;
+			case DiagnosticKind::ResponseFileUnreadable:
+				text += "Cannot read response file: ";
+				break;
+			case DiagnosticKind::ResponseFileCycle:
+				text += "Response file includes itself: ";
+				break;
+			case DiagnosticKind::ResponseFileTooDeep:
+				text += "Response files are nested too deeply: ";
+				break;
+			}
+			text += diagnostic.token;
+			std::size_t count = 0;
+			while (count < diagnostic.suggestions.size() && !diagnostic.suggestions[count].name.empty())
+				++count;
+			for (std::size_t k = 0; k < count; ++k) {
+				//"--a", "--a or -b", "--a, -b or --c"
+				text += k == 0 ? " (did you mean " : k + 1 == count ? " or " : ", ";
+				text += diagnostic.suggestions[k].isShort ? "-" : "--";
+				text += diagnostic.suggestions[k].name;
+			}
+			if (count > 0)
+				text += "?)";
+			text += '\n';
+		}
+		os.write(text.data(), static_cast<std::streamsize>(text.size()));
+		os.flush();
+	}
+}
\ No newline at end of file
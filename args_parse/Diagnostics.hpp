@@ -0,0 +1,94 @@
+#pragma once
+#include "ResponseFile.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace args_parse {
+	/// @brief Вид ошибки разбора командной строки
+	enum class DiagnosticKind {
+		/// Аргумент не начинается с '-' или "--"
+		InvalidFormat,
+		/// Аргумент с таким именем не зарегистрирован
+		UnknownArgument,
+		/// Префикс длинного имени подходит нескольким аргументам
+		AmbiguousPrefix,
+		/// Аргумент требует значение, но оно не передано
+		MissingValue,
+		/// Значение не прошло проверку валидатором
+		InvalidValue,
+		/// Файл ответов (@path) нельзя открыть или отобразить в память
+		ResponseFileUnreadable,
+		/// Файл ответов включает сам себя (напрямую или через другие файлы)
+		ResponseFileCycle,
+		/// Превышена глубина вложенности файлов ответов
+		ResponseFileTooDeep
+	};
+
+	/// Максимальное количество подсказок для неизвестного аргумента
+	constexpr std::size_t MaxSuggestions = 3;
+
+	/// @brief Зарегистрированное имя, похожее на неизвестное
+	struct Suggestion {
+		/// Имя без '-' или "--" (пустое - подсказки нет)
+		std::string_view name;
+		/// Короткое имя (-x), иначе длинное (--name)
+		bool isShort = false;
+	};
+
+	/// @brief Запись об ошибке разбора.
+	/// Строки указывают внутрь argv или файлов ответов, отображенных в ParseResult этого разбора,
+	/// и живут, пока живы argv и этот ParseResult.
+	struct Diagnostic {
+		/// Номер аргумента в argv (для файла ответов - номер аргумента @path)
+		int tokenIndex;
+		DiagnosticKind kind;
+		/// Аргумент целиком
+		std::string_view token;
+		/// Имя аргумента
+		std::string_view name;
+		/// Значение аргумента
+		std::string_view value;
+		/// Похожие зарегистрированные имена для неизвестного аргумента, от ближайшего
+		std::array<Suggestion, MaxSuggestions> suggestions = {};
+	};
+
+	/// @brief Получатель ошибок разбора.
+	/// По умолчанию ошибки собираются в ParseResult и никуда не выводятся.
+	class DiagnosticsSink {
+	public:
+		virtual ~DiagnosticsSink() = default;
+
+		/// @brief Обработка одной ошибки
+		virtual void Report(const Diagnostic& diagnostic) = 0;
+	};
+
+	/// @brief Результат разбора командной строки
+	struct ParseResult {
+		/// Сколько записей резервируется при первой ошибке
+		static constexpr std::size_t DiagnosticsReserve = 16;
+
+		/// Ошибки разбора (пусто, если они переданы в пользовательский DiagnosticsSink)
+		std::vector<Diagnostic> diagnostics;
+		/// Файлы ответов этого разбора: отображения освобождаются вместе с результатом
+		std::vector<std::unique_ptr<MappedFile>> responseFiles;
+
+		/// @brief Разбор прошел без ошибок
+		[[nodiscard]] bool Ok() const { return diagnostics.empty(); }
+
+		explicit operator bool() const { return Ok(); }
+
+		/// @brief Добавление записи об ошибке
+		void Add(const Diagnostic& diagnostic) {
+			if (diagnostics.capacity() == 0)
+				diagnostics.reserve(DiagnosticsReserve);
+			diagnostics.push_back(diagnostic);
+		}
+
+		/// @brief Вывод всех ошибок одной операцией записи
+		void Render(std::ostream& os) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "EditDistance.hpp"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace args_parse {
+	EditDistancePattern::EditDistancePattern(std::string_view pattern) : _pattern(pattern)
+	{
+		if (_pattern.size() > MaxBitParallelLength)
+			return;
+		for (std::size_t i = 0; i < _pattern.size(); ++i)
+			_peq[static_cast<unsigned char>(_pattern[i])] |= std::uint64_t{ 1 } << i;
+	}
+
+	std::size_t EditDistancePattern::Distance(std::string_view text, std::size_t maxDistance) const
+	{
+		const std::size_t m = _pattern.size();
+		const std::size_t lengthDifference = m > text.size() ? m - text.size() : text.size() - m;
+		// Расстояние не меньше разницы длин
+		if (lengthDifference > maxDistance)
+			return maxDistance + 1;
+		if (m == 0)
+			return text.size();
+		if (m > MaxBitParallelLength)
+			return DistanceDynamic(text, maxDistance);
+
+		const std::uint64_t last = std::uint64_t{ 1 } << (m - 1);
+		std::uint64_t pv = ~std::uint64_t{ 0 };
+		std::uint64_t mv = 0;
+		std::size_t score = m;
+		for (std::size_t j = 0; j < text.size(); ++j) {
+			const std::uint64_t eq = _peq[static_cast<unsigned char>(text[j])];
+			const std::uint64_t xv = eq | mv;
+			const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+			std::uint64_t ph = mv | ~(xh | pv);
+			std::uint64_t mh = pv & xh;
+			if (ph & last)
+				++score;
+			else if (mh & last)
+				--score;
+			// Верхняя строка матрицы растет на 1 в каждом столбце (глобальное расстояние)
+			ph = (ph << 1) | 1;
+			mh <<= 1;
+			pv = mh | ~(xv | ph);
+			mv = ph & xv;
+			// Оставшиеся символы могут уменьшить расстояние не более чем на 1 каждый
+			const std::size_t remaining = text.size() - j - 1;
+			if (score > maxDistance + remaining)
+				return maxDistance + 1;
+		}
+		return std::min(score, maxDistance + 1);
+	}
+
+	std::size_t EditDistancePattern::DistanceDynamic(std::string_view text, std::size_t maxDistance) const
+	{
+		std::vector<std::size_t> row(text.size() + 1);
+		std::iota(row.begin(), row.end(), std::size_t{ 0 });
+		for (std::size_t i = 1; i <= _pattern.size(); ++i) {
+			std::size_t diagonal = row[0];
+			row[0] = i;
+			std::size_t rowMinimum = row[0];
+			for (std::size_t j = 1; j <= text.size(); ++j) {
+				const std::size_t above = row[j];
+				const std::size_t substitution = diagonal + (_pattern[i - 1] == text[j - 1] ? 0 : 1);
+				row[j] = std::min({ above + 1, row[j - 1] + 1, substitution });
+				diagonal = above;
+				rowMinimum = std::min(rowMinimum, row[j]);
+			}
+			if (rowMinimum > maxDistance)
+				return maxDistance + 1;
+		}
+		return std::min(row[text.size()], maxDistance + 1);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace args_parse {
+	/// @brief Образец для вычисления расстояния Левенштейна бит-параллельным алгоритмом Майерса
+	/// (в варианте Хюрё для глобального расстояния).
+	/// Таблица масок строится один раз, после чего сравнение с каждой строкой выполняется
+	/// за O(длина строки) машинных операций. Образцы длиннее 64 символов обрабатываются
+	/// обычным динамическим программированием.
+	class EditDistancePattern {
+	public:
+		/// Максимальная длина образца для бит-параллельного алгоритма
+		static constexpr std::size_t MaxBitParallelLength = 64;
+
+		explicit EditDistancePattern(std::string_view pattern);
+
+		/// @brief Расстояние Левенштейна до text.
+		/// Если оно больше maxDistance, возвращается maxDistance + 1 (вычисление прерывается досрочно).
+		[[nodiscard]] std::size_t Distance(std::string_view text, std::size_t maxDistance) const;
+
+	private:
+		[[nodiscard]] std::size_t DistanceDynamic(std::string_view text, std::size_t maxDistance) const;
+
+		///Образец
+		std::string_view _pattern;
+		///Маски позиций каждого символа в образце
+		std::array<std::uint64_t, 256> _peq{};
+	};
+}
\ No newline at end of file
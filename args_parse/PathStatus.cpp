@@ -0,0 +1,169 @@
+#include "PathStatus.hpp"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace args_parse {
+	namespace {
+		/// @brief Получение типа и существования пути одним системным вызовом.
+		/// identity - устройство и inode; возвращает, удалось ли их получить
+		bool StatPath(const std::filesystem::path& path, PathStatus& status, std::pair<std::uint64_t, std::uint64_t>& identity) {
+#ifdef _WIN32
+			(void)identity;
+			const DWORD attributes = GetFileAttributesW(path.c_str());
+			if (attributes != INVALID_FILE_ATTRIBUTES) {
+				status.exists = true;
+				status.isDirectory = (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+			}
+			return false;
+#else
+			struct stat info {};
+			if (::stat(path.c_str(), &info) != 0)
+				return false;
+			status.exists = true;
+			status.isDirectory = S_ISDIR(info.st_mode);
+			identity = { static_cast<std::uint64_t>(info.st_dev), static_cast<std::uint64_t>(info.st_ino) };
+			return true;
+#endif
+		}
+
+		/// @brief Проверка прав доступа одним системным вызовом
+		bool CheckAccess(const std::filesystem::path& path, bool isDirectory, bool write) {
+#ifdef _WIN32
+			(void)isDirectory;
+			if (!write)
+				return true;
+			const DWORD attributes = GetFileAttributesW(path.c_str());
+			//для директорий атрибут "только чтение" не запрещает создание файлов
+			return attributes != INVALID_FILE_ATTRIBUTES
+				&& ((attributes & FILE_ATTRIBUTE_DIRECTORY) != 0 || (attributes & FILE_ATTRIBUTE_READONLY) == 0);
+#else
+			int mode = write ? W_OK : R_OK;
+			//содержимое директории можно прочитать только при праве на обход
+			if (!write && isDirectory)
+				mode |= X_OK;
+			return ::access(path.c_str(), mode) == 0;
+#endif
+		}
+	}
+
+	PathStatus PathStatusCache::Query(std::string_view path, PathPolicy policy)
+	{
+		const bool needRead = HasPolicy(policy, PathPolicy::Readable);
+		const bool needWrite = HasPolicy(policy, PathPolicy::Writable);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto [it, inserted] = _paths.try_emplace(std::string(path));
+		const std::filesystem::path fsPath(path);
+		if (inserted) {
+			PathStatus status;
+			Identity identity{};
+			const bool identified = StatPath(fsPath, status, identity);
+			_systemCalls.fetch_add(1, std::memory_order_relaxed);
+			// Файл уже проверен по другому пути: права берутся из его записи
+			std::shared_ptr<Entry>& file = identified ? _files[identity] : it->second;
+			if (!file) {
+				file = std::make_shared<Entry>();
+				file->status = status;
+				file->identified = identified;
+				file->identity = identity;
+			}
+			it->second = file;
+		}
+		Entry& entry = *it->second;
+		// Права несуществующего пути не проверяются
+		if (entry.status.exists) {
+			if (needRead && !entry.readableKnown) {
+				entry.status.readable = CheckAccess(fsPath, entry.status.isDirectory, false);
+				entry.readableKnown = true;
+				_systemCalls.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (needWrite && !entry.writableKnown) {
+				entry.status.writable = CheckAccess(fsPath, entry.status.isDirectory, true);
+				entry.writableKnown = true;
+				_systemCalls.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		return entry.status;
+	}
+
+	void PathStatusCache::Invalidate(std::string_view path)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		const auto it = _paths.find(std::string(path));
+		if (it == _paths.end())
+			return;
+		// Сбрасывается и запись файла, и все пути, которые ее разделяют
+		const std::shared_ptr<Entry> entry = it->second;
+		if (entry->identified)
+			_files.erase(entry->identity);
+		for (auto other = _paths.begin(); other != _paths.end();) {
+			if (other->second == entry)
+				other = _paths.erase(other);
+			else
+				++other;
+		}
+	}
+
+	void PathStatusCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_paths.clear();
+		_files.clear();
+	}
+
+	bool ValidatePath(std::string_view path, PathPolicy policy, PathStatusCache& cache)
+	{
+		//строка может быть пустой
+		if (path.empty())
+			return false;
+		if (policy == PathPolicy::None)
+			return true;
+
+		const bool mustBeDirectory = HasPolicy(policy, PathPolicy::MustBeDirectory);
+		PathStatus status = cache.Query(path, policy);
+		if (!status.exists && HasPolicy(policy, PathPolicy::CreateIfMissing)) {
+			std::error_code error;
+			const std::filesystem::path fsPath(path);
+			if (mustBeDirectory) {
+				std::filesystem::create_directories(fsPath, error);
+			}
+			else {
+				std::ofstream created(fsPath, std::ios::app);
+			}
+			cache.Invalidate(path);
+			status = cache.Query(path, policy);
+		}
+
+		if (!status.exists) {
+			if (HasPolicy(policy, PathPolicy::MustExist) || mustBeDirectory || HasPolicy(policy, PathPolicy::Readable))
+				return false;
+			// Путь еще не создан: писать можно, если можно писать в родительскую директорию
+			if (HasPolicy(policy, PathPolicy::Writable)) {
+				std::filesystem::path parent = std::filesystem::path(path).parent_path();
+				if (parent.empty())
+					parent = ".";
+				const PathStatus parentStatus = cache.Query(parent.string(), PathPolicy::Writable);
+				return parentStatus.isDirectory && parentStatus.writable;
+			}
+			return true;
+		}
+		if (mustBeDirectory && !status.isDirectory)
+			return false;
+		if (HasPolicy(policy, PathPolicy::Readable) && !status.readable)
+			return false;
+		if (HasPolicy(policy, PathPolicy::Writable) && !status.writable)
+			return false;
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace args_parse {
+	/// @brief Требования к пути, проверяемые Validator<std::string>.
+	/// Флаги объединяются через '|'.
+	enum class PathPolicy : unsigned {
+		/// Любая непустая строка
+		None = 0,
+		/// Путь должен существовать
+		MustExist = 1u << 0,
+		/// Путь должен быть директорией
+		MustBeDirectory = 1u << 1,
+		/// Путь должен быть доступен для чтения (для директории - и для обхода)
+		Readable = 1u << 2,
+		/// Путь должен быть доступен для записи; для несуществующего пути проверяется родительская директория
+		Writable = 1u << 3,
+		/// Несуществующий путь создается: директория при MustBeDirectory, иначе пустой файл
+		CreateIfMissing = 1u << 4,
+	};
+
+	[[nodiscard]] constexpr PathPolicy operator|(PathPolicy lhs, PathPolicy rhs) {
+		return static_cast<PathPolicy>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+	}
+
+	[[nodiscard]] constexpr PathPolicy operator&(PathPolicy lhs, PathPolicy rhs) {
+		return static_cast<PathPolicy>(static_cast<unsigned>(lhs) & static_cast<unsigned>(rhs));
+	}
+
+	/// @brief Проверка наличия флага в наборе
+	[[nodiscard]] constexpr bool HasPolicy(PathPolicy policy, PathPolicy flag) {
+		return (policy & flag) == flag;
+	}
+
+	/// Политика по умолчанию: существующая директория, доступная для чтения
+	constexpr PathPolicy DefaultPathPolicy = PathPolicy::MustExist | PathPolicy::MustBeDirectory | PathPolicy::Readable;
+
+	/// @brief Состояние пути в файловой системе
+	struct PathStatus {
+		bool exists = false;
+		bool isDirectory = false;
+		bool readable = false;
+		bool writable = false;
+	};
+
+	/// @brief Кэш состояний путей.
+	/// Путь проверяется одним stat (GetFileAttributesW в Windows) ровно в том виде, в котором передан:
+	/// ядро само разрешает ".." после символических ссылок, поэтому ответ относится к тому же файлу,
+	/// который программа потом откроет. Права - один access на каждый запрошенный вид доступа.
+	/// Повтор того же пути не обращается к файловой системе; другая запись пути к уже проверенному файлу
+	/// (то же устройство и inode) стоит одного stat, права берутся из записи файла.
+	/// Записи сами не устаревают: кэш очищает его владелец (Clear, Invalidate). ArgsParser держит свой кэш
+	/// и очищает его в начале каждого Parse(), поэтому разборы в разных потоках не мешают друг другу.
+	class PathStatusCache {
+	public:
+		/// @brief Получение состояния пути.
+		/// Права доступа проверяются только если запрошены политикой.
+		[[nodiscard]] PathStatus Query(std::string_view path, PathPolicy policy);
+
+		/// @brief Сброс записи о пути (например, после его создания)
+		void Invalidate(std::string_view path);
+
+		/// @brief Сброс всего кэша
+		void Clear();
+
+		/// @brief Количество системных вызовов, выполненных кэшем
+		[[nodiscard]] std::size_t SystemCalls() const { return _systemCalls.load(std::memory_order_relaxed); }
+
+	private:
+		/// Устройство и inode существующего файла
+		using Identity = std::pair<std::uint64_t, std::uint64_t>;
+
+		/// @brief Запись кэша: состояние и то, какие права уже проверены
+		struct Entry {
+			PathStatus status;
+			bool readableKnown = false;
+			bool writableKnown = false;
+			/// Есть ли у записи идентичность (путь существует; в Windows не определяется)
+			bool identified = false;
+			Identity identity{};
+		};
+
+		///Мьютекс для записей
+		std::mutex _mutex;
+		///Записи по пути в переданном виде; разные пути к одному файлу разделяют запись
+		std::unordered_map<std::string, std::shared_ptr<Entry>> _paths;
+		///Записи существующих файлов по идентичности
+		std::map<Identity, std::shared_ptr<Entry>> _files;
+		///Счетчик системных вызовов
+		std::atomic<std::size_t> _systemCalls{ 0 };
+	};
+
+	/// @brief Проверка пути по политике с использованием кэша
+	[[nodiscard]] bool ValidatePath(std::string_view path, PathPolicy policy, PathStatusCache& cache);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "ResponseFile.hpp"
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace args_parse {
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw std::invalid_argument("Cannot open response file: " + path.string());
+		}
+		BY_HANDLE_FILE_INFORMATION info{};
+		if (!GetFileInformationByHandle(file, &info)) {
+			CloseHandle(file);
+			throw std::invalid_argument("Cannot read response file: " + path.string());
+		}
+		_id.device = info.dwVolumeSerialNumber;
+		_id.index = (static_cast<std::uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+		_size = static_cast<std::size_t>((static_cast<std::uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow);
+		//пустой файл нельзя отобразить, но он допустим
+		if (_size != 0) {
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if (mapping != nullptr) {
+				_data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+		if (_size != 0 && _data == nullptr) {
+			throw std::invalid_argument("Cannot map response file: " + path.string());
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (_data != nullptr)
+			UnmapViewOfFile(_data);
+	}
+#else
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw std::invalid_argument("Cannot open response file: " + path.string());
+		}
+		struct stat info {};
+		if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+			::close(fd);
+			throw std::invalid_argument("Cannot read response file: " + path.string());
+		}
+		_id.device = static_cast<std::uint64_t>(info.st_dev);
+		_id.index = static_cast<std::uint64_t>(info.st_ino);
+		_size = static_cast<std::size_t>(info.st_size);
+		//пустой файл нельзя отобразить, но он допустим
+		if (_size != 0) {
+			void* data = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+				_data = static_cast<char*>(data);
+		}
+		::close(fd);
+		if (_size != 0 && _data == nullptr) {
+			throw std::invalid_argument("Cannot map response file: " + path.string());
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (_data != nullptr)
+			::munmap(_data, _size);
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace args_parse {
+	/// @brief Идентификатор файла в файловой системе (устройство/том и номер файла).
+	/// Используется для обнаружения циклов во вложенных файлах ответов.
+	struct FileId {
+		std::uint64_t device = 0;
+		std::uint64_t index = 0;
+
+		[[nodiscard]] bool operator==(const FileId& other) const { return device == other.device && index == other.index; }
+		[[nodiscard]] bool operator!=(const FileId& other) const { return !(*this == other); }
+	};
+
+	/// @brief Файл, отображенный в память с копированием при записи.
+	/// Изменения страниц видны только процессу и не попадают в файл,
+	/// что позволяет разбирать кавычки и экранирование прямо в отображении.
+	class MappedFile {
+	public:
+		/// @brief Отображение файла в память.
+		/// Бросает std::invalid_argument, если файл нельзя открыть или отобразить.
+		explicit MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// @brief Начало отображенных данных (nullptr для пустого файла)
+		[[nodiscard]] char* Data() const { return _data; }
+
+		/// @brief Размер файла в байтах
+		[[nodiscard]] std::size_t Size() const { return _size; }
+
+		/// @brief Идентификатор файла
+		[[nodiscard]] const FileId& Id() const { return _id; }
+
+	private:
+		///Отображенные данные
+		char* _data = nullptr;
+		///Размер файла
+		std::size_t _size = 0;
+		///Идентификатор файла
+		FileId _id;
+	};
+
+	/// @brief Разбиение содержимого файла ответов на аргументы без копирования.
+	/// Аргументы разделяются пробельными символами; '#' в начале аргумента начинает комментарий до конца строки;
+	/// одинарные кавычки сохраняют содержимое как есть, в двойных кавычках и вне кавычек
+	/// '\\' экранирует следующий символ. Снятие кавычек выполняется на месте, поэтому буфер должен быть изменяемым.
+	/// Для каждого аргумента вызывается consume(std::string_view), представление указывает внутрь буфера.
+	template<typename Consumer>
+	void TokenizeResponseBuffer(char* data, std::size_t size, Consumer&& consume) {
+		const auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; };
+		char* read = data;
+		char* const end = data + size;
+		while (read != end) {
+			if (isSpace(*read)) {
+				++read;
+				continue;
+			}
+			//комментарий до конца строки
+			if (*read == '#') {
+				while (read != end && *read != '\n')
+					++read;
+				continue;
+			}
+			char* const tokenBegin = read;
+			char* write = read;
+			char quote = '\0';
+			for (; read != end; ++read) {
+				const char c = *read;
+				if (quote == '\0' && isSpace(c))
+					break;
+				if (quote == '\0' && (c == '"' || c == '\'')) {
+					quote = c;
+				}
+				else if (quote != '\0' && c == quote) {
+					quote = '\0';
+				}
+				else if (c == '\\' && quote != '\'' && read + 1 != end) {
+					*write++ = *++read;
+				}
+				else {
+					*write++ = c;
+				}
+			}
+			consume(std::string_view(tokenBegin, static_cast<std::size_t>(write - tokenBegin)));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+#pragma once
+#include "argument.hpp"
+#include "ArgsParser.hpp"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace args_parse {
+	/// Значение короткого имени для аргументов без него
+	constexpr char NoShortName = '\0';
+
+	/// @brief Описание аргумента схемы, известной на этапе компиляции.
+	/// Длинное имя передается указателем на constexpr-массив символов,
+	/// так как C++17 не допускает строковые литералы в параметрах шаблона:
+	/// @code
+	/// constexpr char ThreadPoolName[] = "thread-pool";
+	/// using ThreadPoolOpt = args_parse::Opt<'t', ThreadPoolName, unsigned int>;
+	/// using SourceOpt = args_parse::Opt<'s', SourceName, std::string, args_parse::DefaultPathPolicy>;
+	/// @endcode
+	/// Строковое значение проверяется как путь только с явно заданной политикой Policy;
+	/// по умолчанию (PathPolicy::None) это любая непустая строка.
+	template<char ShortName, const char* LongName, typename T, PathPolicy Policy = PathPolicy::None>
+	struct Opt {
+		using ValueType = T;
+		static constexpr char shortName = ShortName;
+		static constexpr std::string_view longName{ LongName };
+		/// Флаги (bool) не принимают значение
+		static constexpr bool hasValue = !std::is_same_v<T, bool>;
+		/// Требования к пути для строкового значения
+		static constexpr PathPolicy pathPolicy = Policy;
+
+		static_assert(Policy == PathPolicy::None || std::is_same_v<T, std::string>, "Path policy applies to std::string options only");
+	};
+
+	/// @brief Номер типа O в списке Ts
+	template<typename O, typename... Ts>
+	[[nodiscard]] constexpr std::size_t IndexOfOpt() {
+		constexpr bool matches[] = { std::is_same_v<O, Ts>... };
+		for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+			if (matches[i])
+				return i;
+		return sizeof...(Ts);
+	}
+
+	/// @brief Результат разбора по схеме.
+	/// Для каждого аргумента хранится std::optional, пустой, если аргумент не был указан.
+	template<typename... Opts>
+	struct SchemaValues {
+		std::tuple<std::optional<typename Opts::ValueType>...> values;
+
+		/// @brief Получение значения по описанию аргумента
+		template<typename O>
+		[[nodiscard]] const auto& Get() const { return std::get<IndexOfOpt<O, Opts...>()>(values); }
+
+		/// @brief Получение значения по номеру аргумента в схеме
+		template<std::size_t I>
+		[[nodiscard]] const auto& Get() const { return std::get<I>(values); }
+	};
+
+	/// @brief Схема аргументов, известная на этапе компиляции.
+	/// Таблицы имен строятся constexpr, повторы имен отклоняются static_assert,
+	/// а обработка значения выбирается по номеру аргумента без виртуальных вызовов.
+	/// Длинное имя может быть префиксом другого ("stats" и "stats-json"): как и в ArgsParser,
+	/// точное совпадение имеет приоритет, а неоднозначное сокращение отклоняется при разборе.
+	/// Существует параллельно с ArgsParser и использует тот же разбор строки и те же Validator<T>.
+	template<typename... Opts>
+	class Schema {
+	public:
+		using Result = SchemaValues<Opts...>;
+
+		/// Количество аргументов в схеме
+		static constexpr std::size_t Size = sizeof...(Opts);
+		/// Результат поиска, если аргумент не найден
+		static constexpr std::size_t NotFound = Size;
+		/// Результат поиска, если префикс подходит нескольким аргументам
+		static constexpr std::size_t Ambiguous = Size + 1;
+
+		static constexpr std::array<std::string_view, Size> LongNames{ Opts::longName... };
+		static constexpr std::array<char, Size> ShortNames{ Opts::shortName... };
+
+	private:
+		[[nodiscard]] static constexpr bool IsPrefix(std::string_view prefix, std::string_view name) {
+			return prefix.size() <= name.size() && name.substr(0, prefix.size()) == prefix;
+		}
+
+		[[nodiscard]] static constexpr bool HasShortLongNames() {
+			for (std::size_t i = 0; i < Size; ++i)
+				if (LongNames[i].size() <= 1)
+					return true;
+			return false;
+		}
+
+		[[nodiscard]] static constexpr bool HasDuplicateShortNames() {
+			for (std::size_t i = 0; i < Size; ++i)
+				for (std::size_t j = i + 1; j < Size; ++j)
+					if (ShortNames[i] != NoShortName && ShortNames[i] == ShortNames[j])
+						return true;
+			return false;
+		}
+
+		[[nodiscard]] static constexpr bool HasDuplicateLongNames() {
+			for (std::size_t i = 0; i < Size; ++i)
+				for (std::size_t j = i + 1; j < Size; ++j)
+					if (LongNames[i] == LongNames[j])
+						return true;
+			return false;
+		}
+
+		static_assert(Size > 0, "Schema must contain at least one option");
+		static_assert(!HasShortLongNames(), "Long option names must be longer than one character");
+		static_assert(!HasDuplicateShortNames(), "Duplicate short option name in schema");
+		static_assert(!HasDuplicateLongNames(), "Duplicate long option name in schema");
+
+		/// @brief Прямая таблица коротких имен
+		[[nodiscard]] static constexpr std::array<std::size_t, 256> MakeShortTable() {
+			std::array<std::size_t, 256> table{};
+			for (auto& entry : table)
+				entry = NotFound;
+			for (std::size_t i = 0; i < Size; ++i)
+				if (ShortNames[i] != NoShortName)
+					table[static_cast<unsigned char>(ShortNames[i])] = i;
+			return table;
+		}
+
+		/// @brief Номера аргументов, отсортированные по длинному имени
+		[[nodiscard]] static constexpr std::array<std::size_t, Size> MakeSortedLong() {
+			std::array<std::size_t, Size> order{};
+			for (std::size_t i = 0; i < Size; ++i)
+				order[i] = i;
+			for (std::size_t i = 1; i < Size; ++i) {
+				const std::size_t current = order[i];
+				std::size_t j = i;
+				for (; j > 0 && LongNames[current] < LongNames[order[j - 1]]; --j)
+					order[j] = order[j - 1];
+				order[j] = current;
+			}
+			return order;
+		}
+
+		static constexpr std::array<std::size_t, 256> ShortTable = MakeShortTable();
+		static constexpr std::array<std::size_t, Size> SortedLong = MakeSortedLong();
+
+	public:
+		/// @brief Поиск аргумента по короткому имени
+		[[nodiscard]] static constexpr std::size_t FindShort(char name) {
+			return ShortTable[static_cast<unsigned char>(name)];
+		}
+
+		/// @brief Поиск аргумента по длинному имени или его уникальному префиксу.
+		/// Точное совпадение имеет приоритет над именами, которые оно продолжает
+		[[nodiscard]] static constexpr std::size_t FindLong(std::string_view name) {
+			if (name.size() <= 1)
+				return NotFound;
+			// Первый элемент, не меньший префикса
+			std::size_t low = 0;
+			std::size_t high = Size;
+			while (low < high) {
+				const std::size_t middle = low + (high - low) / 2;
+				if (LongNames[SortedLong[middle]] < name)
+					low = middle + 1;
+				else
+					high = middle;
+			}
+			if (low == Size || !IsPrefix(name, LongNames[SortedLong[low]]))
+				return NotFound;
+			//точное совпадение имеет приоритет над префиксом
+			if (LongNames[SortedLong[low]].size() == name.size())
+				return SortedLong[low];
+			if (low + 1 < Size && IsPrefix(name, LongNames[SortedLong[low + 1]]))
+				return Ambiguous;
+			return SortedLong[low];
+		}
+
+		/// @brief Разбор аргументов командной строки по схеме.
+		/// Ошибки формата, неизвестные аргументы и неверные значения приводят к std::invalid_argument.
+		/// Состояния путей кэшируются только на время одного разбора.
+		[[nodiscard]] static Result Parse(int argc, const char** argv) {
+			Result result;
+			PathStatusCache cache;
+			for (int i = 1; i < argc; ++i) {
+				BaseParametrs parametrs{ argv[i], {}, {} };
+				std::size_t index = NotFound;
+				//обработка длинного аргумента
+				if (parametrs.argStr.substr(0, 2) == "--") {
+					parametrs = ArgsParser::ParseLongArgument(parametrs);
+					index = FindLong(parametrs.argName);
+				}
+				//обработка короткого аргумента
+				else if (!parametrs.argStr.empty() && parametrs.argStr[0] == '-') {
+					parametrs = ArgsParser::ParseShortArgument(parametrs);
+					if (!parametrs.argName.empty())
+						index = FindShort(parametrs.argName[0]);
+				}
+				else {
+					throw std::invalid_argument("Invalid argument format: " + std::string(parametrs.argStr));
+				}
+
+				if (index == NotFound) {
+					throw std::invalid_argument("Unknown argument: " + std::string(parametrs.argStr));
+				}
+				if (index == Ambiguous) {
+					throw std::invalid_argument("Prefix is not unique: " + std::string(parametrs.argStr));
+				}
+				Dispatch(index, parametrs, result, cache, std::index_sequence_for<Opts...>{});
+			}
+			return result;
+		}
+
+	private:
+		/// @brief Выбор обработчика по номеру аргумента
+		template<std::size_t... I>
+		static void Dispatch(std::size_t index, const BaseParametrs& parametrs, Result& result, PathStatusCache& cache, std::index_sequence<I...>) {
+			((index == I ? Assign<I>(parametrs, result, cache) : void()), ...);
+		}
+
+		/// @brief Валидатор значения аргумента: строки проверяются по политике аргумента
+		template<typename Option>
+		[[nodiscard]] static Validator<typename Option::ValueType> MakeValidator(PathStatusCache& cache) {
+			if constexpr (std::is_same_v<typename Option::ValueType, std::string>)
+				return Validator<std::string>(Option::pathPolicy, &cache);
+			else {
+				(void)cache;
+				return Validator<typename Option::ValueType>{};
+			}
+		}
+
+		/// @brief Проверка и сохранение значения аргумента с номером I
+		template<std::size_t I>
+		static void Assign(const BaseParametrs& parametrs, Result& result, PathStatusCache& cache) {
+			using Option = std::tuple_element_t<I, std::tuple<Opts...>>;
+			using ValueType = typename Option::ValueType;
+			if constexpr (!Option::hasValue) {
+				std::get<I>(result.values) = true;
+			}
+			else {
+				if (parametrs.argValue.empty()) {
+					throw std::invalid_argument("Missing value for argument: " + std::string(parametrs.argName));
+				}
+				auto [isValid, value] = MakeValidator<Option>(cache).ValidValue(parametrs.argValue);
+				if (!isValid) {
+					throw std::invalid_argument("Invalid value for argument: " + std::string(parametrs.argStr));
+				}
+				std::get<I>(result.values) = std::move(value);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -1,87 +1,226 @@
 #pragma once
+#include "PathStatus.hpp"
 #include <string>
 #include <chrono>
 #include <iostream>
 #include <sstream>
 #include <optional>
 #include <filesystem>
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
 
 namespace args_parse {
 #pragma region Validation
 
+	/// @brief Разбор значения через поток ввода.
+	/// Универсальный путь для пользовательских типов, для которых определен operator>>.
+	template<typename T>
+	[[nodiscard]] std::tuple<bool, T> StreamValue(std::string_view value) {
+		//строка может быть пустой
+		if (value.empty()) {
+			return std::make_tuple(false, T{});
+		}
+		std::istringstream iss{ std::string(value) };
+		T temp{};
+		if (iss >> temp) {
+			return std::make_tuple(true, temp);
+		}
+		return std::make_tuple(false, temp);
+	}
+
+	/// @brief Числовой тип, который разбирается через std::from_chars: целые типы, кроме bool и символьных,
+	/// и типы с плавающей точкой. Символьные типы читаются потоком как один символ
+	template<typename T>
+	inline constexpr bool IsFromCharsNumber = std::is_floating_point_v<T>
+		|| (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, wchar_t>
+#ifdef __cpp_char8_t
+			&& !std::is_same_v<T, char8_t>
+#endif
+			&& !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>);
+
+	/// @brief Разбор числового значения через std::from_chars.
+	/// Значение должно занимать всю строку целиком, переполнение считается ошибкой.
+	template<typename T>
+	[[nodiscard]] std::tuple<bool, T> FromCharsValue(std::string_view value) {
+		static_assert(IsFromCharsNumber<T>, "FromCharsValue requires a numeric type");
+		T temp{};
+		const char* first = value.data();
+		const char* last = value.data() + value.size();
+		//from_chars не принимает знак '+', пропускаем его сами
+		if (first != last && *first == '+' && last - first > 1 && first[1] != '-')
+			++first;
+		auto [ptr, ec] = std::from_chars(first, last, temp);
+		//строка может быть пустой, содержать мусор в конце или не помещаться в тип
+		if (first == last || ec != std::errc{} || ptr != last) {
+			return std::make_tuple(false, T{});
+		}
+		return std::make_tuple(true, temp);
+	}
+
 	template<typename T>
 	class Validator {
 	public:
 		Validator() = default;
 
 		[[nodiscard]] std::tuple<bool, T> ValidValue(std::string_view value) const {
-			std::string str = std::string(value);
-			//строка может быть пустой
-			if (str.empty()) {
-				return std::make_tuple(false, T{});
+			//для чисел используется быстрый путь без выделения памяти
+			if constexpr (IsFromCharsNumber<T>) {
+				return FromCharsValue<T>(value);
 			}
-			std::istringstream iss(str);
-			T temp;
-			if (iss >> temp) {
-				return std::make_tuple(true, temp);
+			else {
+				return StreamValue<T>(value);
 			}
-			return std::make_tuple(false, temp);
 		}
 	};
 
+	/// @brief Ошибки разбора длительности
+	enum class DurationError {
+		None,
+		/// Пустая строка
+		Empty,
+		/// Ожидалось число
+		InvalidNumber,
+		/// Неизвестная или отсутствующая единица измерения
+		InvalidUnit,
+		/// Значение не помещается в std::chrono::nanoseconds
+		Overflow
+	};
+
+	/// @brief Однопроходный разбор длительности без выделения памяти.
+	/// Поддерживает единицы ns/us/ms/s/m/h, составную запись ("1m30s") и дробные значения ("1.5s").
+	/// Пробелы между частями допускаются, отрицательные значения - нет.
+	[[nodiscard]] constexpr std::tuple<DurationError, std::chrono::nanoseconds> ParseDuration(std::string_view value) noexcept {
+		using Rep = unsigned long long;
+		constexpr Rep MaxNs = static_cast<Rep>(std::chrono::nanoseconds::max().count());
+		constexpr auto Fail = [](DurationError error) {
+			return std::make_tuple(error, std::chrono::nanoseconds::zero());
+		};
+		constexpr auto IsDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+		Rep total = 0;
+		std::size_t pos = 0;
+		bool hasComponent = false;
+		while (true) {
+			while (pos < value.size() && value[pos] == ' ')
+				++pos;
+			if (pos == value.size())
+				break;
+
+			// Целая часть числа
+			if (!IsDigit(value[pos]) && value[pos] != '.')
+				return Fail(DurationError::InvalidNumber);
+			Rep whole = 0;
+			bool wholeOverflow = false;
+			std::size_t digits = 0;
+			for (; pos < value.size() && IsDigit(value[pos]); ++pos, ++digits) {
+				const Rep digit = static_cast<Rep>(value[pos] - '0');
+				if (whole > (MaxNs - digit) / 10)
+					wholeOverflow = true;
+				else
+					whole = whole * 10 + digit;
+			}
+			// Дробная часть запоминается и применяется после чтения единицы измерения
+			std::size_t fractionBegin = pos;
+			std::size_t fractionEnd = pos;
+			if (pos < value.size() && value[pos] == '.') {
+				fractionBegin = ++pos;
+				while (pos < value.size() && IsDigit(value[pos]))
+					++pos;
+				fractionEnd = pos;
+			}
+			if (digits == 0 && fractionBegin == fractionEnd)
+				return Fail(DurationError::InvalidNumber);
+
+			while (pos < value.size() && value[pos] == ' ')
+				++pos;
+			// Единица измерения
+			Rep unitNs = 0;
+			const std::string_view rest = value.substr(pos);
+			if (rest.substr(0, 2) == "ns") { unitNs = 1; pos += 2; }
+			else if (rest.substr(0, 2) == "us") { unitNs = 1000; pos += 2; }
+			else if (rest.substr(0, 2) == "ms") { unitNs = 1000000; pos += 2; }
+			else if (rest.substr(0, 1) == "s") { unitNs = 1000000000; pos += 1; }
+			else if (rest.substr(0, 1) == "m") { unitNs = 60ull * 1000000000; pos += 1; }
+			else if (rest.substr(0, 1) == "h") { unitNs = 3600ull * 1000000000; pos += 1; }
+			else
+				return Fail(DurationError::InvalidUnit);
+			//единица не может продолжаться буквами ("sec", "min")
+			if (pos < value.size() && ((value[pos] >= 'a' && value[pos] <= 'z') || (value[pos] >= 'A' && value[pos] <= 'Z')))
+				return Fail(DurationError::InvalidUnit);
+
+			if (wholeOverflow || (whole != 0 && whole > MaxNs / unitNs))
+				return Fail(DurationError::Overflow);
+			Rep component = whole * unitNs;
+			// Дробная часть: единицы измерения кратны степеням 10, поэтому деление точное,
+			// разряды меньше наносекунды отбрасываются
+			Rep scale = unitNs;
+			for (std::size_t i = fractionBegin; i < fractionEnd && scale >= 10; ++i) {
+				scale /= 10;
+				component += static_cast<Rep>(value[i] - '0') * scale;
+			}
+			if (component > MaxNs - total)
+				return Fail(DurationError::Overflow);
+			total += component;
+			hasComponent = true;
+		}
+		if (!hasComponent)
+			return Fail(DurationError::Empty);
+		return std::make_tuple(DurationError::None, std::chrono::nanoseconds(static_cast<long long>(total)));
+	}
+
 	template<>
 	class Validator<std::chrono::milliseconds> {
 	public:
 		Validator<std::chrono::milliseconds>() = default;
 
-		[[nodiscard]] std::tuple<bool, std::chrono::milliseconds> ValidValue(std::string_view  value) const {
-			long long l_value;
-			//единица измерения
-			std::string unit;
-			std::string temp = std::string(value);
-			std::istringstream ss{ temp };
-			// Считываем значение и единицу измерения времени из потока
-			ss >> l_value >> unit;
-
-			std::chrono::milliseconds ms = std::chrono::milliseconds::zero();
+		/// @brief Разбор длительности с указанием причины ошибки
+		[[nodiscard]] std::tuple<DurationError, std::chrono::milliseconds> Parse(std::string_view value) const noexcept {
+			const auto [error, ns] = ParseDuration(value);
+			return std::make_tuple(error, std::chrono::duration_cast<std::chrono::milliseconds>(ns));
+		}
 
-			// Преобразуем значение и единицу измерения времени в микросекунды
-			if (unit == "ms") {
-				ms = std::chrono::milliseconds(l_value);
-			}
-			else if (unit == "s") {
-				ms = std::chrono::seconds(l_value);
-			}
-			else {
-				std::cerr << "Invalid time unit: " << unit << std::endl;
-				return std::make_tuple(false, ms);
-			}
-			return std::make_tuple(true, ms);
+		[[nodiscard]] std::tuple<bool, std::chrono::milliseconds> ValidValue(std::string_view value) const noexcept {
+			const auto [error, ms] = Parse(value);
+			return std::make_tuple(error == DurationError::None, ms);
 		}
 	};
 
 	template<>
 	class Validator<std::string> {
 	public:
-		Validator<std::string>() = default;
-
+		/// @brief Конструктор класса.
+		/// По умолчанию путь должен быть существующей директорией, доступной для чтения;
+		/// PathPolicy::None превращает валидатор в проверку непустой строки.
+		/// Без явного кэша используется кэш разбора, который ArgsParser очищает в начале каждого Parse();
+		/// явный кэш не очищается парсером и отвечает состоянием путей на момент первого запроса.
+		explicit Validator<std::string>(PathPolicy policy = DefaultPathPolicy, PathStatusCache* cache = nullptr) :
+			_policy(policy), _cache(cache) {}
+
+		/// @brief Проверка вне разбора: без явного кэша путь проверяется заново
 		[[nodiscard]] std::tuple<bool, std::string> ValidValue(std::string_view value) const {
-			std::filesystem::path dirPath = std::string(value);
+			PathStatusCache local;
+			return ValidValue(value, local);
+		}
 
-			// Проверяем, существует ли каталог
-			if (!std::filesystem::exists(dirPath))
+		/// @brief Проверка в разборе: parseCache - кэш парсера, явный кэш валидатора важнее
+		[[nodiscard]] std::tuple<bool, std::string> ValidValue(std::string_view value, PathStatusCache& parseCache) const {
+			PathStatusCache& cache = _cache != nullptr ? *_cache : parseCache;
+			if (!ValidatePath(value, _policy, cache))
 				return std::make_tuple(false, std::string{});
+			return std::make_tuple(true, std::string(value));
+		}
 
-			// Проверяем, является ли путь директорией
-			if (!std::filesystem::is_directory(dirPath))
-				return std::make_tuple(false, std::string{});
+		/// @brief Получение политики проверки пути
+		[[nodiscard]] PathPolicy GetPolicy() const { return _policy; }
 
-			// Проверяем, доступен ли каталог для чтения
-			if (std::filesystem::directory_iterator(dirPath) == std::filesystem::directory_iterator())
-				return std::make_tuple(false, std::string{});
-
-			return std::make_tuple(true, dirPath.string());
-		}
+	private:
+		///Требования к пути
+		PathPolicy _policy;
+		///Кэш состояний путей
+		PathStatusCache* _cache;
 	};
 
 #pragma endregion
@@ -103,7 +242,7 @@ namespace args_parse {
 		[[nodiscard]] bool HasValue() const { return _isValue; }
 
 		/// @brief Получение длинного имени
-		[[nodiscard]] std::string GetLongName() const { return _longName; }
+		[[nodiscard]] const std::string& GetLongName() const { return _longName; }
 
 		/// @brief Установка длинного имени
 		void SetLongName(const char* longName) { _longName = longName; }
@@ -115,7 +254,7 @@ namespace args_parse {
 		void SetShortName(const char shortName) { _shortName = shortName; }
 
 		/// @brief Получение описания аргумента
-		[[nodiscard]] std::string GetDescription() const { return _description; }
+		[[nodiscard]] const std::string& GetDescription() const { return _description; }
 
 		/// @brief Установка описания аргумента
 		void SetDescription(const std::string& description) { _description = description; }
@@ -129,8 +268,9 @@ namespace args_parse {
 		/// @brief Проверка существования валидатора
 		[[nodiscard]] virtual bool IsValidatorExist() const = 0;
 
-		/// @brief Получение результата валидации и установка значения
-		[[nodiscard]] virtual bool ValidationAndSetValue(std::string_view value) = 0;
+		/// @brief Получение результата валидации и установка значения.
+		/// cache - кэш состояний путей текущего разбора (используется только аргументами-путями)
+		[[nodiscard]] virtual bool ValidationAndSetValue(std::string_view value, PathStatusCache& cache) = 0;
 
 	private:
 		///Короткое описание аргумента
@@ -174,8 +314,13 @@ namespace args_parse {
 		/// @brief Получение значения аргумента
 		[[nodiscard]] std::optional<T> GetValue() const { return _value; }
 
-		bool ValidationAndSetValue(std::string_view value)  override {
-			const std::tuple<bool, T> valid_tuple = _validator->ValidValue(value);
+		bool ValidationAndSetValue(std::string_view value, PathStatusCache& cache)  override {
+			const std::tuple<bool, T> valid_tuple = [&] {
+				if constexpr (std::is_same_v<T, std::string>)
+					return _validator->ValidValue(value, cache);
+				else
+					return _validator->ValidValue(value);
+			}();
 			if (std::get<0>(valid_tuple)) {
 				SetValue(std::get<1>(valid_tuple));
 				return true;
@@ -222,7 +367,7 @@ namespace args_parse {
 			return true;
 		}
 
-		bool ValidationAndSetValue(std::string_view value) override {
+		bool ValidationAndSetValue(std::string_view value, PathStatusCache&) override {
 			const std::tuple<bool, std::chrono::milliseconds> valid_tuple = _validator->ValidValue(value);
 			if (std::get<0>(valid_tuple)) {
 				SetValue(std::get<1>(valid_tuple));
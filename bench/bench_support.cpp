@@ -0,0 +1,27 @@
+#include "bench_support.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	std::atomic<std::size_t> g_allocations{ 0 };
+
+	void* CountedAllocate(std::size_t size) {
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		if (void* ptr = std::malloc(size == 0 ? 1 : size))
+			return ptr;
+		throw std::bad_alloc();
+	}
+}
+
+namespace bench {
+	std::size_t AllocationCount() { return g_allocations.load(std::memory_order_relaxed); }
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+
+namespace bench {
+	/// @brief Количество вызовов operator new с момента запуска программы.
+	/// Глобальный operator new подменен в bench_support.cpp.
+	[[nodiscard]] std::size_t AllocationCount();
+
+	/// @brief Буфер, отбрасывающий весь вывод
+	class NullBuffer : public std::streambuf {
+	protected:
+		int overflow(int c) override { return c; }
+		std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+	};
+
+	/// @brief Перенаправление std::cout в никуда на время жизни объекта,
+	/// чтобы замеры ShowHelp не мерили скорость терминала.
+	class SilenceCout {
+	public:
+		SilenceCout() : _previous(std::cout.rdbuf(&_null)) {}
+		~SilenceCout() { std::cout.rdbuf(_previous); }
+
+		SilenceCout(const SilenceCout&) = delete;
+		SilenceCout& operator=(const SilenceCout&) = delete;
+
+	private:
+		NullBuffer _null;
+		std::streambuf* _previous;
+	};
+}
\ No newline at end of file
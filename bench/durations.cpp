@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <args_parse/argument.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace {
+	/// @brief Прежняя реализация Validator<std::chrono::milliseconds> (istringstream + std::string),
+	/// сохранена только для сравнения. Сообщение в std::cerr опущено, чтобы не мерить вывод.
+	std::tuple<bool, std::chrono::milliseconds> LegacyDurationValue(std::string_view value) {
+		long long l_value;
+		std::string unit;
+		std::string temp = std::string(value);
+		std::istringstream ss{ temp };
+		ss >> l_value >> unit;
+		if (unit == "ms") {
+			return std::make_tuple(true, std::chrono::milliseconds(l_value));
+		}
+		else if (unit == "s") {
+			return std::make_tuple(true, std::chrono::milliseconds(std::chrono::seconds(l_value)));
+		}
+		return std::make_tuple(false, std::chrono::milliseconds::zero());
+	}
+
+	/// Значения, которые понимают обе реализации
+	constexpr std::string_view SimpleValues[] = { "0ms", "15ms", "250ms", "1s", "30s", "3600s" };
+	/// Значения, которые понимает только новый разбор
+	constexpr std::string_view CompoundValues[] = { "1m30s", "1.5s", "2h15m", "750us", "1h1m1.001s", "0.25m" };
+}
+
+TEST_CASE("Duration validator: scanner vs istringstream", "[validator][duration][bench]") {
+	const args_parse::Validator<std::chrono::milliseconds> validator;
+
+	BENCHMARK("duration scanner (simple)") {
+		long long sum = 0;
+		for (std::string_view value : SimpleValues)
+			sum += std::get<1>(validator.ValidValue(value)).count();
+		return sum;
+	};
+	BENCHMARK("duration istringstream (simple)") {
+		long long sum = 0;
+		for (std::string_view value : SimpleValues)
+			sum += std::get<1>(LegacyDurationValue(value)).count();
+		return sum;
+	};
+	BENCHMARK("duration scanner (compound)") {
+		long long sum = 0;
+		for (std::string_view value : CompoundValues)
+			sum += std::get<1>(validator.ValidValue(value)).count();
+		return sum;
+	};
+}
@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "bench_support.hpp"
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+#include <args_parse/EditDistance.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+	/// @brief Короткое имя i-го синтетического аргумента ('\0', если его нет)
+	[[nodiscard]] char ShortName(std::size_t i) {
+		if (i < 26) return static_cast<char>('a' + i);
+		if (i < 52) return static_cast<char>('A' + (i - 26));
+		return '\0';
+	}
+
+	/// @brief Синтетическая командная строка: набор аргументов и argv к нему.
+	/// Аргументы чередуют типы (флаг, int, unsigned int, float, длительность),
+	/// первые 52 аргумента получают короткие имена.
+	/// Значения передаются через '=', слитно с коротким именем ("-a42") и через "-a=42".
+	class SyntheticCli {
+	public:
+		SyntheticCli(std::size_t options, std::size_t tokens) {
+			_arguments.reserve(options);
+			for (std::size_t i = 0; i < options; ++i)
+				AddArgument(i);
+
+			_tokens.reserve(tokens);
+			for (std::size_t j = 0; j < tokens; ++j)
+				_tokens.push_back(MakeToken((j * 7919) % options, j));
+
+			_argv.push_back("bench");
+			for (const auto& token : _tokens)
+				_argv.push_back(token.c_str());
+
+			_parser = std::make_unique<args_parse::ArgsParser>(static_cast<int>(_argv.size()), _argv.data());
+			for (const auto& argument : _arguments)
+				_parser->Add(argument.get());
+			_parser->Freeze();
+		}
+
+		[[nodiscard]] args_parse::ArgsParser& Parser() { return *_parser; }
+
+		[[nodiscard]] std::size_t Tokens() const { return _tokens.size(); }
+
+		[[nodiscard]] const std::vector<std::string>& Names() const { return _names; }
+
+	private:
+		void AddArgument(std::size_t i) {
+			_names.push_back("option-" + std::to_string(i));
+			const char shortName = ShortName(i);
+			const char* name = _names.back().c_str();
+			switch (i % 5) {
+			case 0: _arguments.push_back(std::make_unique<args_parse::Argument<bool>>(shortName, name, false)); break;
+			case 1: _arguments.push_back(std::make_unique<args_parse::Argument<int>>(shortName, name, true, &_int)); break;
+			case 2: _arguments.push_back(std::make_unique<args_parse::Argument<unsigned int>>(shortName, name, true, &_unsigned)); break;
+			case 3: _arguments.push_back(std::make_unique<args_parse::Argument<float>>(shortName, name, true, &_float)); break;
+			default: _arguments.push_back(std::make_unique<args_parse::Argument<std::chrono::milliseconds>>(shortName, name, true, &_duration)); break;
+			}
+			_arguments.back()->SetDescription("Synthetic option number " + std::to_string(i));
+		}
+
+		[[nodiscard]] std::string MakeToken(std::size_t option, std::size_t j) const {
+			static const char* const Values[] = { "", "-123", "42", "0.5", "250ms" };
+			const std::string value = Values[option % 5];
+			const char shortName = ShortName(option);
+			if (value.empty())
+				return shortName != '\0' && j % 2 ? std::string("-") + shortName : "--" + _names[option];
+			if (shortName != '\0' && j % 3 == 1)
+				return std::string("-") + shortName + value;
+			if (shortName != '\0' && j % 3 == 2)
+				return std::string("-") + shortName + "=" + value;
+			return "--" + _names[option] + "=" + value;
+		}
+
+		args_parse::Validator<int> _int;
+		args_parse::Validator<unsigned int> _unsigned;
+		args_parse::Validator<float> _float;
+		args_parse::Validator<std::chrono::milliseconds> _duration;
+		std::vector<std::string> _names;
+		std::vector<std::unique_ptr<args_parse::ArgumentBase>> _arguments;
+		std::vector<std::string> _tokens;
+		std::vector<const char*> _argv;
+		std::unique_ptr<args_parse::ArgsParser> _parser;
+	};
+
+	constexpr std::size_t TokenCounts[] = { 10, 100, 1000, 10000 };
+	constexpr std::size_t OptionCounts[] = { 10, 100, 1000 };
+}
+
+TEST_CASE("Parse over synthetic argv", "[parser][bench]") {
+	for (std::size_t options : OptionCounts) {
+		for (std::size_t tokens : TokenCounts) {
+			SyntheticCli cli(options, tokens);
+			BENCHMARK("Parse " + std::to_string(tokens) + " tokens / " + std::to_string(options) + " options") {
+				return cli.Parser().Parse().Ok();
+			};
+		}
+	}
+}
+
+TEST_CASE("Parse cost per token and allocations per parse", "[parser][report]") {
+	using Clock = std::chrono::steady_clock;
+	std::printf("\n%10s %10s %12s %14s\n", "options", "tokens", "ns/token", "allocs/parse");
+	for (std::size_t options : OptionCounts) {
+		for (std::size_t tokens : TokenCounts) {
+			SyntheticCli cli(options, tokens);
+			std::size_t iterations = 0;
+			std::size_t allocations = 0;
+			const auto start = Clock::now();
+			Clock::duration elapsed{};
+			// Гоняем разбор не меньше 50 мс, чтобы сгладить шум таймера
+			while (elapsed < std::chrono::milliseconds(50)) {
+				const std::size_t before = bench::AllocationCount();
+				(void)cli.Parser().Parse().Ok();
+				allocations += bench::AllocationCount() - before;
+				++iterations;
+				elapsed = Clock::now() - start;
+			}
+			const double nsPerToken = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations * cli.Tokens());
+			std::printf("%10zu %10zu %12.1f %14.2f\n", options, tokens, nsPerToken,
+				static_cast<double>(allocations) / static_cast<double>(iterations));
+		}
+	}
+}
+
+TEST_CASE("FindArgument over registered options", "[parser][find][bench]") {
+	for (std::size_t options : OptionCounts) {
+		SyntheticCli cli(options, 1);
+		std::vector<std::string> longTokens;
+		for (const auto& name : cli.Names())
+			longTokens.push_back("--" + name);
+
+		BENCHMARK("FindArgument long, " + std::to_string(options) + " options") {
+			std::size_t found = 0;
+			for (const auto& token : longTokens) {
+				const std::string_view argStr = token;
+				found += cli.Parser().FindArgument({ argStr, argStr.substr(2), {} }) != nullptr;
+			}
+			return found;
+		};
+		std::vector<std::string> shortTokens;
+		for (std::size_t i = 0; i < options && ShortName(i) != '\0'; ++i)
+			shortTokens.push_back(std::string("-") + ShortName(i));
+
+		BENCHMARK("FindArgument short, " + std::to_string(options) + " options") {
+			std::size_t found = 0;
+			for (const auto& token : shortTokens) {
+				const std::string_view argStr = token;
+				found += cli.Parser().FindArgument({ argStr, argStr.substr(1), {} }) != nullptr;
+			}
+			return found;
+		};
+	}
+}
+
+TEST_CASE("Suggestions for unknown long names", "[parser][suggest][bench]") {
+	for (std::size_t options : { std::size_t{ 100 }, std::size_t{ 1000 }, std::size_t{ 5000 } }) {
+		SyntheticCli cli(options, 1);
+		BENCHMARK("edit distance scan, " + std::to_string(options) + " options") {
+			const args_parse::EditDistancePattern pattern("optoin-4217");
+			std::size_t close = 0;
+			for (const auto& name : cli.Names())
+				close += pattern.Distance(name, args_parse::ArgsParser::MaxSuggestionDistance) <= args_parse::ArgsParser::MaxSuggestionDistance;
+			return close;
+		};
+		BENCHMARK("Suggest, " + std::to_string(options) + " options") {
+			return cli.Parser().Suggest("optoin-4217").size();
+		};
+	}
+}
+
+TEST_CASE("ShowHelp rendering", "[parser][help][bench]") {
+	for (std::size_t options : OptionCounts) {
+		SyntheticCli cli(options, 1);
+		bench::SilenceCout silence;
+		BENCHMARK("ShowHelp, " + std::to_string(options) + " options") {
+			cli.Parser().ShowHelp();
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+#include <args_parse/ResponseFile.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace {
+	/// Количество аргументов в сгенерированном файле ответов
+	constexpr std::size_t ResponseTokens = 100000;
+
+	/// @brief Генерация файла ответов: флаги, кавычки, экранирование и комментарии
+	std::filesystem::path WriteResponseFile() {
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "args_parse_bench.rsp";
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out << "# generated by args_parse_bench\n";
+		for (std::size_t i = 0; i < ResponseTokens; ++i) {
+			switch (i % 5) {
+			case 0: out << "-v "; break;
+			case 1: out << "--alpha "; break;
+			case 2: out << "\"--beta\"\n"; break;
+			case 3: out << "-g "; break;
+			default: out << "--del\\ta # comment\n"; break;
+			}
+		}
+		return path;
+	}
+}
+
+TEST_CASE("Response file with 100k tokens", "[response][bench]") {
+	const std::filesystem::path path = WriteResponseFile();
+	const std::string argument = "@" + path.string();
+	const char* argv[] = { "program", argument.c_str() };
+
+	BENCHMARK("tokenize mapped response file") {
+		args_parse::MappedFile file(path);
+		std::size_t tokens = 0;
+		args_parse::TokenizeResponseBuffer(file.Data(), file.Size(), [&tokens](std::string_view) { ++tokens; });
+		return tokens;
+	};
+
+	BENCHMARK("parse @response file") {
+		args_parse::Argument<bool> verbose('v', "verbose", false);
+		args_parse::Argument<bool> alpha('a', "alpha", false);
+		args_parse::Argument<bool> beta('b', "beta", false);
+		args_parse::Argument<bool> gamma('g', "gamma", false);
+		args_parse::Argument<bool> delta('d', "delta", false);
+		args_parse::ArgsParser parser(2, argv);
+		parser.Add(&verbose);
+		parser.Add(&alpha);
+		parser.Add(&beta);
+		parser.Add(&gamma);
+		parser.Add(&delta);
+		return parser.Parse().Ok();
+	};
+
+	std::filesystem::remove(path);
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <CpuTopology.hpp>
+#include <Stats.hpp>
+#include <SyntheticFileSystem.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+	/// @brief Итог серии обходов с одним размещением
+	struct Outcome {
+		double ms = 0;
+		std::uint64_t stolen = 0;
+		std::uint64_t remote = 0;
+		std::uint32_t nodes = 0;
+	};
+
+	/// @brief Медиана времени нескольких обходов синтетического дерева; счетчики - последнего обхода
+	Outcome Measure(SyntheticFileSystem& fileSystem, unsigned threads, const WorkerPlacement& placement, int runs) {
+		Outcome outcome;
+		std::vector<double> samples;
+		for (int run = 0; run < runs; ++run) {
+#ifdef __linux__
+			bench::SilenceStdout silence;
+#endif
+			Stats stats;
+			{
+				OutputWriter output;
+				NodeTable nodes;
+				ThreadPool pool(threads, std::chrono::milliseconds(0), &stats, SchedulingPolicy::DepthFirst, ThreadPool::DefaultPendingLimit, placement);
+				TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+				const auto start = std::chrono::steady_clock::now();
+				TraverseFileSystem(fileSystem, context);
+				samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+				outcome.nodes = nodes.Size();
+			}
+			const StatsReport report = stats.Collect();
+			outcome.stolen = report.Get(StatCounter::TasksStolen);
+			outcome.remote = report.Get(StatCounter::TasksStolenRemote);
+		}
+		std::sort(samples.begin(), samples.end());
+		outcome.ms = samples[samples.size() / 2];
+		return outcome;
+	}
+
+	/// @brief Размещение по узлам без закрепления: модель многоузловой машины на любой машине
+	WorkerPlacement SimulatedNodes(unsigned threads, unsigned nodeCount) {
+		WorkerPlacement placement;
+		placement.nodeCount = nodeCount;
+		for (unsigned i = 0; i < threads; ++i) {
+			placement.cpus.push_back(-1);
+			placement.nodes.push_back(i % nodeCount);
+		}
+		return placement;
+	}
+}
+
+TEST_CASE("Synthetic tree traversal with pinned and NUMA-grouped workers", "[affinity][report]") {
+	const CpuTopology topology = CpuTopology::Detect();
+	std::printf("\nTopology: %u CPUs on %zu NUMA nodes\n", topology.CpuCount(), topology.nodes.size());
+	for (const NumaNode& node : topology.nodes)
+		std::printf("  node %u: %zu CPUs (first %u)\n", node.id, node.cpus.size(), node.cpus.front());
+
+	// 37449 директорий по 16 файлов; stat каждой записи занимает 100 нс
+	SyntheticTreeOptions options;
+	options.depth = 5;
+	options.fanout = 8;
+	options.files = 16;
+	options.entryLatency = std::chrono::nanoseconds(100);
+	SyntheticFileSystem fileSystem(options);
+	const SyntheticTreeSize size = fileSystem.Size();
+
+	const unsigned threads = std::max(4u, topology.CpuCount());
+	struct Variant {
+		const char* name;
+		WorkerPlacement placement;
+	};
+	const std::vector<Variant> variants{
+		{ "none", PlanPlacement(topology, threads, AffinityPolicy::None) },
+		{ "compact", PlanPlacement(topology, threads, AffinityPolicy::Compact) },
+		{ "spread", PlanPlacement(topology, threads, AffinityPolicy::Spread) },
+		// Очереди и порядок перехвата двух и четырех узлов без закрепления: доля перехватов между узлами
+		{ "2 nodes, unpinned", SimulatedNodes(threads, 2) },
+		{ "4 nodes, unpinned", SimulatedNodes(threads, 4) },
+	};
+	std::printf("\n%u threads, %llu entries\n", threads, static_cast<unsigned long long>(size.directories + size.files));
+	std::printf("%-20s %8s %10s %10s %12s\n", "placement", "nodes", "ms", "stolen", "remote %");
+	for (const Variant& variant : variants) {
+		const Outcome outcome = Measure(fileSystem, threads, variant.placement, 5);
+		std::printf("%-20s %8u %10.2f %10llu %11.1f%%\n", variant.name, variant.placement.nodeCount, outcome.ms,
+			static_cast<unsigned long long>(outcome.stolen),
+			outcome.stolen == 0 ? 0.0 : 100.0 * static_cast<double>(outcome.remote) / static_cast<double>(outcome.stolen));
+		CHECK(outcome.nodes == size.directories + size.files);
+	}
+}
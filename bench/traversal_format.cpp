@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <OutputFormat.hpp>
+#include <Stats.hpp>
+#include <SyntheticFileSystem.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	struct Variant {
+		const char* name;
+		OutputFormat format;
+	};
+	const Variant Formats[] = {
+		{ "text", OutputFormat::Text },
+		{ "ndjson", OutputFormat::Ndjson },
+		{ "tsv", OutputFormat::Tsv },
+		{ "binary", OutputFormat::Binary },
+	};
+
+	/// @brief Имена файлов, похожие на настоящие (длиной 6-30 байт)
+	std::vector<std::string> SampleNames() {
+		std::vector<std::string> names;
+		for (int i = 0; i < 256; ++i)
+			names.push_back("file_" + std::to_string(i * 7919) + std::string(static_cast<std::size_t>(i % 20), 'x') + ".dat");
+		return names;
+	}
+}
+
+TEST_CASE("Record formatting throughput per output format", "[format][report]") {
+	const std::vector<std::string> names = SampleNames();
+	const std::string directory = "/srv/data/projects/archive/2024";
+	constexpr std::size_t Records = 4000000;
+	std::printf("\n%-10s %12s %12s %10s\n", "format", "Mrecords/s", "MiB/s", "bytes/rec");
+	for (const Variant& variant : Formats) {
+		if (variant.format == OutputFormat::Text)
+			continue;
+		// Записи копятся в строке размером с блок вывода, как в WriteListing
+		std::string prefix;
+		AppendPathPrefix(prefix, variant.format, directory);
+		std::string out;
+		out.reserve(2 * OutputWriter::ChunkSize);
+		std::size_t bytes = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < Records; ++i) {
+			AppendRecord(out, variant.format, i % 8 == 0 ? NodeType::Directory : NodeType::File, i * 4099 % 1000000,
+				1704067200000000000ll + static_cast<std::int64_t>(i), prefix, names[i % names.size()]);
+			if (out.size() >= OutputWriter::ChunkSize) {
+				bytes += out.size();
+				out.clear();
+			}
+		}
+		bytes += out.size();
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("%-10s %12.2f %12.1f %10.1f\n", variant.name, Records / seconds / 1e6,
+			static_cast<double>(bytes) / seconds / (1024.0 * 1024.0), static_cast<double>(bytes) / Records);
+		CHECK(bytes > Records);
+	}
+}
+
+TEST_CASE("Binary records can be walked by their length prefix", "[format][report]") {
+	std::string stream(StreamHeader(OutputFormat::Binary));
+	const std::vector<std::string> names = SampleNames();
+	std::string prefix;
+	AppendPathPrefix(prefix, OutputFormat::Binary, "/root");
+	for (std::size_t i = 0; i < names.size(); ++i)
+		AppendRecord(stream, OutputFormat::Binary, NodeType::File, i, 0, prefix, names[i]);
+	AppendRecord(stream, OutputFormat::Binary, NodeType::Directory, 0, 0, prefix, "sub\tdir");
+
+	binary_output::StreamHeader header;
+	std::memcpy(&header, stream.data(), sizeof(header));
+	CHECK(std::memcmp(header.magic, binary_output::Magic, sizeof(header.magic)) == 0);
+	CHECK(header.byteOrder == binary_output::ByteOrderMark);
+
+	std::size_t records = 0;
+	std::string last;
+	for (std::size_t offset = sizeof(header); offset < stream.size();) {
+		binary_output::RecordHeader record;
+		std::memcpy(&record, stream.data() + offset, sizeof(record));
+		REQUIRE(record.length % binary_output::Alignment == 0);
+		REQUIRE(offset + record.length <= stream.size());
+		last.assign(stream.data() + offset + sizeof(record), record.pathLength);
+		if (records < names.size())
+			CHECK(last == "/root/" + names[records]);
+		offset += record.length;
+		++records;
+	}
+	CHECK(records == names.size() + 1);
+	CHECK(last == "/root/sub\tdir");
+}
+
+TEST_CASE("Synthetic tree traversal throughput per output format", "[format][report]") {
+	// 37449 директорий по 24 файла, вывод идет в /dev/null
+	SyntheticTreeOptions options;
+	options.depth = 5;
+	options.fanout = 8;
+	options.files = 24;
+	SyntheticFileSystem fileSystem(options);
+	const SyntheticTreeSize size = fileSystem.Size();
+	const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("\n%llu entries, %u threads\n", static_cast<unsigned long long>(size.directories + size.files), threads);
+	std::printf("%-10s %10s %14s %12s\n", "format", "ms", "entries/s", "output MiB");
+	for (const Variant& variant : Formats) {
+		std::vector<double> samples;
+		std::uint64_t bytes = 0;
+		for (int run = 0; run < 5; ++run) {
+#ifdef __linux__
+			bench::SilenceStdout silence;
+#endif
+			Stats stats;
+			{
+				OutputWriter output(OutputWriter::DefaultBudget, &stats);
+				NodeTable nodes;
+				ThreadPool pool(threads, std::chrono::milliseconds(0));
+				TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0), variant.format };
+				const auto start = std::chrono::steady_clock::now();
+				TraverseFileSystem(fileSystem, context);
+				samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+				CHECK(nodes.Size() == size.directories + size.files);
+			}
+			bytes = stats.Collect().Get(StatCounter::OutputBytes);
+		}
+		std::sort(samples.begin(), samples.end());
+		const double ms = samples[samples.size() / 2];
+		std::printf("%-10s %10.2f %14.0f %12.1f\n", variant.name, ms, (size.directories + size.files) / ms * 1000.0,
+			static_cast<double>(bytes) / (1024.0 * 1024.0));
+	}
+}
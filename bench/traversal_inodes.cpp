@@ -0,0 +1,168 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <InodeSet.hpp>
+#include <Stats.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+	/// @brief Ключ unordered_set для сравнения: пара (устройство, inode)
+	struct PairHash {
+		std::size_t operator()(const std::pair<std::uint64_t, std::uint64_t>& key) const {
+			return std::hash<std::uint64_t>()(key.first * 0x9E3779B97F4A7C15ull ^ key.second);
+		}
+	};
+
+	/// @brief Вставка Keys пар потоками threads, половина пар встречается дважды (как директории и жесткие ссылки);
+	/// возвращает миллионы вставок в секунду, first - сколько вставок оказались первыми
+	template<typename Insert>
+	double MeasureInserts(unsigned threads, std::size_t keys, Insert&& insert, std::size_t& first) {
+		std::atomic<std::size_t> firstVisits{ 0 };
+		std::vector<std::thread> workers;
+		const auto start = std::chrono::steady_clock::now();
+		for (unsigned t = 0; t < threads; ++t) {
+			workers.emplace_back([&, t] {
+				std::size_t own = 0;
+				for (std::size_t i = t; i < 2 * keys; i += threads) {
+					// Устройства 2049 и 2050, inode как у обычной файловой системы
+					const std::uint64_t key = i % keys;
+					if (insert(2049 + key % 2, 1000 + key * 3))
+						++own;
+				}
+				firstVisits.fetch_add(own);
+			});
+		}
+		for (std::thread& worker : workers)
+			worker.join();
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		first = firstVisits.load();
+		return 2 * keys / seconds / 1e6;
+	}
+}
+
+TEST_CASE("Concurrent inode set insert throughput against a locked unordered_set", "[inodes][report]") {
+	constexpr std::size_t Keys = 1000000;
+	std::printf("\n%7s %16s %16s %10s %12s\n", "threads", "InodeSet M/s", "locked set M/s", "overflow", "table MiB");
+	for (const unsigned threads : { 1u, 2u, 4u, 8u }) {
+		InodeSet visited(Keys);
+		std::size_t first = 0;
+		const double sharded = MeasureInserts(threads, Keys,
+			[&visited](std::uint64_t device, std::uint64_t inode) { return visited.Insert(device, inode); }, first);
+		CHECK(first == Keys);
+		CHECK(visited.Size() == Keys);
+
+		std::unordered_set<std::pair<std::uint64_t, std::uint64_t>, PairHash> locked;
+		locked.reserve(Keys);
+		std::mutex mutex;
+		const double global = MeasureInserts(threads, Keys, [&](std::uint64_t device, std::uint64_t inode) {
+			std::lock_guard<std::mutex> lock(mutex);
+			return locked.emplace(device, inode).second;
+		}, first);
+		CHECK(first == Keys);
+
+		std::printf("%7u %16.1f %16.1f %10zu %12.1f\n", threads, sharded, global, visited.OverflowSize(),
+			static_cast<double>(visited.MemoryUsage()) / (1024.0 * 1024.0));
+	}
+}
+
+TEST_CASE("Inode set stays exact past its capacity", "[inodes][report]") {
+	// Таблицы на 1024 пары: остальное уходит в запасные множества, но ответы не меняются
+	InodeSet visited(1024);
+	constexpr std::uint64_t Keys = 100000;
+	std::size_t first = 0;
+	for (std::uint64_t i = 0; i < Keys; ++i)
+		first += visited.Insert(2049, i + 1) ? 1 : 0;
+	// Пары, которые нельзя закодировать в ключ таблицы: большой inode и больше MaxDevices устройств
+	for (std::uint64_t device = 0; device < InodeSet::MaxDevices + 16; ++device)
+		first += visited.Insert(device + 10, 1ull << 60) ? 1 : 0;
+	std::size_t again = 0;
+	for (std::uint64_t i = 0; i < Keys; ++i)
+		again += visited.Insert(2049, i + 1) ? 1 : 0;
+	std::printf("\n%llu pairs, %zu in overflow sets, %.2f MiB of tables\n", static_cast<unsigned long long>(visited.Size()),
+		visited.OverflowSize(), static_cast<double>(visited.MemoryUsage()) / (1024.0 * 1024.0));
+	CHECK(first == Keys + InodeSet::MaxDevices + 16);
+	CHECK(again == 0);
+	CHECK(visited.Size() == first);
+	CHECK(visited.OverflowSize() > 0);
+}
+
+#ifdef __linux__
+namespace {
+	/// @brief Сумма размеров файлов в таблице узлов (байты, учтенные сводкой)
+	std::uint64_t FileBytes(const NodeTable& nodes) {
+		std::uint64_t bytes = 0;
+		for (std::uint32_t i = 0; i < nodes.Size(); ++i) {
+			if (nodes[i].type == NodeType::File)
+				bytes += nodes[i].size;
+		}
+		return bytes;
+	}
+}
+
+TEST_CASE("Symlink loops and hardlinks with and without --dedupe", "[inodes][report]") {
+	// 8x8 поддиректорий по 16 файлов; у каждого файла вторая жесткая ссылка в links,
+	// а loop - символическая ссылка на корень, которую раскрывает только directory_iterator
+	bench::TemporaryTree tree("directory_travers_bench_inodes", 8, 8, 16);
+	const std::filesystem::path links = tree.Root() / "links";
+	std::filesystem::create_directory(links);
+	std::uint64_t bytes = 0;
+	for (int d = 0; d < 8; ++d) {
+		for (int s = 0; s < 8; ++s) {
+			const auto directory = tree.Root() / ("dir_" + std::to_string(d)) / ("sub_" + std::to_string(s));
+			for (int f = 0; f < 16; ++f) {
+				const auto file = directory / ("file_" + std::to_string(f) + ".dat");
+				std::filesystem::create_hard_link(file, links / (std::to_string(d) + "_" + std::to_string(s) + "_" + std::to_string(f)));
+				bytes += std::filesystem::file_size(file);
+			}
+		}
+	}
+	std::filesystem::create_directory_symlink(tree.Root(), tree.Root() / "dir_0" / "loop");
+
+	const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	struct Variant {
+		const char* name;
+		TraversalBackend backend;
+		bool dedupe;
+	};
+	// directory_iterator без --dedupe ходит по циклу до ELOOP/ENAMETOOLONG, поэтому не запускается
+	const Variant variants[] = {
+		{ "getdents", TraversalBackend::Getdents, false },
+		{ "getdents --dedupe", TraversalBackend::Getdents, true },
+		{ "uring --dedupe", TraversalBackend::Uring, true },
+		{ "filesystem --dedupe", TraversalBackend::Filesystem, true },
+	};
+	std::printf("\n%llu bytes in files, each linked twice\n", static_cast<unsigned long long>(bytes));
+	std::printf("%-22s %10s %10s %14s %10s\n", "backend", "ms", "nodes", "counted bytes", "revisited");
+	for (const Variant& variant : variants) {
+		Stats stats;
+		OutputWriter output(OutputWriter::DefaultBudget, &stats);
+		NodeTable nodes;
+		ThreadPool pool(threads, std::chrono::milliseconds(0));
+		SummaryTable summary;
+		InodeSet visited;
+		TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+		context._summary = &summary;
+		context._stats = &stats;
+		if (variant.dedupe)
+			context._visited = &visited;
+		const auto start = std::chrono::steady_clock::now();
+		TraverseDirectory(tree.Root(), context, variant.backend);
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		const std::uint64_t counted = FileBytes(nodes);
+		std::printf("%-22s %10.2f %10u %14llu %10llu\n", variant.name, ms, nodes.Size(), static_cast<unsigned long long>(counted),
+			static_cast<unsigned long long>(stats.Collect().Get(StatCounter::InodesRevisited)));
+		CHECK(counted == (variant.dedupe ? bytes : 2 * bytes));
+	}
+}
+#endif
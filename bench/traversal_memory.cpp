@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Directory.hpp>
+#include <NodeTable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	/// @brief Синтетическое дерево: в каждой директории Files файлов и Fanout поддиректорий.
+	/// Глубина 5 дает 3906 директорий и около 254 тыс. записей.
+	constexpr unsigned Fanout = 5;
+	constexpr unsigned Depth = 5;
+	constexpr unsigned Files = 64;
+	const char* const Root = "/mnt/volume/projects/synthetic-index-root";
+
+	[[nodiscard]] std::string FileName(unsigned i) { return "source_file_" + std::to_string(i) + ".cpp"; }
+	[[nodiscard]] std::string DirectoryName(unsigned i) { return "module_" + std::to_string(i); }
+
+	/// @brief Прежнее представление: вложенные Directory с полными путями
+	void BuildDirectory(Directory& directory, unsigned depth, std::size_t& entries) {
+		for (unsigned i = 0; i < Files; ++i)
+			directory.AddFile(directory.GetPath() / FileName(i));
+		entries += Files;
+		if (depth == Depth)
+			return;
+		for (unsigned i = 0; i < Fanout; ++i) {
+			directory.AddDirectory(directory.GetPath() / DirectoryName(i));
+			BuildDirectory(directory._directories.back(), depth + 1, entries);
+		}
+		entries += Fanout;
+	}
+
+	/// @brief Таблица узлов: имя записи в арене, родитель по индексу
+	void BuildTable(NodeTable& nodes, std::uint32_t node, unsigned depth, std::size_t& entries) {
+		std::vector<NodeTable::Entry> batch;
+		for (unsigned i = 0; i < Files; ++i)
+			batch.push_back({ NodeType::File, nodes.StoreName(FileName(i)), 4096 });
+		if (depth < Depth) {
+			for (unsigned i = 0; i < Fanout; ++i)
+				batch.push_back({ NodeType::Directory, nodes.StoreName(DirectoryName(i)), 0 });
+		}
+		const std::uint32_t first = nodes.Append(node, batch);
+		entries += batch.size();
+		for (std::uint32_t i = 0; i < batch.size(); ++i) {
+			if (batch[i].type == NodeType::Directory)
+				BuildTable(nodes, first + i, depth + 1, entries);
+		}
+	}
+
+#ifdef __linux__
+	/// @brief Пиковый RSS (КиБ) дочернего процесса, выполнившего build
+	[[nodiscard]] long PeakRss(const std::function<std::size_t()>& build, std::size_t& entries) {
+		int pipe[2];
+		if (::pipe(pipe) != 0)
+			return -1;
+		const pid_t pid = ::fork();
+		if (pid == 0) {
+			::close(pipe[0]);
+			const std::size_t count = build();
+			(void)::write(pipe[1], &count, sizeof(count));
+			::_exit(0);
+		}
+		::close(pipe[1]);
+		entries = 0;
+		(void)::read(pipe[0], &entries, sizeof(entries));
+		::close(pipe[0]);
+		int status = 0;
+		struct rusage usage {};
+		if (pid < 0 || ::wait4(pid, &status, 0, &usage) != pid)
+			return -1;
+		return usage.ru_maxrss;
+	}
+#endif
+}
+
+TEST_CASE("Peak RSS of the traversal tree representation", "[memory][report]") {
+#ifdef __linux__
+	std::size_t entries = 0;
+	const long baseline = PeakRss([] { return std::size_t(0); }, entries);
+	const long nested = PeakRss([] {
+		std::size_t count = 0;
+		Directory root(Root);
+		BuildDirectory(root, 0, count);
+		return count;
+	}, entries);
+	const std::size_t nestedEntries = entries;
+	const long table = PeakRss([] {
+		std::size_t count = 0;
+		NodeTable nodes;
+		BuildTable(nodes, nodes.AddRoot(Root), 0, count);
+		return count;
+	}, entries);
+
+	std::printf("\n%-28s %12s %12s %14s\n", "representation", "entries", "peak RSS KiB", "bytes/entry");
+	std::printf("%-28s %12s %12ld %14s\n", "empty process", "-", baseline, "-");
+	std::printf("%-28s %12zu %12ld %14.1f\n", "nested Directory + paths", nestedEntries, nested,
+		1024.0 * static_cast<double>(nested - baseline) / static_cast<double>(nestedEntries));
+	std::printf("%-28s %12zu %12ld %14.1f\n", "NodeTable + name arenas", entries, table,
+		1024.0 * static_cast<double>(table - baseline) / static_cast<double>(entries));
+	CHECK(table < nested);
+#else
+	WARN("peak RSS is measured with fork/wait4 on Linux only");
+#endif
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ThreadPool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Прежний пул потоков: одна очередь под одним мьютексом.
+	/// Оставлен здесь как точка отсчета для сравнения с пулом с перехватом задач.
+	struct MutexThreadPool {
+		std::queue<std::function<void()>> _tasks;
+		std::mutex _taskMutex;
+		std::condition_variable _taskCV;
+		std::vector<std::thread> _threads;
+		bool _stop = false;
+
+		explicit MutexThreadPool(unsigned int threadPool) {
+			for (unsigned int i = 0; i < threadPool; ++i)
+				_threads.emplace_back([this] { WorkerThread(); });
+		}
+
+		~MutexThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(_taskMutex);
+				_stop = true;
+			}
+			_taskCV.notify_all();
+			for (auto& thread : _threads)
+				thread.join();
+		}
+
+		void WorkerThread() {
+			while (true) {
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(_taskMutex);
+					_taskCV.wait(lock, [this] { return !_tasks.empty() || _stop; });
+					if (_stop && _tasks.empty()) return;
+					task = std::move(_tasks.front());
+					_tasks.pop();
+				}
+				task();
+			}
+		}
+
+		void EnqueueTask(std::function<void()>&& task) {
+			{
+				std::lock_guard<std::mutex> lock(_taskMutex);
+				_tasks.emplace(std::move(task));
+			}
+			_taskCV.notify_one();
+		}
+	};
+
+	/// @brief Синтетическое дерево директорий: каждый узел порождает Fanout подзадач до глубины Depth,
+	/// на каждом узле выполняется немного работы, имитирующей разбор записей директории.
+	/// 8^5 = 32768 листьев, 37449 задач на прогон.
+	constexpr unsigned Fanout = 8;
+	constexpr unsigned Depth = 5;
+	constexpr unsigned WorkPerNode = 256;
+
+	[[nodiscard]] constexpr std::size_t TreeTasks() {
+		std::size_t total = 0, level = 1;
+		for (unsigned d = 0; d <= Depth; ++d) {
+			total += level;
+			level *= Fanout;
+		}
+		return total;
+	}
+
+	/// @brief Ожидание выполнения заданного количества задач
+	class Completion {
+	public:
+		explicit Completion(std::size_t expected) : _remaining(expected) {}
+
+		void Done() {
+			if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				_cv.notify_all();
+			}
+		}
+
+		void Wait() {
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this] { return _remaining.load(std::memory_order_acquire) == 0; });
+		}
+
+	private:
+		std::atomic<std::size_t> _remaining;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+	};
+
+	[[nodiscard]] std::uint64_t NodeWork(std::uint64_t seed) {
+		for (unsigned i = 0; i < WorkPerNode; ++i)
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		return seed;
+	}
+
+	template<typename Pool>
+	void SpawnNode(Pool& pool, Completion& completion, std::atomic<std::uint64_t>& sink, unsigned depth, std::uint64_t seed) {
+		sink.fetch_xor(NodeWork(seed), std::memory_order_relaxed);
+		if (depth < Depth) {
+			for (unsigned i = 0; i < Fanout; ++i) {
+				pool.EnqueueTask([&pool, &completion, &sink, depth, seed, i] {
+					SpawnNode(pool, completion, sink, depth + 1, seed * Fanout + i);
+				});
+			}
+		}
+		completion.Done();
+	}
+
+	/// @brief Один прогон дерева задач на готовом пуле
+	template<typename Pool>
+	std::uint64_t RunTree(Pool& pool) {
+		Completion completion(TreeTasks());
+		std::atomic<std::uint64_t> sink{ 0 };
+		pool.EnqueueTask([&pool, &completion, &sink] { SpawnNode(pool, completion, sink, 0, 1); });
+		completion.Wait();
+		return sink.load();
+	}
+}
+
+TEST_CASE("Thread pool scaling on a recursive task tree", "[pool]") {
+	for (unsigned threads : { 1u, 2u, 4u, 8u, 16u, 32u, 64u }) {
+		const std::string suffix = " (" + std::to_string(threads) + " threads)";
+
+		MutexThreadPool mutexPool(threads);
+		BENCHMARK("single mutex queue" + suffix) {
+			return RunTree(mutexPool);
+		};
+
+		ThreadPool stealingPool(threads, std::chrono::milliseconds(0));
+		BENCHMARK("work stealing" + suffix) {
+			return RunTree(stealingPool);
+		};
+	}
+}
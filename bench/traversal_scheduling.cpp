@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <SyntheticFileSystem.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace {
+	/// @brief Итог обхода в дочернем процессе
+	struct Outcome {
+		double ms = 0;
+		std::size_t peakPending = 0;
+		std::uint32_t nodes = 0;
+		/// Пиковый RSS, КиБ
+		long peakRss = -1;
+	};
+
+	/// @brief Обход синтетического дерева в дочернем процессе: у каждого прогона свой пиковый RSS
+	Outcome Run(const SyntheticTreeOptions& options, SchedulingPolicy policy, std::size_t pendingLimit) {
+		Outcome outcome;
+		int pipe[2];
+		if (::pipe(pipe) != 0)
+			return outcome;
+		// Иначе дочерний процесс повторит унаследованный буфер stdout
+		std::fflush(stdout);
+		const pid_t pid = ::fork();
+		if (pid == 0) {
+			::close(pipe[0]);
+			Outcome child;
+			{
+				bench::SilenceStdout silence;
+				SyntheticFileSystem fileSystem(options);
+				OutputWriter output;
+				NodeTable nodes;
+				ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()), std::chrono::milliseconds(0), nullptr, policy, pendingLimit);
+				TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+				const auto start = std::chrono::steady_clock::now();
+				TraverseFileSystem(fileSystem, context);
+				child.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				child.peakPending = pool.PeakPending();
+				child.nodes = nodes.Size();
+			}
+			(void)::write(pipe[1], &child, sizeof(child));
+			::_exit(0);
+		}
+		::close(pipe[1]);
+		(void)::read(pipe[0], &outcome, sizeof(outcome));
+		::close(pipe[0]);
+		int status = 0;
+		struct rusage usage {};
+		if (pid > 0 && ::wait4(pid, &status, 0, &usage) == pid)
+			outcome.peakRss = usage.ru_maxrss;
+		return outcome;
+	}
+
+	void Report(const char* shape, const SyntheticTreeOptions& options) {
+		SyntheticFileSystem fileSystem(options);
+		const SyntheticTreeSize size = fileSystem.Size();
+		std::printf("\n%s: %llu directories, %llu entries\n", shape, static_cast<unsigned long long>(size.directories),
+			static_cast<unsigned long long>(size.directories + size.files));
+		std::printf("%-16s %10s %14s %14s\n", "policy", "ms", "peak pending", "peak RSS KiB");
+		struct Variant {
+			const char* name;
+			SchedulingPolicy policy;
+			std::size_t limit;
+		};
+		for (const Variant variant : { Variant{ "dfs", SchedulingPolicy::DepthFirst, 0 }, Variant{ "bfs", SchedulingPolicy::BreadthFirst, 0 },
+			Variant{ "hybrid 4096", SchedulingPolicy::Hybrid, 4096 }, Variant{ "hybrid 256", SchedulingPolicy::Hybrid, 256 } }) {
+			const Outcome outcome = Run(options, variant.policy, variant.limit);
+			std::printf("%-16s %10.2f %14zu %14ld\n", variant.name, outcome.ms, outcome.peakPending, outcome.peakRss);
+			CHECK(outcome.nodes == size.directories + size.files);
+			if (variant.policy == SchedulingPolicy::Hybrid)
+				CHECK(outcome.peakPending <= variant.limit + std::max(1u, std::thread::hardware_concurrency()));
+		}
+	}
+}
+#endif
+
+TEST_CASE("Peak memory and time of scheduling policies on wide and deep trees", "[scheduling][report]") {
+#ifdef __linux__
+	// Широкое дерево: 600 поддиректорий на двух уровнях, очередь по уровням вмещает весь второй уровень
+	SyntheticTreeOptions wide;
+	wide.depth = 2;
+	wide.fanout = 600;
+	wide.files = 2;
+	Report("wide (depth 2, fanout 600)", wide);
+
+	// Глубокое узкое дерево: 11 уровней по 3 поддиректории
+	SyntheticTreeOptions deep;
+	deep.depth = 11;
+	deep.fanout = 3;
+	deep.files = 2;
+	Report("deep (depth 11, fanout 3)", deep);
+#else
+	WARN("peak RSS is measured with fork/wait4 on Linux only");
+#endif
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <Snapshot.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+namespace {
+	/// @brief Медиана времени обхода; previous - снимок для повторного использования, save - записать новый
+	double MedianMilliseconds(const std::filesystem::path& root, TraversalBackend backend,
+		const std::filesystem::path* previousFile, const std::filesystem::path* saveFile, std::uint64_t& reused) {
+		std::vector<double> samples;
+		for (int run = 0; run < 7; ++run) {
+			bench::SilenceStdout silence;
+			OutputWriter output;
+			NodeTable nodes;
+			ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()), std::chrono::milliseconds(0));
+			TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+			const auto start = std::chrono::steady_clock::now();
+			// Открытие снимка и его запись входят в замер: это стоимость повторного обхода целиком
+			std::unique_ptr<SnapshotReader> previous;
+			if (previousFile != nullptr) {
+				previous = std::make_unique<SnapshotReader>(*previousFile);
+				REQUIRE(previous->Valid());
+				context._previous = previous.get();
+			}
+			SnapshotWriter snapshot(SnapshotFlags(backend));
+			if (saveFile != nullptr)
+				context._snapshot = &snapshot;
+			TraverseDirectory(root, context, backend);
+			std::string error;
+			if (saveFile != nullptr)
+				REQUIRE(snapshot.Save(*saveFile, nodes, error));
+			samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			reused = snapshot.Reused();
+		}
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+}
+#endif
+
+TEST_CASE("Re-scan time with and without a snapshot of the previous run", "[snapshot][report]") {
+#ifdef __linux__
+	// 4096 директорий по 8 файлов: повторный обход упирается в системные вызовы на директорию
+	bench::TemporaryTree tree("directory_travers_bench_snapshot", 64, 64, 8);
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "directory_travers_bench.snapshot";
+	std::printf("\n%-10s %12s %12s %12s %10s\n", "backend", "full ms", "+save ms", "reuse ms", "reused");
+	for (const TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring }) {
+		std::uint64_t reused = 0;
+		const double full = MedianMilliseconds(tree.Root(), backend, nullptr, nullptr, reused);
+		const double save = MedianMilliseconds(tree.Root(), backend, nullptr, &file, reused);
+		// Установившийся режим: дерево не меняется, снимок читается и переписывается каждым обходом
+		const double reuse = MedianMilliseconds(tree.Root(), backend, &file, &file, reused);
+		const char* name = backend == TraversalBackend::Filesystem ? "filesystem" : backend == TraversalBackend::Getdents ? "getdents" : "uring";
+		std::printf("%-10s %12.2f %12.2f %12.2f %10llu\n", name, full, save, reuse, static_cast<unsigned long long>(reused));
+		CHECK(reused == 64 * 64 + 64 + 1);
+	}
+	std::error_code error;
+	std::filesystem::remove(file, error);
+#else
+	WARN("snapshot benchmark uses Linux-only backends");
+#endif
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <Stats.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Медиана
+	double Median(std::vector<double> samples) {
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+
+	/// @brief Время обхода со статистикой или без (мс)
+	double TraversalMilliseconds(const std::filesystem::path& root, TraversalBackend backend, bool withStats) {
+#ifdef __linux__
+		bench::SilenceStdout silence;
+#endif
+		std::optional<Stats> stats;
+		if (withStats)
+			stats.emplace();
+		Stats* const statsInUse = stats ? &*stats : nullptr;
+		OutputWriter output(OutputWriter::DefaultBudget, statsInUse);
+		NodeTable nodes;
+		ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()), std::chrono::milliseconds(0), statsInUse);
+		TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+		context._stats = statsInUse;
+		const auto start = std::chrono::steady_clock::now();
+		TraverseDirectory(root, context, backend);
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/// @brief Время выполнения дерева пустых задач (каждая порождает fanout дочерних до глубины depth), мс
+	double PoolMilliseconds(bool withStats, std::size_t& tasks) {
+		std::optional<Stats> stats;
+		if (withStats)
+			stats.emplace();
+		ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()), std::chrono::milliseconds(0), stats ? &*stats : nullptr);
+		std::atomic<std::size_t> done{ 0 };
+		struct Spawn {
+			ThreadPool& pool;
+			std::atomic<std::size_t>& done;
+			void operator()(int depth) const {
+				done.fetch_add(1, std::memory_order_relaxed);
+				if (depth == 0)
+					return;
+				for (int i = 0; i < 8; ++i)
+					pool.EnqueueTask([self = *this, depth] { self(depth - 1); });
+			}
+		};
+		const auto start = std::chrono::steady_clock::now();
+		pool.EnqueueTask([spawn = Spawn{ pool, done }] { spawn(6); });
+		pool.Wait();
+		tasks = done.load();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+TEST_CASE("Statistics overhead: traversal and pool with --stats on and off", "[stats][report]") {
+	// 256 директорий по 64 файла в два уровня
+	bench::TemporaryTree tree("directory_travers_bench_stats", 16, 16, 64);
+	std::vector<TraversalBackend> backends{ TraversalBackend::Filesystem };
+#ifdef __linux__
+	backends.push_back(TraversalBackend::Getdents);
+	backends.push_back(TraversalBackend::Uring);
+#endif
+	const char* names[] = { "filesystem", "getdents", "uring" };
+
+	std::printf("\n%-12s %10s %10s %10s\n", "workload", "off ms", "on ms", "overhead");
+	for (const TraversalBackend backend : backends) {
+		// Прогрев кэша страниц, затем замеры со статистикой и без чередуются
+		TraversalMilliseconds(tree.Root(), backend, false);
+		std::vector<double> off, on;
+		for (int run = 0; run < 9; ++run) {
+			off.push_back(TraversalMilliseconds(tree.Root(), backend, false));
+			on.push_back(TraversalMilliseconds(tree.Root(), backend, true));
+		}
+		const double offMs = Median(off);
+		const double onMs = Median(on);
+		std::printf("%-12s %10.2f %10.2f %9.1f%%\n", names[static_cast<int>(backend)], offMs, onMs, (onMs / offMs - 1.0) * 100.0);
+	}
+
+	// Пустые задачи: худший случай, на задачу приходятся два чтения часов и несколько счетчиков
+	std::size_t tasks = 0;
+	std::vector<double> off, on;
+	for (int run = 0; run < 9; ++run) {
+		off.push_back(PoolMilliseconds(false, tasks));
+		on.push_back(PoolMilliseconds(true, tasks));
+	}
+	const double offMs = Median(off);
+	const double onMs = Median(on);
+	std::printf("%-12s %10.2f %10.2f %9.1f%%  (%zu tasks, %.1f ns/task added)\n", "empty tasks", offMs, onMs,
+		(onMs / offMs - 1.0) * 100.0, tasks, (onMs - offMs) * 1e6 / static_cast<double>(tasks));
+	CHECK(tasks == 299593);
+}
@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <Summary.hpp>
+#include <SyntheticFileSystem.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Медиана времени обхода (мс): списки в /dev/null или сводка (summarize)
+	double MedianMilliseconds(SyntheticFileSystem& fileSystem, unsigned threads, bool summarize, std::uint64_t& rootBytes) {
+		std::vector<double> samples;
+		for (int run = 0; run < 5; ++run) {
+#ifdef __linux__
+			bench::SilenceStdout silence;
+#endif
+			OutputWriter output;
+			NodeTable nodes;
+			SummaryTable summary;
+			ThreadPool pool(threads, std::chrono::milliseconds(0));
+			TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+			if (summarize)
+				context._summary = &summary;
+			const auto start = std::chrono::steady_clock::now();
+			const std::uint32_t root = TraverseFileSystem(fileSystem, context);
+			samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			if (summarize)
+				rootBytes = summary.Find(root)->_subtree.bytes;
+		}
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+}
+
+TEST_CASE("Cost of --summarize against plain listings", "[summary][report]") {
+	// Итоги заводятся на директорию, поэтому цена видна на деревьях из множества маленьких директорий
+	struct Shape { unsigned depth, fanout, files; };
+	const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("\n%u threads\n%-16s %10s %12s %12s %14s\n", threads, "depth/fanout/files", "dirs", "listing ms", "summary ms", "summary ns/dir");
+	for (const Shape shape : { Shape{ 6, 8, 2 }, Shape{ 5, 8, 24 } }) {
+		SyntheticTreeOptions options;
+		options.depth = shape.depth;
+		options.fanout = shape.fanout;
+		options.files = shape.files;
+		SyntheticFileSystem fileSystem(options);
+		const SyntheticTreeSize size = fileSystem.Size();
+		std::uint64_t rootBytes = 0;
+		const double listing = MedianMilliseconds(fileSystem, threads, false, rootBytes);
+		const double summary = MedianMilliseconds(fileSystem, threads, true, rootBytes);
+		char name[32];
+		std::snprintf(name, sizeof(name), "%u/%u/%u", shape.depth, shape.fanout, shape.files);
+		std::printf("%-16s %10llu %12.2f %12.2f %14.1f\n", name, static_cast<unsigned long long>(size.directories), listing, summary,
+			summary * 1e6 / static_cast<double>(size.directories));
+		CHECK(rootBytes > 0);
+	}
+}
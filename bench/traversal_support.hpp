@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+	/// @brief Синтетическое дерево во временной директории: top директорий по sub поддиректорий,
+	/// в каждой поддиректории files файлов. Удаляется вместе с объектом.
+	class TemporaryTree {
+	public:
+		TemporaryTree(const std::string& name, int top, int sub, int files) : _root(std::filesystem::temp_directory_path() / name) {
+			std::filesystem::remove_all(_root);
+			for (int d = 0; d < top; ++d) {
+				for (int s = 0; s < sub; ++s) {
+					const auto directory = _root / ("dir_" + std::to_string(d)) / ("sub_" + std::to_string(s));
+					std::filesystem::create_directories(directory);
+					for (int f = 0; f < files; ++f)
+						std::ofstream(directory / ("file_" + std::to_string(f) + ".dat")) << f;
+				}
+			}
+		}
+		~TemporaryTree() {
+			std::error_code error;
+			std::filesystem::remove_all(_root, error);
+		}
+
+		TemporaryTree(const TemporaryTree&) = delete;
+		TemporaryTree& operator=(const TemporaryTree&) = delete;
+
+		[[nodiscard]] const std::filesystem::path& Root() const { return _root; }
+
+	private:
+		std::filesystem::path _root;
+	};
+
+#ifdef __linux__
+	/// @brief Перенаправление stdout в /dev/null на время жизни объекта (OutputWriter пишет прямо в дескриптор 1)
+	class SilenceStdout {
+	public:
+		SilenceStdout() : _saved(::dup(STDOUT_FILENO)) {
+			// Буфер stdio сбрасывается заранее, иначе накопленный отчет уйдет в /dev/null
+			std::fflush(stdout);
+			const int null = ::open("/dev/null", O_WRONLY);
+			::dup2(null, STDOUT_FILENO);
+			::close(null);
+		}
+		~SilenceStdout() {
+			::dup2(_saved, STDOUT_FILENO);
+			::close(_saved);
+		}
+
+		SilenceStdout(const SilenceStdout&) = delete;
+		SilenceStdout& operator=(const SilenceStdout&) = delete;
+
+	private:
+		int _saved;
+	};
+#endif
+}
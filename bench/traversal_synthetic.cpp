@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <SyntheticFileSystem.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Время обхода синтетического дерева (мс); вывод списков идет в /dev/null
+	double TraversalMilliseconds(SyntheticFileSystem& fileSystem, unsigned threads, std::uint32_t& nodesFound) {
+#ifdef __linux__
+		bench::SilenceStdout silence;
+#endif
+		OutputWriter output;
+		NodeTable nodes;
+		ThreadPool pool(threads, std::chrono::milliseconds(0));
+		TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+		const auto start = std::chrono::steady_clock::now();
+		TraverseFileSystem(fileSystem, context);
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		nodesFound = nodes.Size();
+		return ms;
+	}
+
+	/// @brief Медиана нескольких обходов
+	double MedianMilliseconds(SyntheticFileSystem& fileSystem, unsigned threads, int runs, std::uint32_t& nodesFound) {
+		std::vector<double> samples;
+		for (int run = 0; run < runs; ++run)
+			samples.push_back(TraversalMilliseconds(fileSystem, threads, nodesFound));
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+
+	[[nodiscard]] std::uint64_t Entries(const SyntheticTreeSize& size) {
+		return size.directories + size.files;
+	}
+}
+
+TEST_CASE("Traversal throughput on synthetic trees from 10K to 10M entries", "[synthetic][report]") {
+	const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("\n%-28s %10s %10s %14s\n", "tree (depth/fanout/files)", "entries", "ms", "entries/s");
+	struct Shape { unsigned depth, fanout, files; };
+	for (const Shape shape : { Shape{ 3, 8, 16 }, Shape{ 4, 8, 20 }, Shape{ 5, 8, 26 }, Shape{ 6, 8, 32 } }) {
+		SyntheticTreeOptions options;
+		options.depth = shape.depth;
+		options.fanout = shape.fanout;
+		options.files = shape.files;
+		SyntheticFileSystem fileSystem(options);
+		const std::uint64_t expected = Entries(fileSystem.Size());
+		std::uint32_t nodes = 0;
+		// Большие деревья обходятся реже: один обход занимает секунды
+		const double ms = MedianMilliseconds(fileSystem, threads, expected > 1000000 ? 3 : 9, nodes);
+		char name[32];
+		std::snprintf(name, sizeof(name), "%u/%u/%u", shape.depth, shape.fanout, shape.files);
+		std::printf("%-28s %10llu %10.2f %14.0f\n", name, static_cast<unsigned long long>(expected), ms, expected / ms * 1000.0);
+		CHECK(nodes == expected);
+	}
+}
+
+TEST_CASE("Pool scaling on a synthetic tree with per-directory latency", "[synthetic][report]") {
+	// 4681 директория по 16 файлов; чтение директории блокирует поток на 200 мкс, как холодный диск
+	SyntheticTreeOptions options;
+	options.depth = 4;
+	options.fanout = 8;
+	options.files = 16;
+	options.directoryLatency = std::chrono::microseconds(200);
+	SyntheticFileSystem fileSystem(options);
+	const SyntheticTreeSize size = fileSystem.Size();
+	const double serialMs = static_cast<double>(size.directories) * 0.2;
+	std::printf("\n%zu directories x 200 us: %.1f ms of latency in total\n", static_cast<std::size_t>(size.directories), serialMs);
+	std::printf("%-10s %10s %10s\n", "threads", "ms", "speedup");
+	// Ускорение считается от обхода в одном вызывающем потоке: сон длиннее заказанного на запас таймера
+	double callerOnlyMs = 0;
+	for (unsigned threads : { 0u, 1u, 2u, 4u, 8u, 16u, 32u, 64u }) {
+		std::uint32_t nodes = 0;
+		const double ms = MedianMilliseconds(fileSystem, threads, 5, nodes);
+		if (threads == 0)
+			callerOnlyMs = ms;
+		std::printf("%-10u %10.2f %9.1fx\n", threads, ms, callerOnlyMs / ms);
+		CHECK(nodes == Entries(size));
+	}
+}
+
+TEST_CASE("Traversal of skewed synthetic trees with the same mean size", "[synthetic][report]") {
+	const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("\n%-8s %12s %12s %10s %14s\n", "skew", "directories", "entries", "ms", "entries/s");
+	for (const double skew : { 0.0, 0.3, 0.6, 0.8 }) {
+		SyntheticTreeOptions options;
+		options.depth = 5;
+		options.fanout = 6;
+		options.files = 24;
+		options.skew = skew;
+		options.entryLatency = std::chrono::nanoseconds(200);
+		SyntheticFileSystem fileSystem(options);
+		const SyntheticTreeSize size = fileSystem.Size();
+		std::uint32_t nodes = 0;
+		const double ms = MedianMilliseconds(fileSystem, threads, 5, nodes);
+		std::printf("%-8.1f %12llu %12llu %10.2f %14.0f\n", skew, static_cast<unsigned long long>(size.directories),
+			static_cast<unsigned long long>(Entries(size)), ms, Entries(size) / ms * 1000.0);
+		CHECK(nodes == Entries(size));
+	}
+}
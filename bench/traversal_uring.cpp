@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "traversal_support.hpp"
+
+#include <IoUring.hpp>
+#include <Traversal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+namespace {
+	/// @brief Медиана времени обхода и количество найденных узлов
+	double MedianMilliseconds(const std::filesystem::path& root, TraversalBackend backend, unsigned depth, std::uint32_t& nodesFound) {
+		std::vector<double> samples;
+		for (int run = 0; run < 7; ++run) {
+			bench::SilenceStdout silence;
+			OutputWriter output;
+			NodeTable nodes;
+			ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()), std::chrono::milliseconds(0));
+			TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+			context._queueDepth = depth;
+			const auto start = std::chrono::steady_clock::now();
+			TraverseDirectory(root, context, backend);
+			samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			nodesFound = nodes.Size();
+		}
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+}
+#endif
+
+TEST_CASE("Traversal throughput against io_uring queue depth", "[uring][report]") {
+#ifdef __linux__
+	// 64 директории по 256 файлов в два уровня
+	bench::TemporaryTree tree("directory_travers_bench_uring", 8, 8, 256);
+	std::uint32_t nodes = 0;
+	std::printf("\nio_uring available: %s (page cache is warm after the first run)\n", IoUringAvailable() ? "yes" : "no");
+	std::printf("%-10s %8s %10s %14s\n", "backend", "depth", "ms", "entries/s");
+
+	const double sync = MedianMilliseconds(tree.Root(), TraversalBackend::Getdents, 0, nodes);
+	std::printf("%-10s %8s %10.2f %14.0f\n", "getdents", "-", sync, nodes / sync * 1000.0);
+	// Глубина 0 - те же statx/openat синхронными вызовами: точка отсчета для кольца
+	for (unsigned depth : { 0u, 1u, 2u, 4u, 8u, 16u, 32u, 64u, 128u, 256u }) {
+		const double ms = MedianMilliseconds(tree.Root(), TraversalBackend::Uring, depth, nodes);
+		std::printf("%-10s %8u %10.2f %14.0f\n", "uring", depth, ms, nodes / ms * 1000.0);
+	}
+	CHECK(nodes > 16384);
+#else
+	WARN("io_uring backend exists on Linux only");
+#endif
+}
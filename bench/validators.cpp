@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <args_parse/argument.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace {
+	/// Набор типичных значений для числовых аргументов
+	constexpr std::string_view IntValues[] = { "0", "42", "-17", "65535", "2147483647", "-2147483648" };
+	constexpr std::string_view UnsignedValues[] = { "0", "1", "8", "64", "65535", "4294967295" };
+	constexpr std::string_view FloatValues[] = { "0", "0.5", "-3.25", "1e-3", "3.4028e38", "123456.789" };
+
+	/// @brief Прогон одного способа разбора по всему набору значений
+	template<typename T, std::size_t N, typename Parser>
+	T RunAll(const std::string_view (&values)[N], Parser parser) {
+		T sum{};
+		for (std::string_view value : values) {
+			sum += std::get<1>(parser(value));
+		}
+		return sum;
+	}
+}
+
+TEST_CASE("Numeric validators: from_chars vs istringstream", "[validator][bench]") {
+	BENCHMARK("int from_chars") {
+		return RunAll<int>(IntValues, args_parse::FromCharsValue<int>);
+	};
+	BENCHMARK("int istringstream") {
+		return RunAll<int>(IntValues, args_parse::StreamValue<int>);
+	};
+	BENCHMARK("unsigned int from_chars") {
+		return RunAll<unsigned int>(UnsignedValues, args_parse::FromCharsValue<unsigned int>);
+	};
+	BENCHMARK("unsigned int istringstream") {
+		return RunAll<unsigned int>(UnsignedValues, args_parse::StreamValue<unsigned int>);
+	};
+	BENCHMARK("float from_chars") {
+		return RunAll<float>(FloatValues, args_parse::FromCharsValue<float>);
+	};
+	BENCHMARK("float istringstream") {
+		return RunAll<float>(FloatValues, args_parse::StreamValue<float>);
+	};
+	BENCHMARK("double from_chars") {
+		return RunAll<double>(FloatValues, args_parse::FromCharsValue<double>);
+	};
+	BENCHMARK("double istringstream") {
+		return RunAll<double>(FloatValues, args_parse::StreamValue<double>);
+	};
+}
+
+TEST_CASE("Validator specializations", "[validator][bench]") {
+	const args_parse::Validator<int> intValidator;
+	const args_parse::Validator<unsigned int> unsignedValidator;
+	const args_parse::Validator<float> floatValidator;
+	const args_parse::Validator<double> doubleValidator;
+	const args_parse::Validator<bool> boolValidator;
+	const args_parse::Validator<std::chrono::milliseconds> durationValidator;
+	const args_parse::Validator<std::string> pathValidator;
+	const std::string directory = std::filesystem::temp_directory_path().string();
+
+	BENCHMARK("Validator<int>") { return intValidator.ValidValue("-2147483648"); };
+	BENCHMARK("Validator<unsigned int>") { return unsignedValidator.ValidValue("4294967295"); };
+	BENCHMARK("Validator<float>") { return floatValidator.ValidValue("3.4028e38"); };
+	BENCHMARK("Validator<double>") { return doubleValidator.ValidValue("123456.789"); };
+	BENCHMARK("Validator<bool> (istringstream)") { return boolValidator.ValidValue("1"); };
+	BENCHMARK("Validator<std::chrono::milliseconds>") { return durationValidator.ValidValue("1h1m1.5s"); };
+	BENCHMARK("Validator<std::string> (directory)") { return pathValidator.ValidValue(directory); };
+}
+
+TEST_CASE("Path validation with a shared status cache", "[validator][path][bench]") {
+	const std::filesystem::path root = std::filesystem::temp_directory_path();
+	// 1000 аргументов-путей: разные записи одной и той же директории ("/tmp", "/tmp/.", "/tmp//" ...)
+	std::vector<std::string> paths;
+	for (std::size_t i = 0; i < 1000; ++i)
+		paths.push_back((root / (i % 2 ? "." : "")).string() + std::string(i % 10, '/'));
+
+	args_parse::PathStatusCache cache;
+	const args_parse::Validator<std::string> cached(args_parse::DefaultPathPolicy, &cache);
+
+	BENCHMARK("1000 path arguments, cached") {
+		cache.Clear();
+		std::size_t valid = 0;
+		for (const auto& path : paths)
+			valid += std::get<0>(cached.ValidValue(path));
+		return valid;
+	};
+	BENCHMARK("1000 path arguments, std::filesystem exists/is_directory/directory_iterator") {
+		std::size_t valid = 0;
+		for (const auto& path : paths) {
+			const std::filesystem::path dirPath = path;
+			valid += std::filesystem::exists(dirPath) && std::filesystem::is_directory(dirPath)
+				&& std::filesystem::directory_iterator(dirPath) != std::filesystem::directory_iterator();
+		}
+		return valid;
+	};
+
+	cache.Clear();
+	const std::size_t before = cache.SystemCalls();
+	for (const auto& path : paths)
+		(void)cached.ValidValue(path);
+	std::printf("\n1000 path arguments validated with %zu system calls\n", cache.SystemCalls() - before);
+}
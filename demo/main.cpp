@@ -11,9 +11,11 @@ int main(int argc, const char** argv)
 	help.SetDescription("Outputs a description of all added command line arguments");
 	args_parse::Argument<bool> verbose('v', "verbose", false);
 	verbose.SetDescription("Outputs a verbose of all added command line arguments");
-	args_parse::Argument<std::string> input('i', "input", true, new args_parse::Validator<std::string>());
+	args_parse::Argument<std::string> input('i', "input", true,
+		new args_parse::Validator<std::string>(args_parse::PathPolicy::MustExist | args_parse::PathPolicy::Readable));
 	input.SetDescription("Input (filename)");
-	args_parse::Argument<std::string> output('o', "output", true, new args_parse::Validator<std::string>());
+	args_parse::Argument<std::string> output('o', "output", true,
+		new args_parse::Validator<std::string>(args_parse::PathPolicy::Writable));
 	output.SetDescription("Output (filename)");
 	args_parse::Argument<int> number('n', "number", true, new args_parse::Validator<int>());
 
@@ -22,7 +24,7 @@ int main(int argc, const char** argv)
 	args_parse::Argument<unsigned int> thread_pool('t', "thread-pool", true, new args_parse::Validator<unsigned int>());
 	thread_pool.SetDescription("Sets the number of threads (number)");
 	args_parse::Argument<std::chrono::milliseconds> debug_sleep('d', "debug-sleep", true, new args_parse::Validator<std::chrono::milliseconds>());
-	debug_sleep.SetDescription("Defines a user input of the argument type (ms/s)");
+	debug_sleep.SetDescription("Defines a user input of the argument type (ns/us/ms/s/m/h, e.g. 1.5s)");
 
 	parser.Add(&help);
 	parser.Add(&verbose);
@@ -33,7 +35,10 @@ int main(int argc, const char** argv)
 	parser.Add(&thread_pool);
 	parser.Add(&debug_sleep);
 
-	if (parser.Parse()) {
+	const args_parse::ParseResult result = parser.Parse();
+	// Все ошибки разбора выводятся одной записью
+	result.Render(std::cerr);
+	if (result) {
 		if (help.GetIsDefined()) {
 			parser.ShowHelp();
 		}
@@ -0,0 +1,238 @@
+#include "CpuTopology.hpp"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+	/// @brief Первая строка файла sysfs; пустая строка, если файл не читается
+	std::string ReadLine(const std::filesystem::path& file) {
+		std::ifstream input(file);
+		std::string line;
+		std::getline(input, line);
+		return line;
+	}
+
+	/// @brief Номер узла из имени "nodeN"; std::nullopt для других имен
+	std::optional<unsigned> NodeId(const std::string& name) {
+		constexpr std::string_view Prefix = "node";
+		if (name.size() <= Prefix.size() || name.compare(0, Prefix.size(), Prefix) != 0)
+			return std::nullopt;
+		unsigned id = 0;
+		const char* end = name.data() + name.size();
+		const auto [ptr, error] = std::from_chars(name.data() + Prefix.size(), end, id);
+		if (error != std::errc() || ptr != end)
+			return std::nullopt;
+		return id;
+	}
+
+	/// @brief Процессоры, на которых процессу разрешено выполняться; std::nullopt, если маска неизвестна
+	std::optional<std::vector<unsigned>> AllowedCpus() {
+#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) != 0)
+			return std::nullopt;
+		std::vector<unsigned> cpus;
+		for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+			if (CPU_ISSET(cpu, &set))
+				cpus.push_back(cpu);
+		}
+		return cpus;
+#else
+		return std::nullopt;
+#endif
+	}
+
+	/// @brief Пересечение отсортированных списков
+	std::vector<unsigned> Intersect(const std::vector<unsigned>& left, const std::vector<unsigned>& right) {
+		std::vector<unsigned> result;
+		std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result));
+		return result;
+	}
+
+	/// @brief Размещение с узлами топологии, перенумерованными подряд среди занятых потоками
+	WorkerPlacement Assemble(std::vector<int> cpus, const std::vector<std::size_t>& topologyNodes, std::size_t nodeTotal) {
+		std::vector<unsigned> index(nodeTotal, 0);
+		std::vector<bool> used(nodeTotal, false);
+		for (const std::size_t node : topologyNodes)
+			used[node] = true;
+		WorkerPlacement placement;
+		placement.nodeCount = 0;
+		for (std::size_t node = 0; node < nodeTotal; ++node) {
+			if (used[node])
+				index[node] = placement.nodeCount++;
+		}
+		placement.nodeCount = std::max(1u, placement.nodeCount);
+		placement.cpus = std::move(cpus);
+		placement.nodes.reserve(topologyNodes.size());
+		for (const std::size_t node : topologyNodes)
+			placement.nodes.push_back(index[node]);
+		return placement;
+	}
+}
+
+unsigned CpuTopology::CpuCount() const {
+	unsigned count = 0;
+	for (const NumaNode& node : nodes)
+		count += static_cast<unsigned>(node.cpus.size());
+	return count;
+}
+
+CpuTopology CpuTopology::Detect() {
+	const std::filesystem::path root = "/sys/devices/system";
+	std::vector<unsigned> online;
+	if (const auto parsed = ParseCpuList(ReadLine(root / "cpu" / "online")))
+		online = *parsed;
+	else {
+		for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+			online.push_back(cpu);
+	}
+	if (const auto allowed = AllowedCpus()) {
+		// Маска могла быть задана до отключения процессоров: пустое пересечение не оставляет процесс без процессоров
+		std::vector<unsigned> usable = Intersect(online, *allowed);
+		if (!usable.empty())
+			online = std::move(usable);
+	}
+
+	CpuTopology topology;
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(root / "node", error)) {
+		const std::optional<unsigned> id = NodeId(entry.path().filename().string());
+		if (!id)
+			continue;
+		const auto cpus = ParseCpuList(ReadLine(entry.path() / "cpulist"));
+		if (!cpus)
+			continue;
+		// Узлы только с памятью (без процессоров) в размещении не участвуют
+		NumaNode node{ *id, Intersect(*cpus, online) };
+		if (!node.cpus.empty())
+			topology.nodes.push_back(std::move(node));
+	}
+	std::sort(topology.nodes.begin(), topology.nodes.end(), [](const NumaNode& left, const NumaNode& right) { return left.id < right.id; });
+
+	// Процессоры вне перечисленных узлов (ядро без NUMA) собираются в узел 0
+	std::vector<unsigned> assigned;
+	for (const NumaNode& node : topology.nodes)
+		assigned.insert(assigned.end(), node.cpus.begin(), node.cpus.end());
+	std::sort(assigned.begin(), assigned.end());
+	std::vector<unsigned> rest;
+	std::set_difference(online.begin(), online.end(), assigned.begin(), assigned.end(), std::back_inserter(rest));
+	if (!rest.empty()) {
+		if (topology.nodes.empty())
+			topology.nodes.push_back({ 0, std::move(rest) });
+		else {
+			std::vector<unsigned>& first = topology.nodes.front().cpus;
+			first.insert(first.end(), rest.begin(), rest.end());
+			std::sort(first.begin(), first.end());
+		}
+	}
+	return topology;
+}
+
+std::optional<std::vector<unsigned>> ParseCpuList(std::string_view list) {
+	// Строка файла sysfs заканчивается переводом строки
+	while (!list.empty() && (list.back() == '\n' || list.back() == ' '))
+		list.remove_suffix(1);
+	if (list.empty())
+		return std::nullopt;
+	std::vector<unsigned> cpus;
+	const char* position = list.data();
+	const char* const end = list.data() + list.size();
+	while (true) {
+		unsigned first = 0;
+		auto parsed = std::from_chars(position, end, first);
+		if (parsed.ec != std::errc())
+			return std::nullopt;
+		unsigned last = first;
+		if (parsed.ptr != end && *parsed.ptr == '-') {
+			parsed = std::from_chars(parsed.ptr + 1, end, last);
+			if (parsed.ec != std::errc())
+				return std::nullopt;
+		}
+		if (last < first || last >= MaxCpu)
+			return std::nullopt;
+		for (unsigned cpu = first; cpu <= last; ++cpu)
+			cpus.push_back(cpu);
+		if (parsed.ptr == end)
+			break;
+		if (*parsed.ptr != ',')
+			return std::nullopt;
+		position = parsed.ptr + 1;
+	}
+	std::sort(cpus.begin(), cpus.end());
+	cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+	return cpus;
+}
+
+std::optional<AffinityPolicy> ParseAffinityPolicy(std::string_view name) {
+	if (name == "none")
+		return AffinityPolicy::None;
+	if (name == "compact")
+		return AffinityPolicy::Compact;
+	if (name == "spread")
+		return AffinityPolicy::Spread;
+	return std::nullopt;
+}
+
+WorkerPlacement PlanPlacement(const CpuTopology& topology, unsigned threads, AffinityPolicy policy) {
+	if (policy == AffinityPolicy::None || topology.nodes.empty() || threads == 0)
+		return {};
+	std::vector<int> cpus;
+	std::vector<std::size_t> nodes;
+	cpus.reserve(threads);
+	nodes.reserve(threads);
+	const std::size_t nodeTotal = topology.nodes.size();
+	if (policy == AffinityPolicy::Compact) {
+		const unsigned total = topology.CpuCount();
+		for (unsigned i = 0; i < threads; ++i) {
+			// Номер по сквозной нумерации процессоров всех узлов
+			unsigned slot = i % total;
+			std::size_t node = 0;
+			while (slot >= topology.nodes[node].cpus.size())
+				slot -= static_cast<unsigned>(topology.nodes[node++].cpus.size());
+			cpus.push_back(static_cast<int>(topology.nodes[node].cpus[slot]));
+			nodes.push_back(node);
+		}
+	}
+	else {
+		for (unsigned i = 0; i < threads; ++i) {
+			const std::size_t node = i % nodeTotal;
+			const std::vector<unsigned>& nodeCpus = topology.nodes[node].cpus;
+			cpus.push_back(static_cast<int>(nodeCpus[(i / nodeTotal) % nodeCpus.size()]));
+			nodes.push_back(node);
+		}
+	}
+	return Assemble(std::move(cpus), nodes, nodeTotal);
+}
+
+WorkerPlacement PlanPlacement(const CpuTopology& topology, unsigned threads, const std::vector<unsigned>& cpus) {
+	if (cpus.empty() || threads == 0)
+		return {};
+	std::vector<std::size_t> cpuNodes;
+	cpuNodes.reserve(cpus.size());
+	for (const unsigned cpu : cpus) {
+		const auto owner = std::find_if(topology.nodes.begin(), topology.nodes.end(),
+			[cpu](const NumaNode& node) { return std::binary_search(node.cpus.begin(), node.cpus.end(), cpu); });
+		if (owner == topology.nodes.end())
+			throw std::invalid_argument("CPU " + std::to_string(cpu) + " is not available to the process");
+		cpuNodes.push_back(static_cast<std::size_t>(owner - topology.nodes.begin()));
+	}
+	std::vector<int> workerCpus;
+	std::vector<std::size_t> nodes;
+	workerCpus.reserve(threads);
+	nodes.reserve(threads);
+	for (unsigned i = 0; i < threads; ++i) {
+		workerCpus.push_back(static_cast<int>(cpus[i % cpus.size()]));
+		nodes.push_back(cpuNodes[i % cpus.size()]);
+	}
+	return Assemble(std::move(workerCpus), nodes, topology.nodes.size());
+}
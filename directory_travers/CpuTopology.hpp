@@ -0,0 +1,65 @@
+#pragma once
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/// @brief Узел NUMA и его процессоры
+struct NumaNode {
+	/// Номер узла в /sys/devices/system/node
+	unsigned id = 0;
+	/// Номера процессоров по возрастанию
+	std::vector<unsigned> cpus;
+};
+
+/// @brief Процессоры, доступные процессу, сгруппированные по узлам NUMA
+struct CpuTopology {
+	/// Узлы с хотя бы одним доступным процессором, по возрастанию номера
+	std::vector<NumaNode> nodes;
+
+	///@brief Общее количество процессоров
+	[[nodiscard]] unsigned CpuCount() const;
+
+	///@brief Топология из /sys/devices/system/cpu/online и /sys/devices/system/node/node*/cpulist,
+	/// ограниченная маской процессоров процесса (taskset, cpuset контейнера).
+	/// Без sysfs (не Linux, sysfs не смонтирован) - один узел из hardware_concurrency процессоров.
+	[[nodiscard]] static CpuTopology Detect();
+};
+
+/// @brief Разбор списка процессоров в формате sysfs и taskset ("0-3,8,10-11").
+/// std::nullopt для пустого списка, обратного диапазона или номера не меньше MaxCpu
+[[nodiscard]] std::optional<std::vector<unsigned>> ParseCpuList(std::string_view list);
+
+/// @brief Наибольший поддерживаемый номер процессора (не включая)
+constexpr unsigned MaxCpu = 4096;
+
+/// @brief Размещение рабочих потоков по процессорам
+enum class AffinityPolicy {
+	/// Без закрепления: потоки переносит планировщик ОС, у пула одна общая очередь
+	None,
+	/// Подряд по процессорам узлов: сначала заполняется первый узел, затем следующий
+	Compact,
+	/// По очереди по узлам: соседние потоки на разных узлах, нагрузка и память делятся между узлами поровну
+	Spread,
+};
+
+/// @brief Разбор имени размещения ("none", "compact", "spread"); std::nullopt для неизвестного имени
+[[nodiscard]] std::optional<AffinityPolicy> ParseAffinityPolicy(std::string_view name);
+
+/// @brief Размещение рабочих потоков пула: процессор и узел каждого потока.
+/// Пустое размещение - без закрепления, все потоки на одном узле.
+struct WorkerPlacement {
+	/// Процессор рабочего потока i (-1 - без закрепления)
+	std::vector<int> cpus;
+	/// Узел рабочего потока i: индекс очереди пула от 0 до nodeCount - 1
+	std::vector<unsigned> nodes;
+	/// Количество узлов, на которых есть рабочие потоки
+	unsigned nodeCount = 1;
+};
+
+///@brief Размещение threads рабочих потоков по политике; при числе потоков больше числа процессоров
+/// процессоры используются по кругу. AffinityPolicy::None - пустое размещение
+[[nodiscard]] WorkerPlacement PlanPlacement(const CpuTopology& topology, unsigned threads, AffinityPolicy policy);
+
+///@brief Размещение threads рабочих потоков по явному списку процессоров (по кругу).
+/// Процессор, недоступный процессу, - std::invalid_argument
+[[nodiscard]] WorkerPlacement PlanPlacement(const CpuTopology& topology, unsigned threads, const std::vector<unsigned>& cpus);
@@ -0,0 +1,56 @@
+#pragma once
+#include <filesystem>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+struct Directory {
+	///id потока, обрабатывающего текущую директорию
+	std::thread::id _threadId;
+	
+	///Путь директории
+	std::filesystem::path _path;
+	
+	///Вектор всех файлов текущей директории
+	std::vector<std::filesystem::path> _filenames;
+	
+	///Вектор всех поддиректорий в директории
+	std::vector<Directory> _directories;
+
+	Directory(const std::filesystem::path path) : _path{ path } {}
+
+	///@brief Получение пути
+	[[nodiscard]] const std::filesystem::path& GetPath() const { return _path; }
+
+	///@brief Установка пути
+	void SetPath(const std::filesystem::path path) { _path = path; }
+
+	///@brief Добавление файла в вектор всех файлов
+	void AddFile(const std::filesystem::path& file)
+	{
+		_filenames.push_back(file);
+	}
+
+	///@brief Добавление файла в вектор всех директорий
+	void AddDirectory(const std::filesystem::path& file) {
+		_directories.push_back(Directory(file));
+	}
+};
+
+///@brief Перегрузка оператора вывода для класса Directory
+inline std::ostream& operator<<(std::ostream& os, const Directory& directory) {
+	// Выводим все поддиректории
+	for (const auto& subdir : directory._directories) {
+		os << "\t" << subdir.GetPath().string().substr(directory.GetPath().string().size()) <<
+			" (Thread ID: " << subdir._threadId << ")\n";
+		os << subdir;
+	}
+
+	// Выводим все файлы в текущей директории
+	for (const auto& file : directory._filenames) {
+		os << "\t\t" << file.string().substr(directory.GetPath().string().size()) <<
+			" (Thread ID: " << directory._threadId << ")\n";
+	}
+
+	return os;
+}
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "Duplicates.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <new>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	/// Выравнивание буфера чтения (страница)
+	constexpr std::size_t ReadAlignment = 4096;
+
+	/// @brief Буфер чтения потока, выровненный по странице
+	struct ReadBuffer {
+		ReadBuffer() : data(static_cast<unsigned char*>(::operator new(DuplicateFinder::ReadSize, std::align_val_t(ReadAlignment)))) {}
+		~ReadBuffer() { ::operator delete(data, std::align_val_t(ReadAlignment)); }
+
+		ReadBuffer(const ReadBuffer&) = delete;
+		ReadBuffer& operator=(const ReadBuffer&) = delete;
+
+		unsigned char* data;
+	};
+
+	/// @brief Файл, читаемый по смещениям
+	class InputFile {
+	public:
+		InputFile(const std::string& path, bool sequential) {
+#ifdef _WIN32
+			(void)sequential;
+			_stream.open(path, std::ios::binary);
+#else
+			_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#ifdef POSIX_FADV_SEQUENTIAL
+			// Файл читается целиком: ядро может читать вперед более крупными порциями
+			if (_fd >= 0 && sequential)
+				::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+			(void)sequential;
+#endif
+#endif
+		}
+		~InputFile() {
+#ifndef _WIN32
+			if (_fd >= 0)
+				::close(_fd);
+#endif
+		}
+
+		InputFile(const InputFile&) = delete;
+		InputFile& operator=(const InputFile&) = delete;
+
+		[[nodiscard]] bool IsOpen() const {
+#ifdef _WIN32
+			return _stream.is_open();
+#else
+			return _fd >= 0;
+#endif
+		}
+
+		///@brief Чтение ровно size байтов с offset; false при ошибке или конце файла
+		[[nodiscard]] bool ReadAt(std::uint64_t offset, unsigned char* buffer, std::size_t size) {
+#ifdef _WIN32
+			_stream.seekg(static_cast<std::streamoff>(offset));
+			return static_cast<bool>(_stream.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size)));
+#else
+			while (size > 0) {
+				const ssize_t read = ::pread(_fd, buffer, size, static_cast<off_t>(offset));
+				if (read < 0 && errno == EINTR)
+					continue;
+				if (read <= 0)
+					return false;
+				buffer += read;
+				offset += static_cast<std::uint64_t>(read);
+				size -= static_cast<std::size_t>(read);
+			}
+			return true;
+#endif
+		}
+
+	private:
+#ifdef _WIN32
+		std::ifstream _stream;
+#else
+		int _fd = -1;
+#endif
+	};
+}
+
+DuplicateFinder::DuplicateFinder(std::size_t budget) : _budget(budget) {}
+
+DuplicateFinder::~DuplicateFinder() = default;
+
+std::vector<DuplicateFinder::Seen>& DuplicateFinder::Local() {
+	return _threadLocals.Local<std::vector<Seen>>([this] {
+		std::lock_guard<std::mutex> lock(_localsMutex);
+		_locals.push_back(std::make_unique<std::vector<Seen>>());
+		return _locals.back().get();
+	});
+}
+
+void DuplicateFinder::AddListing(std::uint32_t first, const std::vector<NodeTable::Entry>& entries) {
+	std::vector<Seen>* local = nullptr;
+	for (std::uint32_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].type != NodeType::File || entries[i].size == 0)
+			continue;
+		if (local == nullptr)
+			local = &Local();
+		local->push_back({ first + i, entries[i].size });
+	}
+}
+
+std::size_t DuplicateFinder::PeakInFlight() const {
+	std::lock_guard<std::mutex> lock(_budgetMutex);
+	return _peakInFlight;
+}
+
+void DuplicateFinder::AcquireBudget(std::size_t bytes) {
+	std::unique_lock<std::mutex> lock(_budgetMutex);
+	// Чтение больше всего лимита допускается, когда других чтений нет
+	_budgetCV.wait(lock, [this, bytes] { return _inFlight == 0 || _inFlight + bytes <= _budget; });
+	_inFlight += bytes;
+	_peakInFlight = std::max(_peakInFlight, _inFlight);
+}
+
+void DuplicateFinder::ReleaseBudget(std::size_t bytes) {
+	{
+		std::lock_guard<std::mutex> lock(_budgetMutex);
+		_inFlight -= bytes;
+	}
+	_budgetCV.notify_all();
+}
+
+bool DuplicateFinder::HashRange(const std::string& path, std::uint64_t offset, std::uint64_t length, std::uint64_t& hash) {
+	thread_local ReadBuffer buffer;
+	InputFile file(path, length > ReadSize);
+	if (!file.IsOpen())
+		return false;
+	StreamHash hasher;
+	for (std::uint64_t done = 0; done < length;) {
+		const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(ReadSize, length - done));
+		AcquireBudget(chunk);
+		const bool read = file.ReadAt(offset + done, buffer.data, chunk);
+		ReleaseBudget(chunk);
+		// Файл стал короче после обхода: сравнивать нечего
+		if (!read)
+			return false;
+		_bytesRead.fetch_add(chunk, std::memory_order_relaxed);
+		hasher.Update(buffer.data, chunk);
+		done += chunk;
+	}
+	hash = hasher.Digest();
+	return true;
+}
+
+namespace {
+	/// @brief Оставить только группы из двух и более кандидатов с одинаковыми размером и хэшем
+	template<typename Candidate>
+	void KeepGroups(std::vector<Candidate>& candidates) {
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+			[](const Candidate& candidate) { return !candidate.readable; }), candidates.end());
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+			if (lhs.size != rhs.size)
+				return lhs.size < rhs.size;
+			if (lhs.hash != rhs.hash)
+				return lhs.hash < rhs.hash;
+			return lhs.node < rhs.node;
+		});
+		std::size_t kept = 0;
+		for (std::size_t begin = 0; begin < candidates.size();) {
+			std::size_t end = begin + 1;
+			while (end < candidates.size() && candidates[end].size == candidates[begin].size && candidates[end].hash == candidates[begin].hash)
+				++end;
+			if (end - begin >= 2) {
+				for (std::size_t i = begin; i < end; ++i)
+					candidates[kept++] = candidates[i];
+			}
+			begin = end;
+		}
+		candidates.resize(kept);
+	}
+}
+
+void DuplicateFinder::RunStage(Stage stage, std::vector<Candidate>& candidates, ThreadPool& pool, const NodeTable& nodes) {
+	for (Candidate& candidate : candidates) {
+		std::uint64_t offset = 0;
+		std::uint64_t length = 0;
+		switch (stage) {
+		case Stage::Head:
+			length = std::min<std::uint64_t>(candidate.size, ProbeSize);
+			break;
+		case Stage::Tail:
+			// Файл не длиннее начала уже прочитан целиком
+			if (candidate.size <= ProbeSize)
+				continue;
+			offset = candidate.size - ProbeSize;
+			length = ProbeSize;
+			break;
+		case Stage::Full:
+			// Начало и конец уже покрыли весь файл
+			if (candidate.size <= 2 * ProbeSize)
+				continue;
+			length = candidate.size;
+			break;
+		}
+		// Каждая задача пишет только в своего кандидата; вектор не меняется до конца этапа
+		pool.EnqueueTask([this, &candidate, &nodes, offset, length]() {
+			thread_local std::string path;
+			path.clear();
+			nodes.AppendPath(path, candidate.node);
+			std::uint64_t hash = 0;
+			if (HashRange(path, offset, length, hash))
+				candidate.hash = Hash64(&hash, sizeof(hash), candidate.hash);
+			else
+				candidate.readable = false;
+		});
+	}
+	pool.Wait();
+}
+
+std::vector<DuplicateGroup> DuplicateFinder::Find(ThreadPool& pool, const NodeTable& nodes) {
+	std::vector<Candidate> candidates;
+	{
+		std::lock_guard<std::mutex> lock(_localsMutex);
+		for (const auto& local : _locals) {
+			for (const Seen& seen : *local)
+				candidates.push_back({ seen.node, true, seen.size, 0 });
+		}
+	}
+	// Размер, начало, конец, все содержимое: каждый этап читает только то, что пережило предыдущий
+	KeepGroups(candidates);
+	for (const Stage stage : { Stage::Head, Stage::Tail, Stage::Full }) {
+		RunStage(stage, candidates, pool, nodes);
+		KeepGroups(candidates);
+	}
+
+	std::vector<DuplicateGroup> groups;
+	for (std::size_t i = 0; i < candidates.size(); ++i) {
+		if (i == 0 || candidates[i].size != candidates[i - 1].size || candidates[i].hash != candidates[i - 1].hash)
+			groups.push_back({ candidates[i].size, {} });
+		groups.back().nodes.push_back(candidates[i].node);
+	}
+	std::sort(groups.begin(), groups.end(), [](const DuplicateGroup& lhs, const DuplicateGroup& rhs) {
+		const std::uint64_t lhsWaste = lhs.size * (lhs.nodes.size() - 1);
+		const std::uint64_t rhsWaste = rhs.size * (rhs.nodes.size() - 1);
+		if (lhsWaste != rhsWaste)
+			return lhsWaste > rhsWaste;
+		if (lhs.size != rhs.size)
+			return lhs.size > rhs.size;
+		return lhs.nodes.front() < rhs.nodes.front();
+	});
+	return groups;
+}
+
+std::string DuplicateFinder::Report(const std::vector<DuplicateGroup>& groups, const NodeTable& nodes) {
+	std::string out;
+	std::vector<std::string> paths;
+	for (const DuplicateGroup& group : groups) {
+		if (!out.empty())
+			out += '\n';
+		out += std::to_string(group.size);
+		out += " bytes x ";
+		out += std::to_string(group.nodes.size());
+		out += '\n';
+		// Пути внутри группы по алфавиту, чтобы отчет не зависел от порядка обхода
+		paths.assign(group.nodes.size(), std::string());
+		for (std::size_t i = 0; i < group.nodes.size(); ++i)
+			nodes.AppendPath(paths[i], group.nodes[i]);
+		std::sort(paths.begin(), paths.end());
+		for (const std::string& path : paths) {
+			out += '\t';
+			out += path;
+			out += '\n';
+		}
+	}
+	return out;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "NodeTable.hpp"
+#include "ThreadLocals.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief Группа файлов с одинаковым содержимым
+struct DuplicateGroup {
+	std::uint64_t size = 0;
+	/// Узлы файлов в таблице
+	std::vector<std::uint32_t> nodes;
+};
+
+/// @brief Поиск файлов с одинаковым содержимым.
+/// Во время обхода файлы запоминаются вместе с размером в списке потока без синхронизации.
+/// После обхода кандидаты с совпавшим размером отсеиваются по этапам: хэш первых 4 КиБ,
+/// хэш последних 4 КиБ, хэш всего файла; после каждого этапа остаются только группы из двух и более файлов,
+/// поэтому целиком читаются лишь файлы, совпавшие по размеру, началу и концу.
+/// Хэши считаются задачами того же пула; объем данных, читаемых одновременно, ограничен.
+/// Пустые файлы не рассматриваются.
+class DuplicateFinder {
+public:
+	/// Размер начала и конца файла, хэшируемых до чтения целиком
+	static constexpr std::size_t ProbeSize = 4 * 1024;
+	/// Размер одного чтения при хэшировании всего файла
+	static constexpr std::size_t ReadSize = 1024 * 1024;
+	/// Лимит одновременно читаемых байтов по умолчанию
+	static constexpr std::size_t DefaultBudget = 64 * 1024 * 1024;
+
+	explicit DuplicateFinder(std::size_t budget = DefaultBudget);
+	~DuplicateFinder();
+
+	DuplicateFinder(const DuplicateFinder&) = delete;
+	DuplicateFinder& operator=(const DuplicateFinder&) = delete;
+
+	///@brief Учет файлов директории [first, first + entries.size()); размеры должны быть получены обходом
+	void AddListing(std::uint32_t first, const std::vector<NodeTable::Entry>& entries);
+
+	///@brief Поиск групп после обхода; вызывается из потока вне пула.
+	/// Группы упорядочены по убыванию лишнего места (размер * (количество - 1)).
+	[[nodiscard]] std::vector<DuplicateGroup> Find(ThreadPool& pool, const NodeTable& nodes);
+
+	///@brief Текст отчета: строка "размер x количество", затем пути файлов группы
+	[[nodiscard]] static std::string Report(const std::vector<DuplicateGroup>& groups, const NodeTable& nodes);
+
+	///@brief Прочитано байтов во время Find
+	[[nodiscard]] std::uint64_t BytesRead() const { return _bytesRead.load(std::memory_order_relaxed); }
+
+	///@brief Наибольший объем одновременно читаемых данных во время Find
+	[[nodiscard]] std::size_t PeakInFlight() const;
+
+private:
+	/// @brief Файл, учтенный при обходе
+	struct Seen {
+		std::uint32_t node;
+		std::uint64_t size;
+	};
+
+	/// @brief Кандидат в дубликаты и хэш прочитанных частей
+	struct Candidate {
+		std::uint32_t node;
+		bool readable;
+		std::uint64_t size;
+		std::uint64_t hash;
+	};
+
+	/// @brief Этап сравнения
+	enum class Stage { Head, Tail, Full };
+
+	//@brief Список текущего потока (создается при первом обращении)
+	[[nodiscard]] std::vector<Seen>& Local();
+
+	//@brief Хэширование нужной этапу части всех кандидатов задачами пула
+	void RunStage(Stage stage, std::vector<Candidate>& candidates, ThreadPool& pool, const NodeTable& nodes);
+
+	//@brief Хэш части файла [offset, offset + length); false при ошибке чтения
+	bool HashRange(const std::string& path, std::uint64_t offset, std::uint64_t length, std::uint64_t& hash);
+
+	//@brief Резервирование и возврат места в лимите одновременно читаемых байтов
+	void AcquireBudget(std::size_t bytes);
+	void ReleaseBudget(std::size_t bytes);
+
+	///Списки потоков
+	std::vector<std::unique_ptr<std::vector<Seen>>> _locals;
+	std::mutex _localsMutex;
+	///Поиск списка текущего потока
+	ThreadLocals _threadLocals;
+
+	///Лимит одновременно читаемых байтов, занятый объем и его максимум
+	const std::size_t _budget;
+	std::size_t _inFlight = 0;
+	std::size_t _peakInFlight = 0;
+	mutable std::mutex _budgetMutex;
+	std::condition_variable _budgetCV;
+
+	std::atomic<std::uint64_t> _bytesRead{ 0 };
+};
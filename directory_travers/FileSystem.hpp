@@ -0,0 +1,27 @@
+#pragma once
+#include "NodeTable.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Файловая система, по которой идет обход через TraverseFileSystem.
+/// Директории адресуются непрозрачными дескрипторами, которые выдает сама файловая система;
+/// ReadDirectory вызывается из нескольких потоков одновременно, каждая директория читается один раз.
+class FileSystem {
+public:
+	/// Дескриптор директории
+	using Handle = std::uint64_t;
+
+	virtual ~FileSystem() = default;
+
+	///@brief Дескриптор корня обхода
+	[[nodiscard]] virtual Handle Root() const = 0;
+
+	///@brief Путь корня для вывода
+	[[nodiscard]] virtual std::string RootPath() const = 0;
+
+	///@brief Чтение директории: записи добавляются в конец entries (имена - в арену потока таблицы nodes),
+	/// дескрипторы поддиректорий - в конец children в порядке их записей.
+	/// false, если директорию не удалось прочитать (entries и children не изменены).
+	virtual bool ReadDirectory(Handle directory, NodeTable& nodes, std::vector<NodeTable::Entry>& entries, std::vector<Handle>& children) = 0;
+};
@@ -0,0 +1,603 @@
+#ifdef __linux__
+#include "Traversal.hpp"
+#include "IoUring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+namespace {
+	/// Размер буфера getdents64: за один вызов читается несколько сотен записей
+	constexpr std::size_t DirentBufferSize = 64 * 1024;
+
+	/// @brief Запись, возвращаемая getdents64 (в glibc нет объявления этой структуры)
+	struct LinuxDirent64 {
+		std::uint64_t d_ino;
+		std::int64_t d_off;
+		unsigned short d_reclen;
+		unsigned char d_type;
+		char d_name[1];
+	};
+
+	/// Дескрипторы директорий, живущие дольше своей задачи: открытые заранее пакетом io_uring и дескрипторы
+	/// родителей, удерживаемые задачами поддиректорий в очереди (ограничены половиной RLIMIT_NOFILE)
+	std::atomic<long> g_heldFds{ 0 };
+
+	/// Сколько дескрипторов директорий можно удерживать
+	std::atomic<long> g_heldFdLimit{ 512 };
+
+	/// @brief Лимит удерживаемых дескрипторов по текущему RLIMIT_NOFILE.
+	/// Читается в начале каждого обхода: процесс мог изменить лимит после предыдущего
+	void UpdateHeldFdLimit() {
+		struct rlimit files {};
+		const long limit = ::getrlimit(RLIMIT_NOFILE, &files) != 0 || files.rlim_cur == RLIM_INFINITY
+			? 512L : static_cast<long>(files.rlim_cur / 2);
+		g_heldFdLimit.store(limit, std::memory_order_relaxed);
+	}
+
+	/// @brief Место для еще одного удерживаемого дескриптора; false - лимит исчерпан
+	bool ReserveHeldFd() {
+		if (g_heldFds.fetch_add(1, std::memory_order_relaxed) < g_heldFdLimit.load(std::memory_order_relaxed))
+			return true;
+		g_heldFds.fetch_sub(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	/// @brief Дескриптор открытой директории.
+	/// Разделяется задачами поддиректорий и закрывается, когда последняя из них откроет свою директорию.
+	struct DirectoryFd {
+		/// held - место в лимите уже занято (дескриптор открыт заранее)
+		explicit DirectoryFd(int fd, bool held = false) : _fd(fd), _held(held) {}
+		~DirectoryFd() {
+			::close(_fd);
+			if (_held)
+				g_heldFds.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		DirectoryFd(const DirectoryFd&) = delete;
+		DirectoryFd& operator=(const DirectoryFd&) = delete;
+
+		/// @brief Занять место в лимите, чтобы удерживать дескриптор для задач поддиректорий
+		bool Hold() {
+			if (!_held)
+				_held = ReserveHeldFd();
+			return _held;
+		}
+
+		int _fd;
+		bool _held;
+	};
+
+	enum class EntryKind { File, Directory, Other };
+
+	/// @brief Тип записи по d_type; fstatat вызывается только если файловая система вернула DT_UNKNOWN.
+	/// Символические ссылки не раскрываются.
+	EntryKind Classify(int directoryFd, const LinuxDirent64& entry) {
+		switch (entry.d_type) {
+		case DT_REG: return EntryKind::File;
+		case DT_DIR: return EntryKind::Directory;
+		case DT_UNKNOWN: {
+			struct stat info {};
+			if (::fstatat(directoryFd, entry.d_name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+				return EntryKind::Other;
+			if (S_ISREG(info.st_mode)) return EntryKind::File;
+			if (S_ISDIR(info.st_mode)) return EntryKind::Directory;
+			return EntryKind::Other;
+		}
+		default: return EntryKind::Other;
+		}
+	}
+
+	/// @brief Пропуск записей "." и ".."
+	bool IsDotEntry(const char* name) {
+		return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+	}
+
+	/// @brief Имя узла с завершающим нулем для системных вызовов; false - имя длиннее NAME_MAX
+	/// (такого не дает getdents, но имя могло прийти из снимка)
+	[[nodiscard]] bool TerminatedName(const NodeTable& nodes, const NameRef& ref, char (&name)[NAME_MAX + 1]) {
+		const std::string_view stored = nodes.Name(ref);
+		if (stored.size() > NAME_MAX)
+			return false;
+		std::memcpy(name, stored.data(), stored.size());
+		name[stored.size()] = '\0';
+		return true;
+	}
+
+	/// @brief Удерживать ли дескриптор директории node для задач ее поддиректорий.
+	/// Без места в лимите (широкое дерево в очереди --schedule=bfs) поддиректории открываются по полному пути,
+	/// кроме путей, которые могут не уместиться в PATH_MAX: их родитель удерживается сверх лимита
+	bool HoldForSubdirectories(const TraversalContext& context, DirectoryFd& self, std::uint32_t node) {
+		if (self.Hold())
+			return true;
+		thread_local std::string path;
+		path.clear();
+		context._nodes.AppendPath(path, node);
+		return path.size() + 1 + NAME_MAX >= PATH_MAX;
+	}
+
+	/// @brief Поддиректория для *at-вызовов: имя относительно удержанного дескриптора родителя
+	/// или, если родитель не удержан, полный путь из таблицы узлов
+	class SubdirectoryName {
+	public:
+		SubdirectoryName(const TraversalContext& context, const DirectoryFd* parent, std::uint32_t child) {
+			const Node* stored = parent != nullptr ? &context._nodes[child] : nullptr;
+			if (stored != nullptr && TerminatedName(context._nodes, NameRef{ stored->arena, stored->nameOffset, stored->nameLength }, _name))
+				_base = parent->_fd;
+			else {
+				// Слишком длинное имя тоже идет полным путем: openat сообщит ENAMETOOLONG
+				context._nodes.AppendPath(_path, child);
+			}
+		}
+
+		[[nodiscard]] int Base() const { return _base; }
+		[[nodiscard]] const char* Name() const { return _path.empty() ? _name : _path.c_str(); }
+
+	private:
+		int _base = AT_FDCWD;
+		char _name[NAME_MAX + 1] = {};
+		std::string _path;
+	};
+
+	/// @brief Открытие поддиректории child; неудача сообщается (ReportOpenFailure), возвращается -1
+	int OpenSubdirectory(TraversalContext& context, const SubdirectoryName& name, std::uint32_t child) {
+		StatScope opening(context._stats, StatTimer::DirectoryOpen);
+		const int fd = ::openat(name.Base(), name.Name(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+		opening.Stop();
+		if (fd < 0)
+			ReportOpenFailure(context, child, errno);
+		return fd;
+	}
+
+	DirectoryStamp StampOf(const struct stat& info) {
+		DirectoryStamp stamp;
+		stamp.device = static_cast<std::uint64_t>(info.st_dev);
+		stamp.inode = static_cast<std::uint64_t>(info.st_ino);
+		stamp.mtime = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+		stamp.ctime = static_cast<std::int64_t>(info.st_ctim.tv_sec) * 1000000000 + info.st_ctim.tv_nsec;
+		return stamp;
+	}
+
+	/// @brief Отметка из statx; устройство кодируется так же, как st_dev у stat
+	DirectoryStamp StampOf(const struct statx& info) {
+		DirectoryStamp stamp;
+		stamp.device = static_cast<std::uint64_t>(makedev(info.stx_dev_major, info.stx_dev_minor));
+		stamp.inode = info.stx_ino;
+		stamp.mtime = static_cast<std::int64_t>(info.stx_mtime.tv_sec) * 1000000000 + info.stx_mtime.tv_nsec;
+		stamp.ctime = static_cast<std::int64_t>(info.stx_ctime.tv_sec) * 1000000000 + info.stx_ctime.tv_nsec;
+		return stamp;
+	}
+
+	/// @brief Нужны ли отметки директорий (читается или пишется снимок, устройство и inode нужны context._visited)
+	bool UsesStamps(const TraversalContext& context) {
+		return context._previous != nullptr || context._snapshot != nullptr || context._visited != nullptr;
+	}
+
+	/// @brief Директория уже прочитана по другому пути (bind mount): учитывается пустым списком
+	bool SkipRevisited(TraversalContext& context, std::uint32_t node, const DirectoryStamp* stamp) {
+		if (stamp == nullptr || FirstVisit(context, stamp->device, stamp->inode))
+			return false;
+		FinishDirectory(context, node, 0, {});
+		return true;
+	}
+
+	/// @brief Размер файла для сводки: 0, если у файла несколько жестких ссылок и он уже учтен по другой
+	std::uint64_t CountedSize(const TraversalContext& context, const struct stat& info) {
+		if (info.st_nlink > 1 && !FirstVisit(context, static_cast<std::uint64_t>(info.st_dev), static_cast<std::uint64_t>(info.st_ino)))
+			return 0;
+		return static_cast<std::uint64_t>(info.st_size);
+	}
+
+	std::uint64_t CountedSize(const TraversalContext& context, const struct statx& info) {
+		if (info.stx_nlink > 1 && !FirstVisit(context, static_cast<std::uint64_t>(makedev(info.stx_dev_major, info.stx_dev_minor)), info.stx_ino))
+			return 0;
+		return info.stx_size;
+	}
+
+	/// @brief Директория из предыдущего снимка с той же отметкой (nullptr - читать заново)
+	const snapshot::Directory* FindUnchanged(TraversalContext& context, std::uint32_t node, const DirectoryStamp& stamp) {
+		return context._previous != nullptr ? context._previous->Find(PathHash(context._nodes, node), stamp) : nullptr;
+	}
+
+	/// @brief Неизменная директория без поддиректорий: список берется из снимка без открытия директории
+	void ReuseLeaf(std::uint32_t node, TraversalContext& context, const snapshot::Directory& cached, const DirectoryStamp& stamp) {
+		if (SkipRevisited(context, node, &stamp))
+			return;
+		thread_local std::vector<NodeTable::Entry> entries;
+		entries.clear();
+		StatScope reading(context._stats, StatTimer::DirectoryRead);
+		context._previous->Load(cached, context._nodes, entries);
+		reading.Stop();
+		const std::uint32_t first = context._nodes.Append(node, entries);
+		if (context._snapshot != nullptr)
+			context._snapshot->Record(node, first, static_cast<std::uint32_t>(entries.size()), stamp, true);
+		FinishDirectory(context, node, first, entries);
+	}
+
+	/// @brief Можно ли не открывать директорию: список в снимке, поддиректорий нет, метаданные файлов не нужны
+	bool CanReuseWithoutOpening(const TraversalContext& context, const snapshot::Directory* cached) {
+		return cached != nullptr && cached->subdirectories == 0 && !WantsFileMetadata(context);
+	}
+
+	/// @brief Буферы обхода через getdents64
+	struct ScanBuffers {
+		std::vector<char> buffer = std::vector<char>(DirentBufferSize);
+		std::vector<NodeTable::Entry> entries;
+	};
+
+	void ScanDirectory(std::shared_ptr<DirectoryFd> self, std::uint32_t node, TraversalContext& context,
+		const DirectoryStamp* stamp = nullptr, const snapshot::Directory* cached = nullptr) {
+		if (SkipRevisited(context, node, stamp))
+			return;
+		// Буферы своего потока переиспользуются всеми директориями, которые он обходит
+		LocalBuffers<ScanBuffers> buffers;
+		std::vector<char>& buffer = buffers->buffer;
+		std::vector<NodeTable::Entry>& entries = buffers->entries;
+		entries.clear();
+		const bool metadata = WantsFileMetadata(context);
+		const bool directoryMetadata = WantsDirectoryMetadata(context);
+
+		StatScope reading(context._stats, StatTimer::DirectoryRead);
+		if (cached != nullptr) {
+			// Директория не изменилась: getdents не нужен, размеры и mtime запрашиваются заново
+			context._previous->Load(*cached, context._nodes, entries);
+			for (NodeTable::Entry& stored : entries) {
+				char name[NAME_MAX + 1];
+				struct stat info {};
+				const bool file = stored.type == NodeType::File;
+				if (file ? !metadata : !directoryMetadata)
+					continue;
+				if (TerminatedName(context._nodes, stored.name, name) && ::fstatat(self->_fd, name, &info, AT_SYMLINK_NOFOLLOW) == 0) {
+					if (file)
+						stored.size = CountedSize(context, info);
+					stored.mtime = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+				}
+			}
+		}
+		// Неполный список не попадает в снимок, иначе следующий обход взял бы его как неизменный
+		bool complete = true;
+		while (cached == nullptr) {
+			const long read = ::syscall(SYS_getdents64, self->_fd, buffer.data(), buffer.size());
+			if (read < 0) {
+				// Ошибка чтения (EIO, ENOENT у удаленной директории) - не конец списка
+				ReportReadFailure(context, node, errno);
+				complete = false;
+			}
+			if (read <= 0)
+				break;
+			for (long offset = 0; offset < read;) {
+				const auto& entry = *reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+				offset += entry.d_reclen;
+				if (IsDotEntry(entry.d_name))
+					continue;
+
+				const EntryKind kind = Classify(self->_fd, entry);
+				if (kind == EntryKind::Other)
+					continue;
+				// В таблицу попадает только имя записи, полный путь не строится
+				NodeTable::Entry stored{ kind == EntryKind::File ? NodeType::File : NodeType::Directory,
+					context._nodes.StoreName(entry.d_name), 0 };
+				// Размер и mtime файла (mtime поддиректории) берутся одним fstatat, только если они нужны
+				struct stat info {};
+				const bool file = kind == EntryKind::File;
+				if ((file ? metadata : directoryMetadata) && ::fstatat(self->_fd, entry.d_name, &info, AT_SYMLINK_NOFOLLOW) == 0) {
+					if (file)
+						stored.size = CountedSize(context, info);
+					stored.mtime = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+				}
+				entries.push_back(stored);
+			}
+		}
+		reading.Stop();
+		const std::uint32_t first = context._nodes.Append(node, entries);
+		if (stamp != nullptr && complete && context._snapshot != nullptr)
+			context._snapshot->Record(node, first, static_cast<std::uint32_t>(entries.size()), *stamp, cached != nullptr);
+		// Вывод информации о директории (или учет в сводке) до постановки задач поддиректорий
+		FinishDirectory(context, node, first, entries);
+
+		// Дескриптор удерживается задачами поддиректорий, только пока есть место в лимите
+		std::shared_ptr<DirectoryFd> parent;
+		bool decided = false;
+		for (std::uint32_t i = 0; i < entries.size(); ++i) {
+			if (entries[i].type != NodeType::Directory)
+				continue;
+			// Если это поддиректория
+			if (context._debugSleep.count() > 0) {
+				std::this_thread::sleep_for(context._debugSleep);
+			}
+			if (!decided) {
+				decided = true;
+				if (HoldForSubdirectories(context, *self, node))
+					parent = self;
+			}
+			// Поддиректория открывается относительно дескриптора родителя или по полному пути
+			DispatchSubdirectory(context, [&context, parent, child = first + i]() mutable {
+				const SubdirectoryName name(context, parent.get(), child);
+				// Отметка снимается до открытия: по ней решается, нужно ли читать директорию
+				DirectoryStamp stamp;
+				const snapshot::Directory* cached = nullptr;
+				struct stat info {};
+				const bool stamped = UsesStamps(context)
+					&& ::fstatat(name.Base(), name.Name(), &info, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(info.st_mode);
+				if (stamped) {
+					stamp = StampOf(info);
+					cached = FindUnchanged(context, child, stamp);
+				}
+				if (CanReuseWithoutOpening(context, cached)) {
+					parent.reset();
+					ReuseLeaf(child, context, *cached, stamp);
+					return;
+				}
+				const int fd = OpenSubdirectory(context, name, child);
+				parent.reset();
+				// Директорию, которую не удалось открыть, пропускаем (пустым списком)
+				if (fd < 0) {
+					FinishDirectory(context, child, 0, {});
+					return;
+				}
+				ScanDirectory(std::make_shared<DirectoryFd>(fd), child, context, stamped ? &stamp : nullptr, cached);
+			});
+		}
+		// Дескриптор больше не нужен этой задаче; удержанный закроется после открытия всех поддиректорий
+		self.reset();
+	}
+
+	/// @brief Пакет метаданных текущего потока с нужной глубиной очереди
+	MetadataBatch& LocalBatch(unsigned depth) {
+		thread_local std::unique_ptr<MetadataBatch> batch;
+		thread_local unsigned batchDepth = 0;
+		if (!batch || batchDepth != depth) {
+			batch = std::make_unique<MetadataBatch>(depth);
+			batchDepth = depth;
+		}
+		return *batch;
+	}
+
+	/// @brief Буферы обхода через io_uring
+	struct UringBuffers {
+		std::vector<char> buffer = std::vector<char>(DirentBufferSize);
+		std::vector<NodeTable::Entry> entries;
+		std::vector<const char*> names;
+		std::vector<struct statx> stats;
+		std::vector<int> results;
+		/// Отметки поддиректорий в порядке их записей: statx списка уже содержит их
+		std::vector<DirectoryStamp> childStamps;
+		std::vector<char> childStamped;
+		std::vector<std::string> cachedNames;
+		/// Имена поддиректорий, их записи в снимке, дескрипторы открытых заранее
+		std::vector<std::string> subdirectories;
+		std::vector<const snapshot::Directory*> unchanged;
+		std::vector<int> opened;
+		std::vector<char> requested;
+	};
+
+	void ScanDirectoryUring(std::shared_ptr<DirectoryFd> self, std::uint32_t node, TraversalContext& context,
+		const DirectoryStamp* stamp = nullptr, const snapshot::Directory* cached = nullptr) {
+		if (SkipRevisited(context, node, stamp))
+			return;
+		MetadataBatch& batch = LocalBatch(context._queueDepth);
+		LocalBuffers<UringBuffers> buffers;
+		std::vector<char>& buffer = buffers->buffer;
+		std::vector<NodeTable::Entry>& entries = buffers->entries;
+		std::vector<const char*>& names = buffers->names;
+		std::vector<struct statx>& stats = buffers->stats;
+		std::vector<int>& results = buffers->results;
+		std::vector<DirectoryStamp>& childStamps = buffers->childStamps;
+		std::vector<char>& childStamped = buffers->childStamped;
+		entries.clear();
+		childStamps.clear();
+		childStamped.clear();
+		const bool metadata = WantsFileMetadata(context);
+		const bool stampsInUse = UsesStamps(context);
+
+		StatScope reading(context._stats, StatTimer::DirectoryRead);
+		if (cached != nullptr) {
+			// Директория не изменилась: getdents не нужен, statx пакетом только для того, что еще понадобится -
+			// файлов для сводки и поддиректорий для их отметок
+			std::vector<std::string>& cachedNames = buffers->cachedNames;
+			context._previous->Load(*cached, context._nodes, entries);
+			cachedNames.clear();
+			for (const NodeTable::Entry& stored : entries)
+				cachedNames.emplace_back(context._nodes.Name(stored.name));
+			stats.resize(entries.size());
+			results.assign(entries.size(), -1);
+			for (std::size_t i = 0; i < entries.size(); ++i) {
+				if (entries[i].type == NodeType::File ? metadata : stampsInUse)
+					batch.AddStat(self->_fd, cachedNames[i].c_str(), &stats[i], &results[i]);
+			}
+			batch.Run();
+			for (std::size_t i = 0; i < entries.size(); ++i) {
+				if (entries[i].type == NodeType::Directory) {
+					childStamps.push_back(results[i] == 0 ? StampOf(stats[i]) : DirectoryStamp{});
+					childStamped.push_back(results[i] == 0);
+					if (results[i] == 0)
+						entries[i].mtime = static_cast<std::int64_t>(stats[i].stx_mtime.tv_sec) * 1000000000 + stats[i].stx_mtime.tv_nsec;
+				}
+				else if (results[i] == 0) {
+					entries[i].size = CountedSize(context, stats[i]);
+					entries[i].mtime = static_cast<std::int64_t>(stats[i].stx_mtime.tv_sec) * 1000000000 + stats[i].stx_mtime.tv_nsec;
+				}
+			}
+		}
+		// Неполный список не попадает в снимок, иначе следующий обход взял бы его как неизменный
+		bool complete = true;
+		while (cached == nullptr) {
+			const long read = ::syscall(SYS_getdents64, self->_fd, buffer.data(), buffer.size());
+			if (read < 0) {
+				// Ошибка чтения (EIO, ENOENT у удаленной директории) - не конец списка
+				ReportReadFailure(context, node, errno);
+				complete = false;
+			}
+			if (read <= 0)
+				break;
+			// statx всех записей блока уходит в кольцо одним пакетом; имена живут в буфере до Run
+			names.clear();
+			for (long offset = 0; offset < read;) {
+				const auto& entry = *reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+				offset += entry.d_reclen;
+				if (!IsDotEntry(entry.d_name))
+					names.push_back(entry.d_name);
+			}
+			stats.resize(names.size());
+			results.resize(names.size());
+			for (std::size_t i = 0; i < names.size(); ++i)
+				batch.AddStat(self->_fd, names[i], &stats[i], &results[i]);
+			batch.Run();
+
+			for (std::size_t i = 0; i < names.size(); ++i) {
+				// Запись удалена во время обхода или недоступна
+				if (results[i] != 0)
+					continue;
+				NodeType type;
+				if (S_ISREG(stats[i].stx_mode)) type = NodeType::File;
+				else if (S_ISDIR(stats[i].stx_mode)) type = NodeType::Directory;
+				else continue;
+				// Размер есть у любой записи statx; жесткие ссылки с context._visited учитываются один раз,
+				// директории выводятся с размером 0, как у остальных способов обхода
+				const std::uint64_t size = type == NodeType::Directory ? 0 : metadata ? CountedSize(context, stats[i]) : stats[i].stx_size;
+				entries.push_back({ type, context._nodes.StoreName(names[i]), size,
+					static_cast<std::int64_t>(stats[i].stx_mtime.tv_sec) * 1000000000 + stats[i].stx_mtime.tv_nsec });
+				if (type == NodeType::Directory) {
+					childStamps.push_back(StampOf(stats[i]));
+					childStamped.push_back(true);
+				}
+			}
+		}
+		reading.Stop();
+		const std::uint32_t first = context._nodes.Append(node, entries);
+		if (stamp != nullptr && complete && context._snapshot != nullptr)
+			context._snapshot->Record(node, first, static_cast<std::uint32_t>(entries.size()), *stamp, cached != nullptr);
+		// Вывод информации о директории (или учет в сводке) до постановки задач поддиректорий
+		FinishDirectory(context, node, first, entries);
+
+		// Поддиректории открываются заранее одним пакетом, пока не исчерпан лимит дескрипторов;
+		// остальные откроет своя задача относительно дескриптора родителя или по полному пути.
+		// Неизменные поддиректории без своих поддиректорий не открываются вовсе
+		std::vector<std::string>& subdirectories = buffers->subdirectories;
+		std::vector<const snapshot::Directory*>& unchanged = buffers->unchanged;
+		std::vector<int>& opened = buffers->opened;
+		std::vector<char>& requested = buffers->requested;
+		subdirectories.clear();
+		unchanged.clear();
+		for (std::uint32_t i = 0; i < entries.size(); ++i) {
+			if (entries[i].type != NodeType::Directory)
+				continue;
+			const std::size_t k = subdirectories.size();
+			subdirectories.emplace_back(context._nodes.Name(entries[i].name));
+			unchanged.push_back(childStamped[k] ? FindUnchanged(context, first + i, childStamps[k]) : nullptr);
+		}
+		opened.assign(subdirectories.size(), -1);
+		requested.assign(subdirectories.size(), false);
+		for (std::size_t k = 0; k < subdirectories.size(); ++k) {
+			if (CanReuseWithoutOpening(context, unchanged[k]))
+				continue;
+			if (!ReserveHeldFd())
+				break;
+			batch.AddOpen(self->_fd, subdirectories[k].c_str(), &opened[k]);
+			requested[k] = true;
+		}
+		{
+			// Пакет openat учитывается одним интервалом
+			const bool opening = std::find(requested.begin(), requested.end(), true) != requested.end();
+			StatScope timing(opening ? context._stats : nullptr, StatTimer::DirectoryOpen);
+			batch.Run();
+		}
+
+		std::shared_ptr<DirectoryFd> parent;
+		bool decided = false;
+		std::size_t next = 0;
+		for (std::uint32_t i = 0; i < entries.size(); ++i) {
+			if (entries[i].type != NodeType::Directory)
+				continue;
+			const std::size_t k = next++;
+			// Если это поддиректория
+			if (context._debugSleep.count() > 0) {
+				std::this_thread::sleep_for(context._debugSleep);
+			}
+			const bool stamped = childStamped[k];
+			if (CanReuseWithoutOpening(context, unchanged[k])) {
+				DispatchSubdirectory(context, [&context, child = first + i, previous = unchanged[k], stamp = childStamps[k]]() {
+					ReuseLeaf(child, context, *previous, stamp);
+				});
+				continue;
+			}
+			if (opened[k] >= 0) {
+				DispatchSubdirectory(context, [&context, fd = opened[k], child = first + i, stamped, stamp = childStamps[k], previous = unchanged[k]]() {
+					ScanDirectoryUring(std::make_shared<DirectoryFd>(fd, true), child, context, stamped ? &stamp : nullptr, previous);
+				});
+				continue;
+			}
+			// Открыть заранее не удалось: место в лимите должно быть возвращено
+			if (requested[k])
+				g_heldFds.fetch_sub(1, std::memory_order_relaxed);
+			// Остальные открывает своя задача: относительно удержанного дескриптора родителя или по полному пути
+			if (!decided) {
+				decided = true;
+				if (HoldForSubdirectories(context, *self, node))
+					parent = self;
+			}
+			DispatchSubdirectory(context, [&context, parent, child = first + i, stamped, stamp = childStamps[k], previous = unchanged[k]]() mutable {
+				const int fd = OpenSubdirectory(context, SubdirectoryName(context, parent.get(), child), child);
+				parent.reset();
+				if (fd < 0) {
+					FinishDirectory(context, child, 0, {});
+					return;
+				}
+				ScanDirectoryUring(std::make_shared<DirectoryFd>(fd), child, context, stamped ? &stamp : nullptr, previous);
+			});
+		}
+		self.reset();
+	}
+}
+
+void TraverseDirectoryGetdents(const std::filesystem::path& directory, std::uint32_t node, TraversalContext& context) {
+	UpdateHeldFdLimit();
+	const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0) {
+		ReportOpenFailure(context, node, errno);
+		FinishDirectory(context, node, 0, {});
+		return;
+	}
+	// Отметка корня снимается по открытому дескриптору
+	DirectoryStamp stamp;
+	struct stat info {};
+	const bool stamped = UsesStamps(context) && ::fstat(fd, &info) == 0;
+	if (stamped)
+		stamp = StampOf(info);
+	ScanDirectory(std::make_shared<DirectoryFd>(fd), node, context, stamped ? &stamp : nullptr,
+		stamped ? FindUnchanged(context, node, stamp) : nullptr);
+}
+
+void TraverseDirectoryUring(const std::filesystem::path& directory, std::uint32_t node, TraversalContext& context) {
+	UpdateHeldFdLimit();
+	const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0) {
+		ReportOpenFailure(context, node, errno);
+		FinishDirectory(context, node, 0, {});
+		return;
+	}
+	DirectoryStamp stamp;
+	struct stat info {};
+	const bool stamped = UsesStamps(context) && ::fstat(fd, &info) == 0;
+	if (stamped)
+		stamp = StampOf(info);
+	ScanDirectoryUring(std::make_shared<DirectoryFd>(fd), node, context, stamped ? &stamp : nullptr,
+		stamped ? FindUnchanged(context, node, stamp) : nullptr);
+}
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/// @brief 64-битный некриптографический хэш (MurmurHash64A, Austin Appleby).
+/// Читает по 8 байт за шаг и не зависит от выравнивания данных; результат одинаков
+/// на всех платформах с little-endian, поэтому годится для файлов снимков.
+[[nodiscard]] inline std::uint64_t Hash64(const void* data, std::size_t size, std::uint64_t seed = 0) {
+	constexpr std::uint64_t m = 0xC6A4A7935BD1E995ull;
+	constexpr int r = 47;
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	std::uint64_t h = seed ^ (size * m);
+
+	const std::size_t blocks = size / 8;
+	for (std::size_t i = 0; i < blocks; ++i) {
+		std::uint64_t k;
+		std::memcpy(&k, bytes + i * 8, sizeof(k));
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	const unsigned char* tail = bytes + blocks * 8;
+	switch (size & 7) {
+	case 7: h ^= std::uint64_t(tail[6]) << 48; [[fallthrough]];
+	case 6: h ^= std::uint64_t(tail[5]) << 40; [[fallthrough]];
+	case 5: h ^= std::uint64_t(tail[4]) << 32; [[fallthrough]];
+	case 4: h ^= std::uint64_t(tail[3]) << 24; [[fallthrough]];
+	case 3: h ^= std::uint64_t(tail[2]) << 16; [[fallthrough]];
+	case 2: h ^= std::uint64_t(tail[1]) << 8; [[fallthrough]];
+	case 1: h ^= std::uint64_t(tail[0]);
+		h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
+
+/// @brief Хэш строки
+[[nodiscard]] inline std::uint64_t Hash64(std::string_view text, std::uint64_t seed = 0) {
+	return Hash64(text.data(), text.size(), seed);
+}
+
+/// @brief Потоковый 64-битный хэш для содержимого файлов (алгоритм xxHash64, Yann Collet).
+/// Данные обрабатываются полосами по 32 байта в четырех независимых аккумуляторах, поэтому
+/// умножения соседних слов не ждут друг друга и компилятор держит все четыре в регистрах.
+/// Результат не зависит от того, какими порциями передавались данные.
+class StreamHash {
+public:
+	explicit StreamHash(std::uint64_t seed = 0) :
+		_seed(seed), _lanes{ seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1 } {}
+
+	///@brief Добавление данных
+	void Update(const void* data, std::size_t size) {
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		_total += size;
+		// Сначала дополняется неполная полоса прошлого вызова
+		if (_buffered > 0) {
+			const std::size_t take = size < StripeSize - _buffered ? size : StripeSize - _buffered;
+			std::memcpy(_buffer + _buffered, bytes, take);
+			_buffered += take;
+			bytes += take;
+			size -= take;
+			if (_buffered < StripeSize)
+				return;
+			Consume(_buffer);
+			_buffered = 0;
+		}
+		for (; size >= StripeSize; bytes += StripeSize, size -= StripeSize)
+			Consume(bytes);
+		std::memcpy(_buffer, bytes, size);
+		_buffered = size;
+	}
+
+	///@brief Значение хэша всех добавленных данных
+	[[nodiscard]] std::uint64_t Digest() const {
+		std::uint64_t h;
+		if (_total >= StripeSize) {
+			h = Rotate(_lanes[0], 1) + Rotate(_lanes[1], 7) + Rotate(_lanes[2], 12) + Rotate(_lanes[3], 18);
+			for (const std::uint64_t lane : _lanes)
+				h = (h ^ Round(0, lane)) * Prime1 + Prime4;
+		}
+		else {
+			h = _seed + Prime5;
+		}
+		h += _total;
+
+		std::size_t i = 0;
+		for (; i + 8 <= _buffered; i += 8)
+			h = Rotate(h ^ Round(0, Read64(_buffer + i)), 27) * Prime1 + Prime4;
+		if (i + 4 <= _buffered) {
+			std::uint32_t word;
+			std::memcpy(&word, _buffer + i, sizeof(word));
+			h = Rotate(h ^ (std::uint64_t(word) * Prime1), 23) * Prime2 + Prime3;
+			i += 4;
+		}
+		for (; i < _buffered; ++i)
+			h = Rotate(h ^ (std::uint64_t(_buffer[i]) * Prime5), 11) * Prime1;
+
+		h ^= h >> 33;
+		h *= Prime2;
+		h ^= h >> 29;
+		h *= Prime3;
+		h ^= h >> 32;
+		return h;
+	}
+
+private:
+	static constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+	static constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ull;
+	static constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+	static constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+	static constexpr std::size_t StripeSize = 32;
+
+	static std::uint64_t Rotate(std::uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+	static std::uint64_t Read64(const unsigned char* data) {
+		std::uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static std::uint64_t Round(std::uint64_t lane, std::uint64_t input) {
+		lane += input * Prime2;
+		return Rotate(lane, 31) * Prime1;
+	}
+
+	void Consume(const unsigned char* stripe) {
+		_lanes[0] = Round(_lanes[0], Read64(stripe));
+		_lanes[1] = Round(_lanes[1], Read64(stripe + 8));
+		_lanes[2] = Round(_lanes[2], Read64(stripe + 16));
+		_lanes[3] = Round(_lanes[3], Read64(stripe + 24));
+	}
+
+	std::uint64_t _seed;
+	std::uint64_t _lanes[4];
+	std::uint64_t _total = 0;
+	unsigned char _buffer[StripeSize] = {};
+	std::size_t _buffered = 0;
+};
@@ -0,0 +1,96 @@
+#include "InodeSet.hpp"
+#include <algorithm>
+#include <new>
+
+namespace {
+	/// @brief Перемешивание битов ключа (финализатор MurmurHash3): и шард, и ячейка зависят от всех битов
+	std::uint64_t Mix(std::uint64_t key) {
+		key ^= key >> 33;
+		key *= 0xFF51AFD7ED558CCDull;
+		key ^= key >> 33;
+		key *= 0xC4CEB9FE1A85EC53ull;
+		key ^= key >> 33;
+		return key;
+	}
+
+	/// @brief Ближайшая степень двойки не меньше value
+	std::size_t RoundUpPowerOfTwo(std::size_t value) {
+		std::size_t power = 1;
+		while (power < value)
+			power <<= 1;
+		return power;
+	}
+}
+
+InodeSet::InodeSet(std::size_t capacity) : _shards(new Shard[Shards]) {
+	// Заполнение не больше половины: при нем пробы короткие и почти никогда не доходят до ProbeLimit
+	_shardSlots = std::max(ProbeLimit, RoundUpPowerOfTwo(2 * std::max<std::size_t>(capacity, 1) / Shards));
+	for (std::size_t i = 0; i < Shards; ++i) {
+		// Нулевая память calloc - пустые ячейки; страницы займут память, только когда в них запишут
+		void* slots = std::calloc(_shardSlots, sizeof(std::atomic<std::uint64_t>));
+		if (slots == nullptr)
+			throw std::bad_alloc();
+		_shards[i]._slots.reset(static_cast<std::atomic<std::uint64_t>*>(slots));
+	}
+}
+
+std::uint64_t InodeSet::DeviceIndex(std::uint64_t device) {
+	// Устройств при обходе единицы, поэтому линейный поиск короче хэширования
+	const std::uint64_t value = device + 1;
+	for (std::size_t i = 0; i < MaxDevices; ++i) {
+		std::uint64_t current = _devices[i].load(std::memory_order_acquire);
+		if (current == 0 && _devices[i].compare_exchange_strong(current, value, std::memory_order_acq_rel))
+			return i + 1;
+		if (current == value)
+			return i + 1;
+	}
+	return 0;
+}
+
+bool InodeSet::Insert(std::uint64_t device, std::uint64_t inode) {
+	const std::uint64_t index = device != ~0ull && inode < (1ull << InodeBits) ? DeviceIndex(device) : 0;
+	// Ключ без нулевого значения: номер устройства начинается с 1
+	const std::uint64_t key = index << InodeBits | inode;
+	const std::uint64_t hash = Mix(index != 0 ? key : device ^ Mix(inode));
+	Shard& shard = _shards[hash >> 58];
+	if (index == 0)
+		return InsertOverflow(shard, device, inode);
+
+	const std::size_t mask = _shardSlots - 1;
+	for (std::size_t probe = 0; probe < ProbeLimit; ++probe) {
+		std::atomic<std::uint64_t>& slot = shard._slots[(hash + probe) & mask];
+		std::uint64_t current = slot.load(std::memory_order_acquire);
+		if (current == 0) {
+			if (slot.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+				shard._count.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			// Ячейку заняли одновременно с нами: возможно, той же парой
+		}
+		if (current == key)
+			return false;
+	}
+	// Ячейки не освобождаются, поэтому все пробы этой пары и дальше будут заняты: она всегда уходит сюда
+	return InsertOverflow(shard, device, inode);
+}
+
+bool InodeSet::InsertOverflow(Shard& shard, std::uint64_t device, std::uint64_t inode) {
+	std::lock_guard<std::mutex> lock(shard._overflowMutex);
+	return shard._overflow.emplace(device, inode).second;
+}
+
+std::size_t InodeSet::Size() const {
+	std::size_t size = OverflowSize();
+	for (std::size_t i = 0; i < Shards; ++i)
+		size += _shards[i]._count.load(std::memory_order_relaxed);
+	return size;
+}
+
+std::size_t InodeSet::OverflowSize() const {
+	std::size_t size = 0;
+	for (std::size_t i = 0; i < Shards; ++i) {
+		std::lock_guard<std::mutex> lock(_shards[i]._overflowMutex);
+		size += _shards[i]._overflow.size();
+	}
+	return size;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+
+/// @brief Множество пар (устройство, inode), в которое одновременно добавляют все потоки пула.
+/// Пары кодируются 64-битным ключом (номер устройства в таблице устройств и inode) и лежат в шардах -
+/// таблицах с открытой адресацией фиксированного размера: вставка - compare_exchange в пустую ячейку
+/// без блокировок. Память ограничена емкостью, заданной при создании; страницы таблиц выделяются
+/// нулевыми и занимают память по мере заполнения.
+/// Пара, которую нельзя закодировать (inode от 2^48, больше MaxDevices устройств), и пара, не нашедшая
+/// места за ProbeLimit проб, попадают в запасное множество своего шарда под мьютексом: ответ остается точным.
+class InodeSet {
+public:
+	/// Емкость по умолчанию: пар без запасного множества (16 байт памяти на пару)
+	static constexpr std::size_t DefaultCapacity = 1u << 20;
+	/// Устройств с компактным номером
+	static constexpr std::size_t MaxDevices = 256;
+
+	///@brief capacity - сколько пар помещается в таблицы (заполнение не больше половины)
+	explicit InodeSet(std::size_t capacity = DefaultCapacity);
+
+	InodeSet(const InodeSet&) = delete;
+	InodeSet& operator=(const InodeSet&) = delete;
+
+	///@brief Добавление пары; true, если ее еще не было (первое посещение)
+	[[nodiscard]] bool Insert(std::uint64_t device, std::uint64_t inode);
+
+	///@brief Количество пар
+	[[nodiscard]] std::size_t Size() const;
+
+	///@brief Количество пар в запасных множествах
+	[[nodiscard]] std::size_t OverflowSize() const;
+
+	///@brief Объем таблиц (без запасных множеств)
+	[[nodiscard]] std::size_t MemoryUsage() const { return Shards * _shardSlots * sizeof(std::uint64_t); }
+
+private:
+	/// Шардов; номер шарда - старшие биты хэша ключа
+	static constexpr std::size_t Shards = 64;
+	/// Проб в таблице шарда до перехода к запасному множеству
+	static constexpr std::size_t ProbeLimit = 64;
+	/// Бит ключа под inode
+	static constexpr unsigned InodeBits = 48;
+
+	/// @brief Освобождение таблицы, выделенной calloc
+	struct FreeSlots {
+		void operator()(std::atomic<std::uint64_t>* slots) const { std::free(slots); }
+	};
+
+	/// @brief Шард: таблица ключей (0 - пустая ячейка) и запасное множество пар
+	struct alignas(64) Shard {
+		std::unique_ptr<std::atomic<std::uint64_t>[], FreeSlots> _slots;
+		std::atomic<std::size_t> _count{ 0 };
+		std::set<std::pair<std::uint64_t, std::uint64_t>> _overflow;
+		mutable std::mutex _overflowMutex;
+	};
+
+	//@brief Компактный номер устройства (от 1); 0, если таблица устройств заполнена
+	[[nodiscard]] std::uint64_t DeviceIndex(std::uint64_t device);
+
+	//@brief Добавление пары в запасное множество шарда
+	[[nodiscard]] bool InsertOverflow(Shard& shard, std::uint64_t device, std::uint64_t inode);
+
+	///Ячеек в таблице одного шарда (степень двойки)
+	std::size_t _shardSlots;
+	std::unique_ptr<Shard[]> _shards;
+	///Устройства, встреченные при обходе (значение + 1; 0 - свободно)
+	std::atomic<std::uint64_t> _devices[MaxDevices] = {};
+};
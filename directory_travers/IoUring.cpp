@@ -0,0 +1,216 @@
+#ifdef __linux__
+#include "IoUring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+	/// Что запрашивается у statx
+	constexpr unsigned StatMask = STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_INO | STATX_SIZE | STATX_MTIME | STATX_CTIME;
+
+	int RingSetup(unsigned entries, io_uring_params* params) {
+		return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+	}
+
+	int RingEnter(int ring, unsigned submit, unsigned wait) {
+		return static_cast<int>(::syscall(__NR_io_uring_enter, ring, submit, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+	}
+}
+
+MetadataBatch::MetadataBatch(unsigned depth) : _depth(depth) {
+	// Нулевая глубина - явный выбор синхронных вызовов
+	if (_depth == 0 || !Setup())
+		Teardown();
+}
+
+MetadataBatch::~MetadataBatch() {
+	Teardown();
+}
+
+bool MetadataBatch::Setup() {
+	io_uring_params params{};
+	_ring = RingSetup(_depth, &params);
+	if (_ring < 0)
+		return false;
+	_depth = params.sq_entries;
+
+	_sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single)
+		_sqMapSize = _cqMapSize = std::max(_sqMapSize, _cqMapSize);
+
+	_sqMap = ::mmap(nullptr, _sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+	if (_sqMap == MAP_FAILED) {
+		_sqMap = nullptr;
+		return false;
+	}
+	if (single) {
+		_cqMap = _sqMap;
+	}
+	else {
+		_cqMap = ::mmap(nullptr, _cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+		if (_cqMap == MAP_FAILED) {
+			_cqMap = nullptr;
+			return false;
+		}
+	}
+	_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	void* sqes = ::mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED)
+		return false;
+	_sqes = static_cast<io_uring_sqe*>(sqes);
+
+	auto* sq = static_cast<char*>(_sqMap);
+	auto* cq = static_cast<char*>(_cqMap);
+	_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	_sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	_cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	return true;
+}
+
+void MetadataBatch::Teardown() {
+	if (_sqes != nullptr)
+		::munmap(_sqes, _sqesSize);
+	if (_cqMap != nullptr && _cqMap != _sqMap)
+		::munmap(_cqMap, _cqMapSize);
+	if (_sqMap != nullptr)
+		::munmap(_sqMap, _sqMapSize);
+	if (_ring >= 0)
+		::close(_ring);
+	_sqes = nullptr;
+	_sqMap = _cqMap = nullptr;
+	_ring = -1;
+}
+
+void MetadataBatch::AddStat(int dirFd, const char* name, struct statx* out, int* result) {
+	_operations.push_back({ false, dirFd, name, out, result });
+}
+
+void MetadataBatch::AddOpen(int dirFd, const char* name, int* result) {
+	_operations.push_back({ true, dirFd, name, nullptr, result });
+}
+
+void MetadataBatch::RunSync(const Operation& operation) {
+	if (operation.open) {
+		const int fd = ::openat(operation.dirFd, operation.name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+		*operation.result = fd >= 0 ? fd : -errno;
+	}
+	else {
+		*operation.result = ::statx(operation.dirFd, operation.name, AT_SYMLINK_NOFOLLOW, StatMask, operation.stat) == 0 ? 0 : -errno;
+	}
+}
+
+void MetadataBatch::Prepare(std::size_t index) {
+	const Operation& operation = _operations[index];
+	const unsigned tail = *_sqTail;
+	const unsigned slot = tail & *_sqMask;
+	io_uring_sqe& sqe = _sqes[slot];
+	std::memset(&sqe, 0, sizeof(sqe));
+	sqe.fd = operation.dirFd;
+	sqe.addr = reinterpret_cast<std::uint64_t>(operation.name);
+	sqe.user_data = index;
+	if (operation.open) {
+		sqe.opcode = IORING_OP_OPENAT;
+		sqe.open_flags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+	}
+	else {
+		sqe.opcode = IORING_OP_STATX;
+		sqe.statx_flags = AT_SYMLINK_NOFOLLOW;
+		sqe.len = StatMask;
+		sqe.off = reinterpret_cast<std::uint64_t>(operation.stat);
+	}
+	_sqArray[slot] = slot;
+	// Ядро читает SQE после того, как увидит новый хвост
+	__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+}
+
+void MetadataBatch::Run() {
+	if (_ring < 0) {
+		for (const Operation& operation : _operations)
+			RunSync(operation);
+		_operations.clear();
+		return;
+	}
+
+	// Скользящее окно: в полете до _depth операций, освободившиеся места сразу заполняются
+	std::size_t next = 0;
+	std::size_t inFlight = 0;
+	// Подготовленные, но еще не принятые ядром (io_uring_enter может принять не все, например при EINTR)
+	unsigned unsubmitted = 0;
+	std::size_t completed = 0;
+	const std::size_t total = _operations.size();
+	while (completed < total) {
+		while (next < total && inFlight < _depth) {
+			Prepare(next++);
+			++inFlight;
+			++unsubmitted;
+		}
+		const int submitted = RingEnter(_ring, unsubmitted, 1);
+		if (submitted >= 0)
+			unsubmitted -= static_cast<unsigned>(submitted);
+		else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			// Кольцо сломалось: оставшееся выполняем синхронно, отправленное дожидаемся
+			break;
+		unsigned head = *_cqHead;
+		const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; ++head) {
+			const io_uring_cqe& cqe = _cqes[head & *_cqMask];
+			const Operation& operation = _operations[cqe.user_data];
+			// -EINVAL на операцию, которую ядро не знает, повторяем обычным вызовом
+			if (cqe.res == -EINVAL)
+				RunSync(operation);
+			else
+				*operation.result = cqe.res;
+			--inFlight;
+			++completed;
+		}
+		__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+	}
+	if (completed < total) {
+		// Дожидаемся уже отправленных операций, чтобы ядро не писало в освобожденные буферы
+		while (inFlight > 0) {
+			const int submitted = RingEnter(_ring, unsubmitted, 1);
+			if (submitted >= 0)
+				unsubmitted -= static_cast<unsigned>(submitted);
+			else if (errno != EINTR)
+				break;
+			unsigned head = *_cqHead;
+			const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+			for (; head != tail; ++head) {
+				const io_uring_cqe& cqe = _cqes[head & *_cqMask];
+				*_operations[cqe.user_data].result = cqe.res;
+				--inFlight;
+			}
+			__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+		}
+		for (; next < total; ++next)
+			RunSync(_operations[next]);
+	}
+	_operations.clear();
+}
+
+bool IoUringAvailable() {
+	static const bool available = [] {
+		io_uring_params params{};
+		const int ring = RingSetup(1, &params);
+		if (ring < 0)
+			return false;
+		::close(ring);
+		// openat и statx появились в 5.6 вместе с IORING_FEAT_NODROP
+		return (params.features & IORING_FEAT_NODROP) != 0;
+	}();
+	return available;
+}
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+#ifdef __linux__
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+
+/// @brief Пакет метаданных для обхода: openat и statx, выполняемые через io_uring.
+/// Операции накапливаются через Add*, Run выполняет их все, держая в полете до depth запросов.
+/// Если io_uring недоступен (старое ядро, запрет seccomp) или ядро не поддерживает операцию,
+/// она выполняется обычным системным вызовом, поэтому результат от способа выполнения не зависит.
+/// При нулевой глубине кольцо не создается и все операции выполняются синхронно.
+/// Объект принадлежит одному потоку.
+class MetadataBatch {
+public:
+	explicit MetadataBatch(unsigned depth);
+	~MetadataBatch();
+
+	MetadataBatch(const MetadataBatch&) = delete;
+	MetadataBatch& operator=(const MetadataBatch&) = delete;
+
+	///@brief statx(dirFd, name) без раскрытия ссылок; *result - 0 или -errno.
+	/// name и out должны быть действительны до завершения Run.
+	void AddStat(int dirFd, const char* name, struct statx* out, int* result);
+
+	///@brief openat(dirFd, name) директории; *result - дескриптор или -errno
+	void AddOpen(int dirFd, const char* name, int* result);
+
+	///@brief Выполнение всех накопленных операций
+	void Run();
+
+	///@brief Используется ли io_uring (false - синхронный запасной путь)
+	[[nodiscard]] bool UsesRing() const { return _ring >= 0; }
+
+	///@brief Глубина очереди
+	[[nodiscard]] unsigned Depth() const { return _depth; }
+
+private:
+	/// @brief Отложенная операция
+	struct Operation {
+		bool open;
+		int dirFd;
+		const char* name;
+		struct statx* stat;
+		int* result;
+	};
+
+	//@brief Синхронное выполнение операции
+	static void RunSync(const Operation& operation);
+
+	//@brief Заполнение SQE операции
+	void Prepare(std::size_t index);
+
+	bool Setup();
+	void Teardown();
+
+	std::vector<Operation> _operations;
+	unsigned _depth;
+
+	/// Дескриптор кольца (-1, если io_uring недоступен)
+	int _ring = -1;
+	/// Отображения кольца отправки, кольца завершения и массива SQE
+	void* _sqMap = nullptr;
+	std::size_t _sqMapSize = 0;
+	void* _cqMap = nullptr;
+	std::size_t _cqMapSize = 0;
+	io_uring_sqe* _sqes = nullptr;
+	std::size_t _sqesSize = 0;
+	/// Поля колец внутри отображений
+	unsigned* _sqHead = nullptr;
+	unsigned* _sqTail = nullptr;
+	unsigned* _sqMask = nullptr;
+	unsigned* _sqArray = nullptr;
+	unsigned* _cqHead = nullptr;
+	unsigned* _cqTail = nullptr;
+	unsigned* _cqMask = nullptr;
+	io_uring_cqe* _cqes = nullptr;
+};
+
+/// @brief Доступен ли io_uring в этом процессе (проверяется один раз)
+[[nodiscard]] bool IoUringAvailable();
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+
+/// @brief Интрузивная очередь без блокировок: много производителей, один потребитель.
+/// Реализация по схеме Д. Вьюкова: Push - один atomic exchange, Pop выполняет только поток-потребитель.
+/// Тип T должен содержать поле std::atomic<T*> _next.
+/// Pop может вернуть nullptr, пока производитель находится между exchange и связыванием узла;
+/// потребитель в этом случае повторяет попытку позже.
+template<typename T>
+class MpscQueue {
+public:
+	MpscQueue() : _head(&_stub), _tail(&_stub) {}
+
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue& operator=(const MpscQueue&) = delete;
+
+	///@brief Добавление узла (любой поток)
+	void Push(T* node) {
+		node->_next.store(nullptr, std::memory_order_relaxed);
+		T* previous = _head.exchange(node, std::memory_order_acq_rel);
+		previous->_next.store(node, std::memory_order_release);
+	}
+
+	///@brief Извлечение самого старого узла (только поток-потребитель)
+	[[nodiscard]] T* Pop() {
+		T* tail = _tail;
+		T* next = tail->_next.load(std::memory_order_acquire);
+		if (tail == &_stub) {
+			if (next == nullptr)
+				return nullptr;
+			// Пропускаем заглушку
+			_tail = next;
+			tail = next;
+			next = next->_next.load(std::memory_order_acquire);
+		}
+		if (next != nullptr) {
+			_tail = next;
+			return tail;
+		}
+		if (tail != _head.load(std::memory_order_acquire))
+			return nullptr;
+		// Последний узел: возвращаем заглушку в очередь, чтобы отдать его
+		Push(&_stub);
+		next = tail->_next.load(std::memory_order_acquire);
+		if (next != nullptr) {
+			_tail = next;
+			return tail;
+		}
+		return nullptr;
+	}
+
+private:
+	///Голова (сюда добавляют производители)
+	alignas(64) std::atomic<T*> _head;
+	///Хвост (изменяется только потребителем)
+	alignas(64) T* _tail;
+	///Заглушка, благодаря которой очередь никогда не бывает физически пустой
+	T _stub;
+};
@@ -0,0 +1,147 @@
+#include "NodeTable.hpp"
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+NodeTable::NodeTable() :
+	_segments(new std::atomic<Node*>[MaxSegments]),
+	_arenas(new std::atomic<Arena*>[MaxArenas]) {
+	for (std::size_t i = 0; i < MaxSegments; ++i)
+		_segments[i].store(nullptr, std::memory_order_relaxed);
+	for (std::size_t i = 0; i < MaxArenas; ++i)
+		_arenas[i].store(nullptr, std::memory_order_relaxed);
+}
+
+NodeTable::~NodeTable() {
+	for (std::size_t i = 0; i < MaxSegments; ++i)
+		delete[] _segments[i].load(std::memory_order_relaxed);
+	for (std::size_t i = 0; i < MaxArenas; ++i)
+		delete _arenas[i].load(std::memory_order_relaxed);
+}
+
+NodeTable::Arena& NodeTable::LocalArena(std::uint16_t& index) {
+	Arena& arena = _threadLocals.Local<Arena>([this] {
+		std::lock_guard<std::mutex> lock(_arenaMutex);
+		const std::uint16_t next = _arenaCount.load(std::memory_order_relaxed);
+		if (next == MaxArenas)
+			throw std::length_error("NodeTable: too many threads");
+		auto* created = new Arena;
+		created->index = next;
+		_arenas[next].store(created, std::memory_order_release);
+		_arenaCount.store(static_cast<std::uint16_t>(next + 1), std::memory_order_release);
+		return created;
+	});
+	index = arena.index;
+	return arena;
+}
+
+NameRef NodeTable::StoreName(std::string_view name) {
+	if (name.size() > UINT16_MAX)
+		throw std::length_error("NodeTable: name is too long");
+	const auto length = static_cast<std::uint32_t>(name.size());
+	NameRef ref{};
+	Arena& arena = LocalArena(ref.arena);
+	// Имя не должно пересекать границу блока
+	if ((arena.used & (BlockSize - 1)) + length > BlockSize)
+		arena.used = (arena.used | (BlockSize - 1)) + 1;
+	const std::size_t block = arena.used >> BlockShift;
+	if (block >= MaxBlocks || (block == MaxBlocks - 1 && (arena.used & (BlockSize - 1)) + length > BlockSize))
+		throw std::length_error("NodeTable: name arena is full");
+	char* data = arena.blocks[block].load(std::memory_order_relaxed);
+	if (data == nullptr) {
+		data = new char[BlockSize];
+		arena.blocks[block].store(data, std::memory_order_release);
+		++arena.allocatedBlocks;
+	}
+	std::memcpy(data + (arena.used & (BlockSize - 1)), name.data(), length);
+	ref.offset = arena.used;
+	ref.length = static_cast<std::uint16_t>(length);
+	arena.used += length;
+	return ref;
+}
+
+void NodeTable::EnsureSegments(std::uint32_t first, std::uint32_t count) {
+	if (count == 0)
+		return;
+	const std::size_t last = (static_cast<std::size_t>(first) + count - 1) >> SegmentShift;
+	for (std::size_t segment = first >> SegmentShift; segment <= last; ++segment) {
+		if (_segments[segment].load(std::memory_order_acquire) != nullptr)
+			continue;
+		// Сегмент выделяет первый, кому он понадобился; проигравший освобождает свой
+		Node* fresh = new Node[SegmentSize];
+		Node* expected = nullptr;
+		if (!_segments[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+			delete[] fresh;
+	}
+}
+
+std::uint32_t NodeTable::AddRoot(std::string_view path) {
+	std::vector<Entry> root{ { NodeType::Directory, StoreName(path), 0 } };
+	return Append(NoParent, root);
+}
+
+std::uint32_t NodeTable::Append(std::uint32_t parent, const std::vector<Entry>& entries) {
+	const auto count = static_cast<std::uint32_t>(entries.size());
+	const std::uint32_t first = _count.fetch_add(count, std::memory_order_relaxed);
+	if (static_cast<std::uint64_t>(first) + count >= NoParent)
+		throw std::length_error("NodeTable: too many nodes");
+	EnsureSegments(first, count);
+	for (std::uint32_t i = 0; i < count; ++i) {
+		const std::uint32_t index = first + i;
+		Node& node = _segments[index >> SegmentShift].load(std::memory_order_relaxed)[index & SegmentMask];
+		node.size = entries[i].size;
+		node.parent = parent;
+		node.nameOffset = entries[i].name.offset;
+		node.nameLength = entries[i].name.length;
+		node.arena = entries[i].name.arena;
+		node.type = entries[i].type;
+	}
+	return first;
+}
+
+std::string_view NodeTable::Name(const NameRef& name) const {
+	const Arena& arena = *_arenas[name.arena].load(std::memory_order_acquire);
+	const char* block = arena.blocks[name.offset >> BlockShift].load(std::memory_order_acquire);
+	return { block + (name.offset & (BlockSize - 1)), name.length };
+}
+
+std::string_view NodeTable::Name(const Node& node) const {
+	return Name(NameRef{ node.arena, node.nameOffset, node.nameLength });
+}
+
+void NodeTable::AppendPath(std::string& out, std::uint32_t index) const {
+	// Собираем цепочку до корня, затем выписываем имена от корня
+	std::uint32_t chain[256];
+	std::size_t depth = 0;
+	std::vector<std::uint32_t> deep;
+	for (std::uint32_t current = index; current != NoParent; current = (*this)[current].parent) {
+		if (depth < std::size(chain))
+			chain[depth++] = current;
+		else
+			deep.push_back(current);
+	}
+	bool root = true;
+	const auto append = [this, &out, &root](std::uint32_t current) {
+		// Имя корня - путь целиком, разделитель после него добавляется, только если его нет
+		if (!root && !out.empty() && out.back() != '/')
+			out += '/';
+		out += Name((*this)[current]);
+		root = false;
+	};
+	for (auto it = deep.rbegin(); it != deep.rend(); ++it)
+		append(*it);
+	while (depth > 0)
+		append(chain[--depth]);
+}
+
+std::size_t NodeTable::MemoryUsage() const {
+	std::size_t bytes = 0;
+	for (std::size_t i = 0; i < MaxSegments; ++i) {
+		if (_segments[i].load(std::memory_order_relaxed) != nullptr)
+			bytes += sizeof(Node) * SegmentSize;
+	}
+	const std::uint16_t arenas = _arenaCount.load(std::memory_order_acquire);
+	for (std::uint16_t i = 0; i < arenas; ++i)
+		bytes += _arenas[i].load(std::memory_order_acquire)->allocatedBlocks * BlockSize;
+	return bytes;
+}
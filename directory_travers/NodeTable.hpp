@@ -0,0 +1,145 @@
+#pragma once
+#include "ThreadLocals.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Тип узла дерева обхода
+enum class NodeType : std::uint8_t {
+	File,
+	Directory,
+};
+
+/// @brief Узел дерева обхода: 24 байта вместо полного пути.
+/// Хранится только последний компонент имени (в арене строк потока, добавившего узел);
+/// полный путь восстанавливается по цепочке родителей при выводе.
+struct Node {
+	/// Размер файла в байтах (0, если способ обхода его не получал)
+	std::uint64_t size;
+	/// Индекс родительской директории (NodeTable::NoParent для корня)
+	std::uint32_t parent;
+	/// Смещение имени в арене
+	std::uint32_t nameOffset;
+	/// Длина имени
+	std::uint16_t nameLength;
+	/// Номер арены строк
+	std::uint16_t arena;
+	NodeType type;
+};
+
+/// @brief Ссылка на имя в арене строк
+struct NameRef {
+	std::uint16_t arena;
+	std::uint32_t offset;
+	std::uint16_t length;
+};
+
+/// @brief Таблица узлов, в которую одновременно добавляют узлы все рабочие потоки.
+/// Узлы лежат в сегментах фиксированного размера: индекс резервируется одним fetch_add,
+/// сегменты не перемещаются, поэтому ссылки на узлы и их имена остаются действительными.
+/// Имена хранятся в аренах строк, по одной на поток, без синхронизации при добавлении.
+/// Узел, добавленный одним потоком, читается другим после передачи его индекса через пул
+/// (постановка задачи в очередь упорядочивает запись узла и его чтение).
+class NodeTable {
+public:
+	/// Индекс "нет родителя"
+	static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+	/// @brief Запись директории, подготовленная к добавлению
+	struct Entry {
+		NodeType type;
+		NameRef name;
+		std::uint64_t size;
+		/// Время изменения в наносекундах от эпохи (0 - не запрашивалось); в узел не попадает
+		std::int64_t mtime = 0;
+	};
+
+	NodeTable();
+	~NodeTable();
+
+	NodeTable(const NodeTable&) = delete;
+	NodeTable& operator=(const NodeTable&) = delete;
+
+	///@brief Добавление корня; имя корня - путь, с которого начат обход
+	[[nodiscard]] std::uint32_t AddRoot(std::string_view path);
+
+	///@brief Сохранение имени в арене текущего потока
+	[[nodiscard]] NameRef StoreName(std::string_view name);
+
+	///@brief Добавление записей директории подряд одним резервированием.
+	/// Возвращает индекс первой записи.
+	[[nodiscard]] std::uint32_t Append(std::uint32_t parent, const std::vector<Entry>& entries);
+
+	[[nodiscard]] const Node& operator[](std::uint32_t index) const {
+		return _segments[index >> SegmentShift].load(std::memory_order_acquire)[index & SegmentMask];
+	}
+
+	///@brief Количество узлов
+	[[nodiscard]] std::uint32_t Size() const { return _count.load(std::memory_order_acquire); }
+
+	///@brief Имя узла
+	[[nodiscard]] std::string_view Name(const Node& node) const;
+
+	///@brief Имя по ссылке (до добавления узла)
+	[[nodiscard]] std::string_view Name(const NameRef& name) const;
+
+	///@brief Восстановление полного пути узла
+	void AppendPath(std::string& out, std::uint32_t index) const;
+
+	///@brief Объем памяти, занятый сегментами и аренами
+	[[nodiscard]] std::size_t MemoryUsage() const;
+
+private:
+	/// 65536 узлов в сегменте
+	static constexpr unsigned SegmentShift = 16;
+	static constexpr std::uint32_t SegmentSize = 1u << SegmentShift;
+	static constexpr std::uint32_t SegmentMask = SegmentSize - 1;
+	static constexpr std::size_t MaxSegments = std::size_t(1) << (32 - SegmentShift);
+
+	/// Блок арены 1 МиБ; имя не пересекает границу блока
+	static constexpr unsigned BlockShift = 20;
+	static constexpr std::uint32_t BlockSize = 1u << BlockShift;
+	static constexpr std::size_t MaxBlocks = std::size_t(1) << (32 - BlockShift);
+	static constexpr std::size_t MaxArenas = 4096;
+
+	/// @brief Арена строк одного потока: дописывает только владелец, читают все
+	struct Arena {
+		Arena() : blocks(new std::atomic<char*>[MaxBlocks]) {
+			for (std::size_t i = 0; i < MaxBlocks; ++i)
+				blocks[i].store(nullptr, std::memory_order_relaxed);
+		}
+		~Arena() {
+			for (std::size_t i = 0; i < MaxBlocks; ++i)
+				delete[] blocks[i].load(std::memory_order_relaxed);
+		}
+
+		std::unique_ptr<std::atomic<char*>[]> blocks;
+		std::uint32_t used = 0;
+		std::size_t allocatedBlocks = 0;
+		/// Номер арены в _arenas (NameRef::arena)
+		std::uint16_t index = 0;
+	};
+
+	//@brief Арена текущего потока (создается при первом обращении)
+	[[nodiscard]] Arena& LocalArena(std::uint16_t& index);
+
+	//@brief Выделение сегментов, покрывающих диапазон индексов
+	void EnsureSegments(std::uint32_t first, std::uint32_t count);
+
+	///Сегменты узлов
+	std::unique_ptr<std::atomic<Node*>[]> _segments;
+	///Количество узлов
+	std::atomic<std::uint32_t> _count{ 0 };
+
+	///Арены строк
+	std::unique_ptr<std::atomic<Arena*>[]> _arenas;
+	std::atomic<std::uint16_t> _arenaCount{ 0 };
+	std::mutex _arenaMutex;
+	///Поиск арены текущего потока
+	ThreadLocals _threadLocals;
+};
@@ -0,0 +1,230 @@
+#include "OutputFormat.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace {
+	constexpr std::string_view TsvHeader = "type\tsize\tmtime\tpath\n";
+
+	/// @brief Заголовок двоичного потока в виде байтов
+	const std::string& BinaryHeader() {
+		static const std::string header = [] {
+			binary_output::StreamHeader value{};
+			std::memcpy(value.magic, binary_output::Magic, sizeof(value.magic));
+			value.version = binary_output::Version;
+			value.byteOrder = binary_output::ByteOrderMark;
+			return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+		}();
+		return header;
+	}
+
+	/// @brief Нужен ли разделитель между путем директории и именем (не нужен после корня "/")
+	bool NeedsSeparator(std::string_view directoryPath) {
+		return directoryPath.empty() || directoryPath.back() != '/';
+	}
+
+	std::string_view TypeName(NodeType type) {
+		return type == NodeType::Directory ? "dir" : "file";
+	}
+
+	/// Наибольшее удлинение байта при экранировании (\u00XX, \ufffd) и запас на поля записи
+	constexpr std::size_t MaxEscapedSize = 6;
+	constexpr std::size_t MaxFieldsSize = 96;
+
+	/// @brief Длина допустимой последовательности UTF-8 из двух-четырех байтов с позиции at (0 - недопустимая).
+	/// Отклоняются лишние байты продолжения, избыточные формы, суррогаты и значения больше U+10FFFF
+	std::size_t Utf8Length(std::string_view text, std::size_t at) {
+		const unsigned char lead = static_cast<unsigned char>(text[at]);
+		std::size_t length = 0;
+		unsigned char low = 0x80;
+		unsigned char high = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF)
+			length = 2;
+		else if (lead >= 0xE0 && lead <= 0xEF) {
+			length = 3;
+			if (lead == 0xE0) low = 0xA0;
+			if (lead == 0xED) high = 0x9F;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4) {
+			length = 4;
+			if (lead == 0xF0) low = 0x90;
+			if (lead == 0xF4) high = 0x8F;
+		}
+		if (length == 0 || text.size() - at < length)
+			return 0;
+		// Ограничение диапазона относится только ко второму байту
+		for (std::size_t k = 1; k < length; ++k) {
+			const unsigned char next = static_cast<unsigned char>(text[at + k]);
+			if (next < (k == 1 ? low : 0x80) || next > (k == 1 ? high : 0xBF))
+				return 0;
+		}
+		return length;
+	}
+
+	/// @brief Запись в заранее выделенный конец строки: без проверки емкости на каждом фрагменте
+	struct Cursor {
+		char* at;
+
+		void Put(std::string_view text) {
+			std::memcpy(at, text.data(), text.size());
+			at += text.size();
+		}
+		void Put(char c) { *at++ = c; }
+
+		template<typename Integer>
+		void Number(Integer value) { at = std::to_chars(at, at + 24, value).ptr; }
+
+		/// @brief Строка JSON без кавычек: экранируются кавычка, обратная косая черта и управляющие символы.
+		/// Имена в Linux - произвольные байты: байт, не начинающий допустимую последовательность UTF-8, заменяется
+		/// на \ufffd, чтобы строка оставалась допустимым JSON
+		void Json(std::string_view text) {
+			constexpr char Hex[] = "0123456789abcdef";
+			for (std::size_t i = 0; i < text.size();) {
+				const unsigned char c = static_cast<unsigned char>(text[i]);
+				if (c >= 0x80) {
+					const std::size_t length = Utf8Length(text, i);
+					if (length == 0) {
+						Put("\\ufffd");
+						++i;
+						continue;
+					}
+					Put(text.substr(i, length));
+					i += length;
+					continue;
+				}
+				++i;
+				if (c >= 0x20 && c != '"' && c != '\\') {
+					*at++ = static_cast<char>(c);
+					continue;
+				}
+				*at++ = '\\';
+				switch (c) {
+				case '"': *at++ = '"'; break;
+				case '\\': *at++ = '\\'; break;
+				case '\n': *at++ = 'n'; break;
+				case '\t': *at++ = 't'; break;
+				case '\r': *at++ = 'r'; break;
+				default:
+					Put("u00");
+					*at++ = Hex[c >> 4];
+					*at++ = Hex[c & 0xF];
+				}
+			}
+		}
+
+		/// @brief Поле TSV: экранируются табуляция, переводы строки и обратная косая черта
+		void Tsv(std::string_view text) {
+			for (const char c : text) {
+				if (c != '\t' && c != '\n' && c != '\r' && c != '\\') {
+					*at++ = c;
+					continue;
+				}
+				*at++ = '\\';
+				*at++ = c == '\t' ? 't' : c == '\n' ? 'n' : c == '\r' ? 'r' : '\\';
+			}
+		}
+	};
+
+	/// @brief Место в конце out под fixed байт и text с экранированием; лишнее отдается в Finish
+	Cursor Reserve(std::string& out, std::size_t fixed, std::string_view text) {
+		const std::size_t start = out.size();
+		out.resize(start + fixed + MaxEscapedSize * text.size());
+		return Cursor{ &out[start] };
+	}
+
+	void Finish(std::string& out, const Cursor& cursor) {
+		out.resize(static_cast<std::size_t>(cursor.at - out.data()));
+	}
+
+	void AppendBinary(std::string& out, NodeType type, std::uint64_t size, std::int64_t mtime, std::string_view prefix, std::string_view name) {
+		const std::size_t pathLength = prefix.size() + name.size();
+		const std::size_t length = (sizeof(binary_output::RecordHeader) + pathLength + binary_output::Alignment - 1)
+			& ~(binary_output::Alignment - 1);
+		binary_output::RecordHeader header{};
+		header.length = static_cast<std::uint32_t>(length);
+		header.pathLength = static_cast<std::uint32_t>(pathLength);
+		header.size = size;
+		header.mtime = mtime;
+		header.type = static_cast<std::uint8_t>(type);
+		// Запись собирается на месте: заголовок, путь и нулевое дополнение
+		const std::size_t start = out.size();
+		out.resize(start + length, '\0');
+		char* record = &out[start];
+		std::memcpy(record, &header, sizeof(header));
+		record += sizeof(header);
+		std::memcpy(record, prefix.data(), prefix.size());
+		std::memcpy(record + prefix.size(), name.data(), name.size());
+	}
+}
+
+std::optional<OutputFormat> ParseOutputFormat(std::string_view name) {
+	if (name == "text")
+		return OutputFormat::Text;
+	if (name == "ndjson")
+		return OutputFormat::Ndjson;
+	if (name == "tsv")
+		return OutputFormat::Tsv;
+	if (name == "binary")
+		return OutputFormat::Binary;
+	return std::nullopt;
+}
+
+std::string_view StreamHeader(OutputFormat format) {
+	if (format == OutputFormat::Tsv)
+		return TsvHeader;
+	if (format == OutputFormat::Binary)
+		return BinaryHeader();
+	return {};
+}
+
+void AppendPathPrefix(std::string& out, OutputFormat format, std::string_view directoryPath) {
+	Cursor cursor = Reserve(out, 1, directoryPath);
+	if (format == OutputFormat::Ndjson)
+		cursor.Json(directoryPath);
+	else if (format == OutputFormat::Tsv)
+		cursor.Tsv(directoryPath);
+	else
+		cursor.Put(directoryPath);
+	if (NeedsSeparator(directoryPath))
+		cursor.Put('/');
+	Finish(out, cursor);
+}
+
+void AppendRecord(std::string& out, OutputFormat format, NodeType type, std::uint64_t size, std::int64_t mtime,
+	std::string_view prefix, std::string_view name) {
+	if (format == OutputFormat::Binary) {
+		AppendBinary(out, type, size, mtime, prefix, name);
+		return;
+	}
+	if (format == OutputFormat::Text)
+		return;
+	// Строка записи собирается на месте: удлинение строки на каждом фрагменте дороже самого форматирования
+	Cursor cursor = Reserve(out, prefix.size() + MaxFieldsSize, name);
+	if (format == OutputFormat::Ndjson) {
+		cursor.Put("{\"path\":\"");
+		cursor.Put(prefix);
+		cursor.Json(name);
+		cursor.Put("\",\"type\":\"");
+		cursor.Put(TypeName(type));
+		cursor.Put("\",\"size\":");
+		cursor.Number(size);
+		cursor.Put(",\"mtime\":");
+		if (mtime != 0)
+			cursor.Number(mtime);
+		else
+			cursor.Put("null");
+		cursor.Put("}\n");
+	}
+	else {
+		cursor.Put(TypeName(type));
+		cursor.Put('\t');
+		cursor.Number(size);
+		cursor.Put('\t');
+		if (mtime != 0)
+			cursor.Number(mtime);
+		cursor.Put('\t');
+		cursor.Put(prefix);
+		cursor.Tsv(name);
+		cursor.Put('\n');
+	}
+	Finish(out, cursor);
+}
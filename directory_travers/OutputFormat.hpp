@@ -0,0 +1,74 @@
+#pragma once
+#include "NodeTable.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// @brief Формат списков директорий
+enum class OutputFormat {
+	/// Текст с отступами и id потоков (как у operator<< для Directory)
+	Text,
+	/// Строка JSON на запись: {"path":...,"type":"file"|"dir","size":N,"mtime":N|null}.
+	/// Байты пути, не образующие UTF-8, выводятся как \ufffd
+	Ndjson,
+	/// Строка заголовка, затем строки "type\tsize\tmtime\tpath"; \t, \n, \r и \ в пути экранируются,
+	/// остальные байты пути выводятся как есть
+	Tsv,
+	/// Заголовок потока и записи с длиной (см. binary_output)
+	Binary,
+};
+
+/// @brief Разбор имени формата ("text", "ndjson", "tsv", "binary"); std::nullopt для неизвестного имени
+[[nodiscard]] std::optional<OutputFormat> ParseOutputFormat(std::string_view name);
+
+/// @brief Двоичный поток записей: заголовок StreamHeader, затем записи подряд до конца потока.
+/// Запись - RecordHeader и путь без завершающего нуля, дополненные нулями до кратного 8 размера,
+/// поэтому при отображении файла в память поля заголовков выровнены, а индекс строится проходом по длинам.
+/// Числа записаны в порядке байтов машины, который определяется по StreamHeader::byteOrder.
+namespace binary_output {
+	/// Сигнатура потока
+	constexpr char Magic[8] = { 'D', 'T', 'R', 'V', 'R', 'E', 'C', '\0' };
+	constexpr std::uint32_t Version = 1;
+	/// Значение byteOrder в порядке байтов писавшей машины
+	constexpr std::uint32_t ByteOrderMark = 0x01020304;
+	/// Выравнивание записей
+	constexpr std::size_t Alignment = 8;
+
+	/// @brief Заголовок потока
+	struct StreamHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byteOrder;
+	};
+
+	/// @brief Заголовок записи
+	struct RecordHeader {
+		/// Размер записи вместе с заголовком и дополнением (кратен Alignment)
+		std::uint32_t length;
+		/// Длина пути в байтах
+		std::uint32_t pathLength;
+		/// Размер файла (0 у директорий и у файлов, метаданные которых не удалось получить)
+		std::uint64_t size;
+		/// Время изменения в наносекундах от эпохи (0 - неизвестно)
+		std::int64_t mtime;
+		/// Значение NodeType
+		std::uint8_t type;
+		std::uint8_t reserved[7];
+	};
+
+	static_assert(sizeof(StreamHeader) % Alignment == 0 && sizeof(RecordHeader) % Alignment == 0, "headers keep records aligned");
+}
+
+/// @brief Байты, с которых начинается вывод формата (пусто, если заголовка нет)
+[[nodiscard]] std::string_view StreamHeader(OutputFormat format);
+
+/// @brief Путь директории в кодировке формата с разделителем на конце - общее начало путей всех записей списка,
+/// которое кодируется один раз на директорию
+void AppendPathPrefix(std::string& out, OutputFormat format, std::string_view directoryPath);
+
+/// @brief Добавление записи машиночитаемого формата (не OutputFormat::Text) в конец out.
+/// Путь записи - prefix из AppendPathPrefix того же формата и name; mtime 0 выводится как неизвестное.
+/// Байты имен, кроме управляющих символов, требующих экранирования и (в JSON) не образующих UTF-8, выводятся как есть.
+void AppendRecord(std::string& out, OutputFormat format, NodeType type, std::uint64_t size, std::int64_t mtime,
+	std::string_view prefix, std::string_view name);
@@ -0,0 +1,222 @@
+#include "OutputWriter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	/// Сколько блоков поток записи сбрасывает одним вызовом
+	constexpr std::size_t MaxBatch = 64;
+}
+
+OutputWriter::OutputWriter(std::size_t budget, Stats* stats) :
+	_budget(budget), _stats(stats) {
+	// Все, что уже выведено через std::cout, должно оказаться раньше результатов обхода
+	std::cout.flush();
+	_writer = std::thread([this] { WriterThread(); });
+}
+
+OutputWriter::~OutputWriter() {
+	Flush();
+	{
+		std::lock_guard<std::mutex> lock(_writerMutex);
+		_stop.store(true);
+	}
+	_writerCV.notify_one();
+	_writer.join();
+	for (Chunk* chunk : _freeChunks)
+		delete chunk;
+}
+
+OutputWriter::Slot& OutputWriter::LocalSlot() {
+	return _threadLocals.Local<Slot>([this] {
+		std::lock_guard<std::mutex> lock(_slotsMutex);
+		_slots.push_back(std::make_unique<Slot>());
+		return _slots.back().get();
+	});
+}
+
+OutputWriter::Chunk* OutputWriter::AcquireChunk(std::size_t capacity) {
+	if (capacity == ChunkSize) {
+		StatScope locked(_stats, StatTimer::ChunkPoolLock);
+		std::lock_guard<std::mutex> lock(_freeMutex);
+		if (!_freeChunks.empty()) {
+			Chunk* chunk = _freeChunks.back();
+			_freeChunks.pop_back();
+			return chunk;
+		}
+	}
+	auto* chunk = new Chunk;
+	chunk->_capacity = capacity;
+	chunk->_data = std::make_unique<char[]>(capacity);
+	return chunk;
+}
+
+void OutputWriter::Write(std::string_view record) {
+	Chunk*& chunk = LocalSlot()._chunk;
+	if (chunk != nullptr && chunk->_capacity - chunk->_size < record.size()) {
+		Submit(chunk);
+		chunk = nullptr;
+	}
+	// Запись больше блока получает собственный блок
+	if (chunk == nullptr)
+		chunk = AcquireChunk(std::max(ChunkSize, record.size()));
+	std::memcpy(chunk->_data.get() + chunk->_size, record.data(), record.size());
+	chunk->_size += record.size();
+}
+
+void OutputWriter::Submit(Chunk* chunk) {
+	const std::size_t size = chunk->_size;
+	// Обратное давление: ждем, пока поток записи не освободит место
+	// (в пустую очередь блок принимается всегда, даже если он больше лимита)
+	const std::size_t queued = _queuedBytes.load();
+	if (queued != 0 && queued + size > _budget) {
+		StatScope waiting(_stats, StatTimer::OutputBackpressure);
+		_spaceWaiters.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock(_spaceMutex);
+			_spaceCV.wait(lock, [this, size] {
+				const std::size_t current = _queuedBytes.load();
+				return current == 0 || current + size <= _budget;
+			});
+		}
+		_spaceWaiters.fetch_sub(1);
+	}
+	_queuedBytes.fetch_add(size);
+	_queue.Push(chunk);
+	_queuedChunks.fetch_add(1);
+	// Поток записи будим, только если он спит
+	if (_writerSleeping.load()) {
+		std::lock_guard<std::mutex> lock(_writerMutex);
+		_writerCV.notify_one();
+	}
+}
+
+void OutputWriter::Flush() {
+	{
+		std::lock_guard<std::mutex> lock(_slotsMutex);
+		for (auto& slot : _slots) {
+			if (slot->_chunk != nullptr) {
+				Submit(slot->_chunk);
+				slot->_chunk = nullptr;
+			}
+		}
+	}
+	_spaceWaiters.fetch_add(1);
+	{
+		std::unique_lock<std::mutex> lock(_spaceMutex);
+		_spaceCV.wait(lock, [this] { return _queuedBytes.load() == 0; });
+	}
+	_spaceWaiters.fetch_sub(1);
+}
+
+void OutputWriter::WriterThread() {
+	std::vector<Chunk*> batch;
+	batch.reserve(MaxBatch);
+	while (true) {
+		while (batch.size() < MaxBatch) {
+			Chunk* chunk = _queue.Pop();
+			if (chunk == nullptr)
+				break;
+			batch.push_back(chunk);
+		}
+		if (!batch.empty()) {
+			_queuedChunks.fetch_sub(batch.size());
+			WriteBatch(batch);
+			continue;
+		}
+		// Производитель еще не связал добавленный узел
+		if (_queuedChunks.load() != 0) {
+			std::this_thread::yield();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(_writerMutex);
+		_writerSleeping.store(true);
+		if (_queuedChunks.load() == 0) {
+			if (_stop.load()) {
+				_writerSleeping.store(false);
+				return;
+			}
+			_writerCV.wait(lock, [this] { return _queuedChunks.load() != 0 || _stop.load(); });
+		}
+		_writerSleeping.store(false);
+	}
+}
+
+void OutputWriter::WriteBatch(std::vector<Chunk*>& batch) {
+	std::size_t bytes = 0;
+#ifdef _WIN32
+	{
+		StatScope writing(_stats, StatTimer::OutputWrite);
+		for (Chunk* chunk : batch) {
+			std::fwrite(chunk->_data.get(), 1, chunk->_size, stdout);
+			bytes += chunk->_size;
+		}
+		std::fflush(stdout);
+	}
+	if (_stats != nullptr) {
+		_stats->Add(StatCounter::OutputWrites);
+		_stats->Add(StatCounter::OutputBytes, bytes);
+	}
+#else
+	iovec iov[MaxBatch];
+	const std::size_t count = batch.size();
+	for (std::size_t i = 0; i < count; ++i) {
+		iov[i].iov_base = batch[i]->_data.get();
+		iov[i].iov_len = batch[i]->_size;
+		bytes += batch[i]->_size;
+	}
+	StatScope writing(_stats, StatTimer::OutputWrite);
+	std::size_t first = 0;
+	while (first < count) {
+		const ssize_t written = ::writev(STDOUT_FILENO, iov + first, static_cast<int>(count - first));
+		if (_stats != nullptr)
+			_stats->Add(StatCounter::OutputWrites);
+		if (written <= 0) {
+			if (written < 0 && errno == EINTR)
+				continue;
+			// Вывод закрыт или недоступен: оставшиеся данные отбрасываются
+			break;
+		}
+		if (_stats != nullptr)
+			_stats->Add(StatCounter::OutputBytes, static_cast<std::uint64_t>(written));
+		// Частичная запись: пропускаем записанные блоки и сдвигаем начало недописанного
+		std::size_t left = static_cast<std::size_t>(written);
+		while (first < count && left >= iov[first].iov_len) {
+			left -= iov[first].iov_len;
+			++first;
+		}
+		if (first < count) {
+			iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+			iov[first].iov_len -= left;
+		}
+	}
+#endif
+	{
+		StatScope locked(_stats, StatTimer::ChunkPoolLock);
+		std::lock_guard<std::mutex> lock(_freeMutex);
+		for (Chunk* chunk : batch) {
+			if (chunk->_capacity == ChunkSize) {
+				chunk->_size = 0;
+				_freeChunks.push_back(chunk);
+			}
+			else {
+				delete chunk;
+			}
+		}
+	}
+	batch.clear();
+
+	_queuedBytes.fetch_sub(bytes);
+	if (_spaceWaiters.load() != 0) {
+		std::lock_guard<std::mutex> lock(_spaceMutex);
+		_spaceCV.notify_all();
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "MpscQueue.hpp"
+#include "Stats.hpp"
+#include "ThreadLocals.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// @brief Буферизованный вывод результатов обхода в stdout.
+/// Каждый поток копит текст в своем блоке; заполненный блок передается потоку записи
+/// через очередь без блокировок, и тот сбрасывает накопленные блоки одним вызовом writev.
+/// Объем переданных, но еще не записанных данных ограничен: при превышении лимита
+/// Write ждет, пока поток записи освободит место.
+class OutputWriter {
+public:
+	/// Размер блока потока
+	static constexpr std::size_t ChunkSize = 64 * 1024;
+	/// Лимит данных в очереди на запись по умолчанию
+	static constexpr std::size_t DefaultBudget = 8 * 1024 * 1024;
+
+	///@brief stats - учет записанных байтов, ожидания места в очереди и блокировок (nullptr - без учета)
+	explicit OutputWriter(std::size_t budget = DefaultBudget, Stats* stats = nullptr);
+
+	///@brief Деструктор: записывает все накопленное и останавливает поток записи
+	~OutputWriter();
+
+	OutputWriter(const OutputWriter&) = delete;
+	OutputWriter& operator=(const OutputWriter&) = delete;
+
+	///@brief Добавление записи в блок текущего потока.
+	/// Запись не разрывается между блоками, поэтому записи разных потоков не перемешиваются.
+	void Write(std::string_view record);
+
+	///@brief Передача неполных блоков всех потоков и ожидание их записи.
+	/// Вызывается, когда ни один поток не выполняет Write (например, после ThreadPool::Wait).
+	void Flush();
+
+private:
+	/// @brief Блок текста
+	struct Chunk {
+		std::atomic<Chunk*> _next{ nullptr };
+		std::size_t _size = 0;
+		std::size_t _capacity = 0;
+		std::unique_ptr<char[]> _data;
+	};
+
+	/// @brief Блок, в который пишет один поток
+	struct Slot {
+		Chunk* _chunk = nullptr;
+	};
+
+	//@brief Блок текущего потока (создается при первом обращении потока)
+	[[nodiscard]] Slot& LocalSlot();
+
+	//@brief Блок из списка свободных или новый
+	[[nodiscard]] Chunk* AcquireChunk(std::size_t capacity);
+
+	//@brief Передача блока потоку записи с учетом лимита
+	void Submit(Chunk* chunk);
+
+	//@brief Цикл потока записи
+	void WriterThread();
+
+	//@brief Запись набора блоков и возврат их в список свободных
+	void WriteBatch(std::vector<Chunk*>& batch);
+
+	///Лимит данных в очереди
+	const std::size_t _budget;
+	///Статистика (nullptr - без учета)
+	Stats* const _stats;
+
+	///Блоки потоков
+	std::vector<std::unique_ptr<Slot>> _slots;
+	std::mutex _slotsMutex;
+	///Поиск блока текущего потока
+	ThreadLocals _threadLocals;
+
+	///Очередь блоков на запись
+	MpscQueue<Chunk> _queue;
+	///Количество блоков в очереди
+	std::atomic<std::size_t> _queuedChunks{ 0 };
+	///Байты, переданные, но еще не записанные
+	std::atomic<std::size_t> _queuedBytes{ 0 };
+
+	///Ожидание потока записи
+	std::mutex _writerMutex;
+	std::condition_variable _writerCV;
+	std::atomic<bool> _writerSleeping{ false };
+	std::atomic<bool> _stop{ false };
+
+	///Ожидание места в очереди (обратное давление) и завершения записи в Flush
+	std::mutex _spaceMutex;
+	std::condition_variable _spaceCV;
+	std::atomic<unsigned int> _spaceWaiters{ 0 };
+
+	///Свободные блоки стандартного размера
+	std::vector<Chunk*> _freeChunks;
+	std::mutex _freeMutex;
+
+	std::thread _writer;
+};
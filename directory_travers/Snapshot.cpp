@@ -0,0 +1,330 @@
+#include "Snapshot.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#ifdef _WIN32
+#include <chrono>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	/// @brief Контрольная сумма заголовка: все поля до нее
+	std::uint64_t HeaderChecksum(const snapshot::Header& header) {
+		return Hash64(&header, offsetof(snapshot::Header, headerChecksum));
+	}
+
+	/// @brief Контрольная сумма разделов: хэш каждого засеян хэшем предыдущего
+	std::uint64_t BodyChecksum(const void* directories, std::size_t directoryBytes,
+		const void* entries, std::size_t entryBytes, const void* names, std::size_t nameBytes) {
+		std::uint64_t checksum = Hash64(directories, directoryBytes);
+		checksum = Hash64(entries, entryBytes, checksum);
+		return Hash64(names, nameBytes, checksum);
+	}
+}
+
+bool ReadStamp(const std::filesystem::path& directory, DirectoryStamp& stamp) {
+#ifdef _WIN32
+	std::error_code error;
+	const auto time = std::filesystem::last_write_time(directory, error);
+	if (error || !std::filesystem::is_directory(directory, error))
+		return false;
+	stamp = DirectoryStamp{};
+	stamp.mtime = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+	return true;
+#else
+	struct stat info {};
+	if (::stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+		return false;
+	stamp.device = static_cast<std::uint64_t>(info.st_dev);
+	stamp.inode = static_cast<std::uint64_t>(info.st_ino);
+	stamp.mtime = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+	stamp.ctime = static_cast<std::int64_t>(info.st_ctim.tv_sec) * 1000000000 + info.st_ctim.tv_nsec;
+	return true;
+#endif
+}
+
+std::uint64_t PathHash(const NodeTable& nodes, std::uint32_t node) {
+	// Цепочка до корня собирается снизу, хэшируется сверху
+	std::uint32_t chain[256];
+	std::size_t depth = 0;
+	std::vector<std::uint32_t> deep;
+	for (std::uint32_t current = node; current != NodeTable::NoParent; current = nodes[current].parent) {
+		if (depth < std::size(chain))
+			chain[depth++] = current;
+		else
+			deep.push_back(current);
+	}
+	std::uint64_t hash = 0;
+	for (auto it = deep.rbegin(); it != deep.rend(); ++it)
+		hash = Hash64(nodes.Name(nodes[*it]), hash);
+	while (depth > 0)
+		hash = Hash64(nodes.Name(nodes[chain[--depth]]), hash);
+	return hash;
+}
+
+SnapshotReader::SnapshotReader(const std::filesystem::path& file) {
+#ifdef _WIN32
+	std::ifstream input(file, std::ios::binary | std::ios::ate);
+	if (!input) {
+		_error = "cannot open " + file.string();
+		return;
+	}
+	const auto size = static_cast<std::size_t>(input.tellg());
+	_buffer.reset(new unsigned char[size == 0 ? 1 : size]);
+	input.seekg(0);
+	if (!input.read(reinterpret_cast<char*>(_buffer.get()), static_cast<std::streamsize>(size))) {
+		_error = "cannot read " + file.string();
+		return;
+	}
+	_data = _buffer.get();
+	_size = size;
+#else
+	const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		_error = "cannot open " + file.string() + ": " + std::strerror(errno);
+		return;
+	}
+	struct stat info {};
+	if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(snapshot::Header))) {
+		::close(fd);
+		_error = "snapshot is truncated";
+		return;
+	}
+	_size = static_cast<std::size_t>(info.st_size);
+	void* mapped = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// Отображение держит файл, дескриптор больше не нужен
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		_size = 0;
+		_error = "cannot map " + file.string() + ": " + std::strerror(errno);
+		return;
+	}
+	_data = static_cast<const unsigned char*>(mapped);
+#endif
+	if (!Validate(_size)) {
+		_directories = nullptr;
+		_entries = nullptr;
+		_names = nullptr;
+		_directoryCount = 0;
+		_flags = 0;
+	}
+}
+
+SnapshotReader::~SnapshotReader() {
+#ifndef _WIN32
+	if (_data != nullptr)
+		::munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+}
+
+bool SnapshotReader::Validate(std::size_t size) {
+	if (size < sizeof(snapshot::Header)) {
+		_error = "snapshot is truncated";
+		return false;
+	}
+	snapshot::Header header;
+	std::memcpy(&header, _data, sizeof(header));
+	if (std::memcmp(header.magic, snapshot::Magic, sizeof(header.magic)) != 0) {
+		_error = "not a snapshot file";
+		return false;
+	}
+	if (header.version != snapshot::Version || header.headerSize != sizeof(snapshot::Header)) {
+		_error = "unsupported snapshot version " + std::to_string(header.version);
+		return false;
+	}
+	if (header.headerChecksum != HeaderChecksum(header)) {
+		_error = "snapshot header is corrupted";
+		return false;
+	}
+	// Размеры разделов сверяются с размером файла без переполнения
+	const std::size_t available = size - sizeof(snapshot::Header);
+	if (header.directoryCount > available / sizeof(snapshot::Directory)
+		|| header.entryCount > available / sizeof(snapshot::Entry)
+		|| header.entryCount > NodeTable::NoParent
+		|| header.directoryCount * sizeof(snapshot::Directory) + header.entryCount * sizeof(snapshot::Entry) + header.nameBytes != available) {
+		_error = "snapshot size does not match its header";
+		return false;
+	}
+	const std::size_t directoryBytes = header.directoryCount * sizeof(snapshot::Directory);
+	const std::size_t entryBytes = header.entryCount * sizeof(snapshot::Entry);
+	const unsigned char* directories = _data + sizeof(snapshot::Header);
+	const unsigned char* entries = directories + directoryBytes;
+	const unsigned char* names = entries + entryBytes;
+	if (BodyChecksum(directories, directoryBytes, entries, entryBytes, names, header.nameBytes) != header.bodyChecksum) {
+		_error = "snapshot is corrupted (checksum mismatch)";
+		return false;
+	}
+
+	_directories = reinterpret_cast<const snapshot::Directory*>(directories);
+	_entries = reinterpret_cast<const snapshot::Entry*>(entries);
+	_names = reinterpret_cast<const char*>(names);
+	_directoryCount = header.directoryCount;
+	_flags = header.flags;
+	// Ссылки внутри файла проверяются один раз, чтобы Find и Load могли им доверять
+	for (std::uint64_t i = 0; i < header.directoryCount; ++i) {
+		const snapshot::Directory& directory = _directories[i];
+		if (static_cast<std::uint64_t>(directory.firstEntry) + directory.entryCount > header.entryCount
+			|| (i > 0 && _directories[i - 1].pathHash > directory.pathHash)) {
+			_error = "snapshot directory table is inconsistent";
+			return false;
+		}
+	}
+	for (std::uint64_t i = 0; i < header.entryCount; ++i) {
+		const snapshot::Entry& entry = _entries[i];
+		if (static_cast<std::uint64_t>(entry.nameOffset) + entry.nameLength > header.nameBytes
+			|| (entry.type != NodeType::File && entry.type != NodeType::Directory)) {
+			_error = "snapshot entry table is inconsistent";
+			return false;
+		}
+		// Имя копируется в буфер NAME_MAX + 1 и передается *at-вызовам: только одна компонента пути
+		const std::string_view name(_names + entry.nameOffset, entry.nameLength);
+		if (name.empty() || name.size() > snapshot::MaxNameLength || name == "." || name == ".."
+			|| name.find('/') != std::string_view::npos || name.find('\0') != std::string_view::npos) {
+			_error = "snapshot entry has an invalid name";
+			return false;
+		}
+	}
+	return true;
+}
+
+const snapshot::Directory* SnapshotReader::Find(std::uint64_t pathHash, const DirectoryStamp& stamp) const {
+	const snapshot::Directory* end = _directories + _directoryCount;
+	const snapshot::Directory* it = std::lower_bound(_directories, end, pathHash,
+		[](const snapshot::Directory& directory, std::uint64_t hash) { return directory.pathHash < hash; });
+	// Совпадение хэша без совпадения inode - другая директория
+	for (; it != end && it->pathHash == pathHash; ++it) {
+		if (it->device == stamp.device && it->inode == stamp.inode && it->mtime == stamp.mtime && it->ctime == stamp.ctime)
+			return it;
+	}
+	return nullptr;
+}
+
+void SnapshotReader::Load(const snapshot::Directory& directory, NodeTable& nodes, std::vector<NodeTable::Entry>& entries) const {
+	for (std::uint32_t i = 0; i < directory.entryCount; ++i) {
+		const snapshot::Entry& entry = _entries[directory.firstEntry + i];
+		entries.push_back({ entry.type, nodes.StoreName(std::string_view(_names + entry.nameOffset, entry.nameLength)), entry.size });
+	}
+}
+
+SnapshotWriter::SnapshotWriter(std::uint32_t flags) : _flags(flags) {}
+
+SnapshotWriter::~SnapshotWriter() = default;
+
+std::vector<SnapshotWriter::Visited>& SnapshotWriter::Local() {
+	return _threadLocals.Local<std::vector<Visited>>([this] {
+		std::lock_guard<std::mutex> lock(_localsMutex);
+		_locals.push_back(std::make_unique<std::vector<Visited>>());
+		return _locals.back().get();
+	});
+}
+
+void SnapshotWriter::Record(std::uint32_t node, std::uint32_t first, std::uint32_t count, const DirectoryStamp& stamp, bool reused) {
+	Local().push_back({ node, first, count, reused, stamp });
+}
+
+std::uint64_t SnapshotWriter::Directories() const {
+	std::lock_guard<std::mutex> lock(_localsMutex);
+	std::uint64_t total = 0;
+	for (const auto& local : _locals)
+		total += local->size();
+	return total;
+}
+
+std::uint64_t SnapshotWriter::Reused() const {
+	std::lock_guard<std::mutex> lock(_localsMutex);
+	std::uint64_t total = 0;
+	for (const auto& local : _locals)
+		total += static_cast<std::uint64_t>(std::count_if(local->begin(), local->end(), [](const Visited& visited) { return visited.reused; }));
+	return total;
+}
+
+bool SnapshotWriter::Save(const std::filesystem::path& file, const NodeTable& nodes, std::string& error) const {
+	std::vector<std::pair<std::uint64_t, const Visited*>> order;
+	{
+		std::lock_guard<std::mutex> lock(_localsMutex);
+		for (const auto& local : _locals) {
+			for (const Visited& visited : *local)
+				order.emplace_back(PathHash(nodes, visited.node), &visited);
+		}
+	}
+	std::sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+	std::vector<snapshot::Directory> directories;
+	std::vector<snapshot::Entry> entries;
+	std::string names;
+	directories.reserve(order.size());
+	for (const auto& [hash, visited] : order) {
+		snapshot::Directory directory{};
+		directory.pathHash = hash;
+		directory.device = visited->stamp.device;
+		directory.inode = visited->stamp.inode;
+		directory.mtime = visited->stamp.mtime;
+		directory.ctime = visited->stamp.ctime;
+		directory.firstEntry = static_cast<std::uint32_t>(entries.size());
+		directory.entryCount = visited->count;
+		for (std::uint32_t i = visited->first; i < visited->first + visited->count; ++i) {
+			const Node& node = nodes[i];
+			const std::string_view name = nodes.Name(node);
+			if (names.size() + name.size() > UINT32_MAX) {
+				error = "snapshot names exceed 4 GiB";
+				return false;
+			}
+			snapshot::Entry entry{};
+			entry.size = node.size;
+			entry.nameOffset = static_cast<std::uint32_t>(names.size());
+			entry.nameLength = static_cast<std::uint16_t>(name.size());
+			entry.type = node.type;
+			entries.push_back(entry);
+			names += name;
+			if (node.type == NodeType::Directory)
+				++directory.subdirectories;
+		}
+		directories.push_back(directory);
+	}
+
+	snapshot::Header header{};
+	std::memcpy(header.magic, snapshot::Magic, sizeof(header.magic));
+	header.version = snapshot::Version;
+	header.headerSize = sizeof(snapshot::Header);
+	header.directoryCount = directories.size();
+	header.entryCount = entries.size();
+	header.nameBytes = names.size();
+	header.flags = _flags;
+	header.bodyChecksum = BodyChecksum(directories.data(), directories.size() * sizeof(snapshot::Directory),
+		entries.data(), entries.size() * sizeof(snapshot::Entry), names.data(), names.size());
+	header.headerChecksum = HeaderChecksum(header);
+
+	// Прежний снимок заменяется только полностью записанным
+	std::filesystem::path temporary = file;
+	temporary += ".tmp";
+	std::FILE* output = std::fopen(temporary.string().c_str(), "wb");
+	if (output == nullptr) {
+		error = "cannot create " + temporary.string();
+		return false;
+	}
+	bool written = std::fwrite(&header, sizeof(header), 1, output) == 1;
+	written = written && (directories.empty() || std::fwrite(directories.data(), sizeof(snapshot::Directory), directories.size(), output) == directories.size());
+	written = written && (entries.empty() || std::fwrite(entries.data(), sizeof(snapshot::Entry), entries.size(), output) == entries.size());
+	written = written && (names.empty() || std::fwrite(names.data(), 1, names.size(), output) == names.size());
+	written = (std::fclose(output) == 0) && written;
+	std::error_code renameError;
+	if (written)
+		std::filesystem::rename(temporary, file, renameError);
+	if (!written || renameError) {
+		std::filesystem::remove(temporary, renameError);
+		error = "cannot write " + file.string();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include "NodeTable.hpp"
+#include "ThreadLocals.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Отметка директории: по ней решается, можно ли взять список из снимка.
+/// Добавление, удаление и переименование записи меняют mtime и ctime директории,
+/// а устройство и inode отличают директорию от другой с тем же путем и совпавшим хэшем.
+struct DirectoryStamp {
+	std::uint64_t device = 0;
+	std::uint64_t inode = 0;
+	/// Наносекунды от эпохи
+	std::int64_t mtime = 0;
+	std::int64_t ctime = 0;
+};
+
+///@brief Отметка директории по пути (false, если путь недоступен).
+/// В Windows известно только время изменения.
+[[nodiscard]] bool ReadStamp(const std::filesystem::path& directory, DirectoryStamp& stamp);
+
+///@brief Хэш пути директории: хэш имени, засеянный хэшем родителя (корень - путь целиком).
+/// Полный путь не строится, поэтому цепочка хэшируется так же быстро, как имена.
+[[nodiscard]] std::uint64_t PathHash(const NodeTable& nodes, std::uint32_t node);
+
+/// @brief Формат файла снимка (все числа в порядке байтов little-endian, версия 1):
+/// заголовок, директории по возрастанию хэша пути, записи директорий подряд, имена записей подряд.
+/// Заголовок защищен своей контрольной суммой, остальной файл - общей; размер файла должен
+/// точно совпадать с размерами разделов из заголовка.
+namespace snapshot {
+	constexpr char Magic[8] = { 'D', 'T', 'S', 'N', 'A', 'P', '\r', '\n' };
+	constexpr std::uint32_t Version = 1;
+
+	/// Наибольшая длина имени записи (NAME_MAX в Linux)
+	constexpr std::uint16_t MaxNameLength = 255;
+
+	/// Флаг: символические ссылки на директории раскрывались (списки такого снимка не подходят обходу без раскрытия)
+	constexpr std::uint32_t FollowsSymlinks = 1u << 0;
+
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t headerSize;
+		std::uint64_t directoryCount;
+		std::uint64_t entryCount;
+		std::uint64_t nameBytes;
+		std::uint64_t bodyChecksum;
+		/// snapshot::FollowsSymlinks и т.п.
+		std::uint32_t flags;
+		std::uint32_t reserved;
+		/// Хэш предыдущих полей заголовка
+		std::uint64_t headerChecksum;
+	};
+
+	struct Directory {
+		std::uint64_t pathHash;
+		std::uint64_t device;
+		std::uint64_t inode;
+		std::int64_t mtime;
+		std::int64_t ctime;
+		std::uint32_t firstEntry;
+		std::uint32_t entryCount;
+		/// Сколько записей - поддиректории (0 - директорию можно не открывать)
+		std::uint32_t subdirectories;
+		std::uint32_t reserved;
+	};
+
+	struct Entry {
+		std::uint64_t size;
+		std::uint32_t nameOffset;
+		std::uint16_t nameLength;
+		NodeType type;
+		std::uint8_t reserved;
+	};
+
+	static_assert(sizeof(Header) == 64 && sizeof(Directory) == 56 && sizeof(Entry) == 16, "snapshot layout must not depend on the compiler");
+}
+
+/// @brief Снимок предыдущего обхода, отображенный в память только для чтения.
+/// Файл проверяется целиком при открытии; поврежденный, усеченный или снимок другой версии
+/// не используется (Valid() == false, причина в Error()), и обход читает все директории заново.
+class SnapshotReader {
+public:
+	explicit SnapshotReader(const std::filesystem::path& file);
+	~SnapshotReader();
+
+	SnapshotReader(const SnapshotReader&) = delete;
+	SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+	[[nodiscard]] bool Valid() const { return _error.empty(); }
+	[[nodiscard]] const std::string& Error() const { return _error; }
+
+	///@brief Директория с тем же путем и неизменной отметкой (nullptr, если ее нужно прочитать)
+	[[nodiscard]] const snapshot::Directory* Find(std::uint64_t pathHash, const DirectoryStamp& stamp) const;
+
+	///@brief Добавление записей директории из снимка в конец entries; имена копируются в арену потока
+	void Load(const snapshot::Directory& directory, NodeTable& nodes, std::vector<NodeTable::Entry>& entries) const;
+
+	///@brief Количество директорий в снимке
+	[[nodiscard]] std::uint64_t Directories() const { return _directoryCount; }
+
+	///@brief Флаги обхода, записавшего снимок
+	[[nodiscard]] std::uint32_t Flags() const { return _flags; }
+
+private:
+	//@brief Проверка заголовка, размеров и контрольных сумм
+	bool Validate(std::size_t size);
+
+	/// Содержимое файла (отображение или буфер в Windows)
+	const unsigned char* _data = nullptr;
+	std::size_t _size = 0;
+	std::unique_ptr<unsigned char[]> _buffer;
+
+	const snapshot::Directory* _directories = nullptr;
+	const snapshot::Entry* _entries = nullptr;
+	const char* _names = nullptr;
+	std::uint64_t _directoryCount = 0;
+	std::uint32_t _flags = 0;
+	std::string _error;
+};
+
+/// @brief Запись снимка текущего обхода.
+/// Во время обхода каждый поток запоминает прочитанные директории в своем списке без синхронизации;
+/// имена и размеры записей уже лежат в таблице узлов, поэтому Save собирает файл из нее после обхода.
+class SnapshotWriter {
+public:
+	///@brief flags - флаги обхода (snapshot::FollowsSymlinks), сохраняемые в заголовке
+	explicit SnapshotWriter(std::uint32_t flags = 0);
+	~SnapshotWriter();
+
+	SnapshotWriter(const SnapshotWriter&) = delete;
+	SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+	///@brief Директория node с записями [first, first + count) и отметкой, снятой до чтения списка.
+	/// reused - список взят из предыдущего снимка.
+	void Record(std::uint32_t node, std::uint32_t first, std::uint32_t count, const DirectoryStamp& stamp, bool reused);
+
+	///@brief Запись снимка после обхода: во временный файл рядом, затем переименование,
+	/// чтобы прерванная запись не испортила прежний снимок. false и причина в error при ошибке.
+	[[nodiscard]] bool Save(const std::filesystem::path& file, const NodeTable& nodes, std::string& error) const;
+
+	///@brief Количество записанных директорий и взятых из предыдущего снимка (после обхода)
+	[[nodiscard]] std::uint64_t Directories() const;
+	[[nodiscard]] std::uint64_t Reused() const;
+
+private:
+	/// @brief Прочитанная директория
+	struct Visited {
+		std::uint32_t node;
+		std::uint32_t first;
+		std::uint32_t count;
+		bool reused;
+		DirectoryStamp stamp;
+	};
+
+	//@brief Список текущего потока (создается при первом обращении)
+	[[nodiscard]] std::vector<Visited>& Local();
+
+	const std::uint32_t _flags;
+	///Списки потоков
+	std::vector<std::unique_ptr<std::vector<Visited>>> _locals;
+	mutable std::mutex _localsMutex;
+	///Поиск списка текущего потока
+	ThreadLocals _threadLocals;
+};
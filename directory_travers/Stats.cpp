@@ -0,0 +1,193 @@
+#include "Stats.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+
+namespace {
+	constexpr const char* CounterNames[] = {
+		"tasks_run", "tasks_stolen", "tasks_stolen_remote", "tasks_injected", "parks",
+		"directories_read", "entries_read", "inodes_revisited", "open_failures", "output_bytes", "output_writes",
+	};
+	constexpr const char* TimerNames[] = {
+		"task_run", "queue_wait", "inject_lock", "directory_open",
+		"directory_read", "output_backpressure", "chunk_pool_lock", "output_write",
+	};
+	static_assert(std::size(CounterNames) == static_cast<std::size_t>(StatCounter::Count), "every counter needs a name");
+	static_assert(std::size(TimerNames) == static_cast<std::size_t>(StatTimer::Count), "every timer needs a name");
+
+	/// @brief Значение владельца слота
+	std::uint64_t Load(const std::atomic<std::uint64_t>& value) {
+		return value.load(std::memory_order_relaxed);
+	}
+
+	/// @brief Увеличение значения владельцем слота (без read-modify-write)
+	void Increase(std::atomic<std::uint64_t>& value, std::uint64_t delta) {
+		value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+
+	/// @brief Номер корзины длительности: количество значащих битов
+	std::size_t Bucket(std::uint64_t nanoseconds) {
+		if (nanoseconds == 0)
+			return 0;
+#if defined(__GNUC__) || defined(__clang__)
+		const std::size_t bits = 64 - static_cast<std::size_t>(__builtin_clzll(nanoseconds));
+#else
+		std::size_t bits = 0;
+		for (; nanoseconds != 0; nanoseconds >>= 1)
+			++bits;
+#endif
+		return std::min(bits, StatTimerTotals::Buckets - 1);
+	}
+
+	/// @brief Число с фиксированной точностью
+	std::string Fixed(double value, int precision) {
+		char text[64];
+		std::snprintf(text, sizeof(text), "%.*f", precision, value);
+		return text;
+	}
+
+	/// @brief Количество в секунду
+	double Rate(std::uint64_t count, double seconds) {
+		return seconds > 0 ? static_cast<double>(count) / seconds : 0.0;
+	}
+}
+
+std::uint64_t StatTimerTotals::Percentile(double fraction) const {
+	if (count == 0)
+		return 0;
+	const double target = fraction * static_cast<double>(count);
+	std::uint64_t seen = 0;
+	for (std::size_t b = 0; b < Buckets; ++b) {
+		seen += buckets[b];
+		if (static_cast<double>(seen) >= target) {
+			// В последней корзине и все более длинные интервалы: ее граница - максимум
+			const std::uint64_t upper = b + 1 == Buckets ? maxNs : (1ull << b) - 1;
+			return std::min(upper, maxNs);
+		}
+	}
+	return maxNs;
+}
+
+Stats::Stats() : _start(std::chrono::steady_clock::now()) {}
+
+Stats::~Stats() = default;
+
+Stats::Slot& Stats::Local() {
+	return _threadLocals.Local<Slot>([this] {
+		std::lock_guard<std::mutex> lock(_slotsMutex);
+		_slots.push_back(std::make_unique<Slot>());
+		return _slots.back().get();
+	});
+}
+
+void Stats::Add(StatCounter counter, std::uint64_t value) {
+	Increase(Local()._counters[static_cast<std::size_t>(counter)], value);
+}
+
+void Stats::Record(StatTimer timer, std::uint64_t nanoseconds) {
+	TimerSlot& slot = Local()._timers[static_cast<std::size_t>(timer)];
+	Increase(slot._count, 1);
+	Increase(slot._totalNs, nanoseconds);
+	if (nanoseconds > Load(slot._maxNs))
+		slot._maxNs.store(nanoseconds, std::memory_order_relaxed);
+	Increase(slot._buckets[Bucket(nanoseconds)], 1);
+}
+
+StatsReport Stats::Collect() const {
+	StatsReport report;
+	report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+	std::lock_guard<std::mutex> lock(_slotsMutex);
+	report.threads.reserve(_slots.size());
+	for (const auto& slot : _slots) {
+		auto& thread = report.threads.emplace_back();
+		for (std::size_t c = 0; c < thread.size(); ++c) {
+			thread[c] = Load(slot->_counters[c]);
+			report.counters[c] += thread[c];
+		}
+		for (std::size_t t = 0; t < report.timers.size(); ++t) {
+			const TimerSlot& from = slot->_timers[t];
+			StatTimerTotals& to = report.timers[t];
+			to.count += Load(from._count);
+			to.totalNs += Load(from._totalNs);
+			to.maxNs = std::max(to.maxNs, Load(from._maxNs));
+			for (std::size_t b = 0; b < StatTimerTotals::Buckets; ++b)
+				to.buckets[b] += Load(from._buckets[b]);
+		}
+	}
+	return report;
+}
+
+std::string StatsReport::Table() const {
+	std::ostringstream out;
+	const std::uint64_t directories = Get(StatCounter::DirectoriesRead);
+	const std::uint64_t entries = Get(StatCounter::EntriesRead);
+	out << "Wall time:    " << Fixed(wallSeconds, 3) << " s\n";
+	out << "Directories:  " << directories << " (" << Fixed(Rate(directories, wallSeconds), 0) << "/s)\n";
+	out << "Entries:      " << entries << " (" << Fixed(Rate(entries, wallSeconds), 0) << "/s)\n";
+	if (Get(StatCounter::InodesRevisited) != 0)
+		out << "Revisited:    " << Get(StatCounter::InodesRevisited) << " directories and hardlinks skipped\n";
+	if (Get(StatCounter::OpenFailures) != 0)
+		out << "Unreadable:   " << Get(StatCounter::OpenFailures) << " directories could not be read\n";
+	out << "Output:       " << Fixed(static_cast<double>(Get(StatCounter::OutputBytes)) / (1024.0 * 1024.0), 2)
+		<< " MiB in " << Get(StatCounter::OutputWrites) << " writes\n";
+	out << "Tasks:        " << Get(StatCounter::TasksRun) << " run, " << Get(StatCounter::TasksStolen) << " stolen ("
+		<< Get(StatCounter::TasksStolenRemote) << " from other nodes), " << Get(StatCounter::TasksInjected) << " injected, " << Get(StatCounter::Parks) << " parks\n";
+
+	// Равномерность распределения задач по потокам, выполнявшим задачи
+	std::uint64_t least = ~0ull;
+	std::uint64_t most = 0;
+	std::size_t workers = 0;
+	for (const auto& thread : threads) {
+		const std::uint64_t run = thread[static_cast<std::size_t>(StatCounter::TasksRun)];
+		if (run == 0)
+			continue;
+		least = std::min(least, run);
+		most = std::max(most, run);
+		++workers;
+	}
+	if (workers != 0)
+		out << "Per thread:   " << least << ".." << most << " tasks over " << workers << " threads\n";
+
+	out << "\ntimer                     count    total ms     mean us      p50 us      p99 us      max us\n";
+	for (std::size_t t = 0; t < timers.size(); ++t) {
+		const StatTimerTotals& timer = timers[t];
+		if (timer.count == 0)
+			continue;
+		char line[160];
+		std::snprintf(line, sizeof(line), "%-20s %10llu %11.3f %11.3f %11.3f %11.3f %11.3f\n", TimerNames[t],
+			static_cast<unsigned long long>(timer.count), static_cast<double>(timer.totalNs) / 1e6,
+			static_cast<double>(timer.totalNs) / static_cast<double>(timer.count) / 1e3,
+			static_cast<double>(timer.Percentile(0.5)) / 1e3, static_cast<double>(timer.Percentile(0.99)) / 1e3,
+			static_cast<double>(timer.maxNs) / 1e3);
+		out << line;
+	}
+	return out.str();
+}
+
+std::string StatsReport::Json() const {
+	std::ostringstream out;
+	out << "{\n  \"wall_seconds\": " << Fixed(wallSeconds, 6) << ",\n";
+	out << "  \"directories_per_second\": " << Fixed(Rate(Get(StatCounter::DirectoriesRead), wallSeconds), 1) << ",\n";
+	out << "  \"entries_per_second\": " << Fixed(Rate(Get(StatCounter::EntriesRead), wallSeconds), 1) << ",\n";
+	out << "  \"counters\": {";
+	for (std::size_t c = 0; c < counters.size(); ++c)
+		out << (c == 0 ? "\n" : ",\n") << "    \"" << CounterNames[c] << "\": " << counters[c];
+	out << "\n  },\n  \"timers\": {";
+	for (std::size_t t = 0; t < timers.size(); ++t) {
+		const StatTimerTotals& timer = timers[t];
+		out << (t == 0 ? "\n" : ",\n") << "    \"" << TimerNames[t] << "\": { \"count\": " << timer.count
+			<< ", \"total_ns\": " << timer.totalNs << ", \"p50_ns\": " << timer.Percentile(0.5)
+			<< ", \"p90_ns\": " << timer.Percentile(0.9) << ", \"p99_ns\": " << timer.Percentile(0.99)
+			<< ", \"max_ns\": " << timer.maxNs << " }";
+	}
+	out << "\n  },\n  \"threads\": [";
+	for (std::size_t i = 0; i < threads.size(); ++i) {
+		out << (i == 0 ? "\n" : ",\n") << "    {";
+		for (std::size_t c = 0; c < threads[i].size(); ++c)
+			out << (c == 0 ? " " : ", ") << '"' << CounterNames[c] << "\": " << threads[i][c];
+		out << " }";
+	}
+	out << "\n  ]\n}\n";
+	return out.str();
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include "ThreadLocals.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief Счетчики обхода
+enum class StatCounter : unsigned {
+	/// Выполненные задачи пула
+	TasksRun,
+	/// Задачи, перехваченные у другого потока
+	TasksStolen,
+	/// Из них перехваченные у потока или из очереди другого узла NUMA
+	TasksStolenRemote,
+	/// Задачи, взятые из общей очереди
+	TasksInjected,
+	/// Парковки потоков без работы
+	Parks,
+	/// Прочитанные директории (включая взятые из снимка)
+	DirectoriesRead,
+	/// Записи прочитанных директорий
+	EntriesRead,
+	/// Директории и файлы с жесткими ссылками, пропущенные как уже посещенные (--dedupe)
+	InodesRevisited,
+	/// Директории, которые не удалось открыть или дочитать
+	OpenFailures,
+	/// Байты, записанные в stdout
+	OutputBytes,
+	/// Вызовы записи в stdout
+	OutputWrites,
+	Count,
+};
+
+/// @brief Измеряемые интервалы
+enum class StatTimer : unsigned {
+	/// Выполнение задачи пула (выборка: замеряется каждая 16-я задача потока)
+	TaskRun,
+	/// Поиск работы: от неудачной попытки взять задачу до получения следующей (включая парковку)
+	QueueWait,
+	/// Захват и удержание мьютекса общей очереди узла
+	InjectLock,
+	/// Открытие директории
+	DirectoryOpen,
+	/// Чтение списка директории (getdents, directory_iterator, statx записей или загрузка из снимка)
+	DirectoryRead,
+	/// Ожидание места в очереди вывода (обратное давление)
+	OutputBackpressure,
+	/// Захват и удержание мьютекса списка свободных блоков вывода
+	ChunkPoolLock,
+	/// Вызов записи в stdout
+	OutputWrite,
+	Count,
+};
+
+/// @brief Итоги одного интервала: количество, сумма, максимум и гистограмма по степеням двойки
+struct StatTimerTotals {
+	/// Корзина b: длительности от 2^(b-1) до 2^b - 1 наносекунд (корзина 0 - ноль, последняя - все от 2^62)
+	static constexpr std::size_t Buckets = 64;
+
+	std::uint64_t count = 0;
+	std::uint64_t totalNs = 0;
+	std::uint64_t maxNs = 0;
+	std::array<std::uint64_t, Buckets> buckets{};
+
+	///@brief Оценка перцентиля сверху (верхняя граница корзины, не больше максимума)
+	[[nodiscard]] std::uint64_t Percentile(double fraction) const;
+};
+
+/// @brief Итоги всех потоков
+struct StatsReport {
+	std::array<std::uint64_t, static_cast<std::size_t>(StatCounter::Count)> counters{};
+	std::array<StatTimerTotals, static_cast<std::size_t>(StatTimer::Count)> timers{};
+	/// Счетчики каждого потока, учтенного статистикой
+	std::vector<std::array<std::uint64_t, static_cast<std::size_t>(StatCounter::Count)>> threads;
+	/// Время от создания статистики до сбора итогов
+	double wallSeconds = 0;
+
+	[[nodiscard]] std::uint64_t Get(StatCounter counter) const { return counters[static_cast<std::size_t>(counter)]; }
+	[[nodiscard]] const StatTimerTotals& Get(StatTimer timer) const { return timers[static_cast<std::size_t>(timer)]; }
+
+	///@brief Таблица для человека
+	[[nodiscard]] std::string Table() const;
+
+	///@brief То же в JSON
+	[[nodiscard]] std::string Json() const;
+};
+
+/// @brief Статистика обхода и пула.
+/// Каждый поток пишет в свой слот, выровненный по строке кэша, поэтому потоки не делят строки кэша
+/// и не выполняют атомарных read-modify-write: владелец слота обновляет значения relaxed load/store,
+/// а Collect складывает слоты всех потоков. Объекты, которым статистика не передана (nullptr),
+/// не читают часы и не обращаются к слотам.
+class Stats {
+public:
+	Stats();
+	~Stats();
+
+	Stats(const Stats&) = delete;
+	Stats& operator=(const Stats&) = delete;
+
+	///@brief Увеличение счетчика текущего потока
+	void Add(StatCounter counter, std::uint64_t value = 1);
+
+	///@brief Учет интервала текущего потока
+	void Record(StatTimer timer, std::uint64_t nanoseconds);
+
+	///@brief Итоги всех потоков. Точны, когда учитываемая работа завершена (например, после ThreadPool::Wait)
+	[[nodiscard]] StatsReport Collect() const;
+
+private:
+	/// @brief Интервал в слоте потока
+	struct TimerSlot {
+		std::atomic<std::uint64_t> _count{ 0 };
+		std::atomic<std::uint64_t> _totalNs{ 0 };
+		std::atomic<std::uint64_t> _maxNs{ 0 };
+		std::atomic<std::uint64_t> _buckets[StatTimerTotals::Buckets] = {};
+	};
+
+	/// @brief Слот потока; занимает целые строки кэша
+	struct alignas(64) Slot {
+		std::atomic<std::uint64_t> _counters[static_cast<std::size_t>(StatCounter::Count)] = {};
+		TimerSlot _timers[static_cast<std::size_t>(StatTimer::Count)];
+	};
+
+	//@brief Слот текущего потока (создается при первом обращении)
+	[[nodiscard]] Slot& Local();
+
+	///Слоты потоков (живут до разрушения статистики: поток мог завершиться раньше сбора итогов)
+	std::vector<std::unique_ptr<Slot>> _slots;
+	mutable std::mutex _slotsMutex;
+	///Поиск слота текущего потока
+	ThreadLocals _threadLocals;
+	///Время создания (начало отсчета wallSeconds)
+	const std::chrono::steady_clock::time_point _start;
+};
+
+/// @brief Измерение интервала на время жизни объекта (ничего не делает без статистики)
+class StatScope {
+public:
+	StatScope(Stats* stats, StatTimer timer) : _stats(stats), _timer(timer) {
+		if (_stats != nullptr)
+			_begin = std::chrono::steady_clock::now();
+	}
+	~StatScope() { Stop(); }
+
+	///@brief Завершение интервала до конца жизни объекта
+	void Stop() {
+		if (_stats != nullptr)
+			_stats->Record(_timer, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - _begin).count()));
+		_stats = nullptr;
+	}
+
+	StatScope(const StatScope&) = delete;
+	StatScope& operator=(const StatScope&) = delete;
+
+private:
+	Stats* _stats;
+	StatTimer _timer;
+	std::chrono::steady_clock::time_point _begin;
+};
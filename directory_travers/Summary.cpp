@@ -0,0 +1,182 @@
+#include "Summary.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+	/// @brief Размер в стиле du -h: 512, 4.0K, 12M
+	void AppendSize(std::string& out, std::uint64_t bytes) {
+		static const char Units[] = "KMGTPE";
+		char text[32];
+		if (bytes < 1024) {
+			std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(bytes));
+		}
+		else {
+			double value = static_cast<double>(bytes) / 1024.0;
+			std::size_t unit = 0;
+			while (value >= 1024.0 && unit + 1 < sizeof(Units) - 1) {
+				value /= 1024.0;
+				++unit;
+			}
+			std::snprintf(text, sizeof(text), value < 10.0 ? "%.1f%c" : "%.0f%c", value, Units[unit]);
+		}
+		out += text;
+	}
+
+	/// @brief Время изменения в локальном времени ("-", если неизвестно)
+	void AppendTime(std::string& out, std::int64_t nanoseconds) {
+		if (nanoseconds == 0) {
+			out += '-';
+			return;
+		}
+		const std::time_t seconds = static_cast<std::time_t>(nanoseconds / 1000000000);
+		// Отчет строится одним потоком, поэтому std::localtime допустим
+		const std::tm* local = std::localtime(&seconds);
+		char text[32];
+		if (local == nullptr || std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M", local) == 0) {
+			out += '-';
+			return;
+		}
+		out += text;
+	}
+}
+
+SummaryTable::SummaryTable() :
+	_segments(new std::atomic<std::atomic<DirectorySummary*>*>[MaxSegments]) {
+	for (std::size_t i = 0; i < MaxSegments; ++i)
+		_segments[i].store(nullptr, std::memory_order_relaxed);
+}
+
+SummaryTable::~SummaryTable() {
+	// Итоги принадлежат блокам потоков, сегменты хранят только указатели
+	for (std::size_t i = 0; i < MaxSegments; ++i)
+		delete[] _segments[i].load(std::memory_order_relaxed);
+}
+
+DirectorySummary* SummaryTable::Allocate(std::size_t count) {
+	Accumulator& local = _threadLocals.Local<Accumulator>([this] {
+		std::lock_guard<std::mutex> lock(_accumulatorsMutex);
+		_accumulators.push_back(std::make_unique<Accumulator>());
+		return _accumulators.back().get();
+	});
+	if (local.blocks.empty() || local.capacity.back() - local.used.back() < count) {
+		const std::size_t size = std::max(BlockSize, count);
+		local.blocks.push_back(std::make_unique<DirectorySummary[]>(size));
+		local.used.push_back(0);
+		local.capacity.push_back(size);
+	}
+	DirectorySummary* summaries = local.blocks.back().get() + local.used.back();
+	local.used.back() += count;
+	return summaries;
+}
+
+DirectorySummary* SummaryTable::Get(std::uint32_t node) const {
+	const std::atomic<DirectorySummary*>* segment = _segments[node >> SegmentShift].load(std::memory_order_acquire);
+	return segment == nullptr ? nullptr : segment[node & (SegmentSize - 1)].load(std::memory_order_acquire);
+}
+
+void SummaryTable::Set(std::uint32_t node, DirectorySummary* summary) {
+	auto& slot = _segments[node >> SegmentShift];
+	std::atomic<DirectorySummary*>* segment = slot.load(std::memory_order_acquire);
+	if (segment == nullptr) {
+		// Сегмент выделяет первый, кому он понадобился; проигравший освобождает свой
+		auto* fresh = new std::atomic<DirectorySummary*>[SegmentSize];
+		for (std::uint32_t k = 0; k < SegmentSize; ++k)
+			fresh[k].store(nullptr, std::memory_order_relaxed);
+		if (slot.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel))
+			segment = fresh;
+		else
+			delete[] fresh;
+	}
+	segment[node & (SegmentSize - 1)].store(summary, std::memory_order_release);
+}
+
+void SummaryTable::AddRoot(std::uint32_t node) {
+	DirectorySummary* root = Allocate(1);
+	root->_node = node;
+	Set(node, root);
+}
+
+void SummaryTable::AddListing(std::uint32_t node, std::uint32_t first, const std::vector<NodeTable::Entry>& entries) {
+	DirectorySummary* summary = Get(node);
+	// Итоги файлов копятся локально: других потоков здесь нет
+	Totals own;
+	for (const NodeTable::Entry& entry : entries) {
+		if (entry.type != NodeType::File) {
+			++own.directories;
+			continue;
+		}
+		own.bytes += entry.size;
+		++own.files;
+		if (entry.mtime > own.newest)
+			own.newest = entry.mtime;
+	}
+	// Итоги поддиректорий - один кусок блока текущего потока
+	DirectorySummary* children = own.directories == 0 ? nullptr : Allocate(own.directories);
+	std::uint32_t child = 0;
+	for (std::uint32_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].type == NodeType::File)
+			continue;
+		DirectorySummary& created = children[child++];
+		created._node = first + i;
+		created._depth = summary->_depth + 1;
+		created._parent = summary;
+		Set(first + i, &created);
+	}
+	summary->_children = children;
+	summary->_childCount = child;
+	summary->_own = own;
+	// Задачи поддиректорий еще не поставлены, поэтому счетчик никто не уменьшает
+	summary->_pending.fetch_add(child, std::memory_order_relaxed);
+	Complete(summary);
+}
+
+void SummaryTable::Complete(DirectorySummary* summary) const {
+	while (summary != nullptr && summary->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		// Последняя часть директории: итоги поддиректорий уже записаны их потоками
+		Totals subtree = summary->_own;
+		for (std::uint32_t i = 0; i < summary->_childCount; ++i)
+			subtree += summary->_children[i]._subtree;
+		summary->_subtree = subtree;
+		summary = summary->_parent;
+	}
+}
+
+const DirectorySummary* SummaryTable::Find(std::uint32_t node) const {
+	return Get(node);
+}
+
+std::string SummaryTable::Report(const NodeTable& nodes, std::uint32_t maxDepth, std::uint32_t top) const {
+	// Отчет строится после обхода: блоки потоков больше не меняются
+	std::vector<const DirectorySummary*> rows;
+	for (const auto& local : _accumulators) {
+		for (std::size_t block = 0; block < local->blocks.size(); ++block) {
+			for (std::size_t k = 0; k < local->used[block]; ++k) {
+				const DirectorySummary* summary = &local->blocks[block][k];
+				if (summary->_depth <= maxDepth)
+					rows.push_back(summary);
+			}
+		}
+	}
+	const std::size_t count = std::min<std::size_t>(rows.size(), top);
+	const auto bySize = [](const DirectorySummary* lhs, const DirectorySummary* rhs) {
+		if (lhs->_subtree.bytes != rhs->_subtree.bytes)
+			return lhs->_subtree.bytes > rhs->_subtree.bytes;
+		return lhs->_node < rhs->_node;
+	};
+	std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(count), rows.end(), bySize);
+
+	std::string out = "size\tfiles\tnewest\tpath\n";
+	for (std::size_t i = 0; i < count; ++i) {
+		const Totals& totals = rows[i]->_subtree;
+		AppendSize(out, totals.bytes);
+		out += '\t';
+		out += std::to_string(totals.files);
+		out += '\t';
+		AppendTime(out, totals.newest);
+		out += '\t';
+		nodes.AppendPath(out, rows[i]->_node);
+		out += '\n';
+	}
+	return out;
+}
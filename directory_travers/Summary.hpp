@@ -0,0 +1,114 @@
+#pragma once
+#include "NodeTable.hpp"
+#include "ThreadLocals.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief Итоги директории: кажущийся размер, количество файлов и поддиректорий, самое новое mtime
+struct Totals {
+	std::uint64_t bytes = 0;
+	std::uint64_t files = 0;
+	std::uint64_t directories = 0;
+	/// Наносекунды от эпохи (0 - неизвестно)
+	std::int64_t newest = 0;
+
+	Totals& operator+=(const Totals& other) {
+		bytes += other.bytes;
+		files += other.files;
+		directories += other.directories;
+		if (other.newest > newest)
+			newest = other.newest;
+		return *this;
+	}
+};
+
+/// @brief Итоги одной директории и ее поддерева
+struct DirectorySummary {
+	/// Незавершенные части: собственный список и поддеревья поддиректорий
+	std::atomic<std::uint32_t> _pending{ 1 };
+	/// Узел директории
+	std::uint32_t _node = 0;
+	/// Глубина от корня (корень - 0)
+	std::uint32_t _depth = 0;
+	/// Количество поддиректорий
+	std::uint32_t _childCount = 0;
+	/// Итоги поддиректорий подряд, в порядке записей
+	DirectorySummary* _children = nullptr;
+	DirectorySummary* _parent = nullptr;
+	/// Записи самой директории
+	Totals _own;
+	/// Все поддерево; заполняется, когда поддерево завершено
+	Totals _subtree;
+};
+
+/// @brief Сводка в стиле du, собираемая во время обхода.
+/// Итоги директорий лежат в блоках потоков: поток, прочитавший директорию, берет итоги всех ее поддиректорий
+/// одним куском из своего блока без блокировок и выделения памяти на директорию, а файлы суммирует
+/// в локальные итоги без атомарных операций.
+/// Атомарен только счетчик незавершенных частей директории (одна операция на директорию, не на файл):
+/// поток, обнуливший его, складывает итоги поддиректорий (они записаны до их уменьшения счетчика)
+/// и переходит к родителю, поэтому итоги поднимаются снизу вверх по мере завершения поддеревьев.
+class SummaryTable {
+public:
+	/// Без ограничения глубины или количества строк
+	static constexpr std::uint32_t Unlimited = std::numeric_limits<std::uint32_t>::max();
+
+	SummaryTable();
+	~SummaryTable();
+
+	SummaryTable(const SummaryTable&) = delete;
+	SummaryTable& operator=(const SummaryTable&) = delete;
+
+	///@brief Регистрация корня обхода
+	void AddRoot(std::uint32_t node);
+
+	///@brief Учет записей директории [first, first + entries.size()).
+	/// Вызывается до постановки задач поддиректорий; директория без поддиректорий завершается сразу.
+	void AddListing(std::uint32_t node, std::uint32_t first, const std::vector<NodeTable::Entry>& entries);
+
+	///@brief Итоги директории (nullptr для файлов и незарегистрированных узлов)
+	[[nodiscard]] const DirectorySummary* Find(std::uint32_t node) const;
+
+	///@brief Отчет: директории не глубже maxDepth, по убыванию размера, не больше top строк.
+	/// Строка: размер, количество файлов, самое новое mtime, путь.
+	[[nodiscard]] std::string Report(const NodeTable& nodes, std::uint32_t maxDepth = Unlimited, std::uint32_t top = Unlimited) const;
+
+private:
+	/// Итогов в блоке потока (больший кусок получает собственный блок)
+	static constexpr std::size_t BlockSize = 4096;
+
+	/// @brief Блоки итогов одного потока: выделяет только владелец, после обхода читает Report
+	struct Accumulator {
+		std::vector<std::unique_ptr<DirectorySummary[]>> blocks;
+		/// Занято и всего итогов в каждом блоке
+		std::vector<std::size_t> used;
+		std::vector<std::size_t> capacity;
+	};
+
+	static constexpr unsigned SegmentShift = 16;
+	static constexpr std::uint32_t SegmentSize = 1u << SegmentShift;
+	static constexpr std::size_t MaxSegments = std::size_t(1) << (32 - SegmentShift);
+
+	[[nodiscard]] DirectorySummary* Get(std::uint32_t node) const;
+	void Set(std::uint32_t node, DirectorySummary* summary);
+
+	//@brief Завершение части директории и подъем к родителям, чьи поддеревья завершены
+	void Complete(DirectorySummary* summary) const;
+
+	//@brief count итогов подряд из блока текущего потока
+	[[nodiscard]] DirectorySummary* Allocate(std::size_t count);
+
+	///Сегменты указателей на итоги по индексу узла
+	std::unique_ptr<std::atomic<std::atomic<DirectorySummary*>*>[]> _segments;
+	///Блоки потоков
+	std::vector<std::unique_ptr<Accumulator>> _accumulators;
+	std::mutex _accumulatorsMutex;
+	///Поиск блоков текущего потока
+	ThreadLocals _threadLocals;
+};
@@ -0,0 +1,116 @@
+#include "SyntheticFileSystem.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+	/// Глубина хранится в старших битах дескриптора, хэш пути - в остальных
+	constexpr unsigned DepthShift = 56;
+	constexpr std::uint64_t PathMask = (1ull << DepthShift) - 1;
+
+	/// Соли хэша для независимых величин одной директории или записи
+	constexpr std::uint64_t FileSalt = 0xF11E;
+	constexpr std::uint64_t SizeSalt = 0x512E;
+	constexpr std::uint64_t TimeSalt = 0x71AE;
+
+	/// Во сколько раз количество может превышать среднее
+	constexpr double MaxSkewFactor = 4096;
+	/// Размеры файлов меньше 1 МиБ, mtime - в пределах года от 2024-01-01
+	constexpr std::uint64_t MaxFileSize = 1024 * 1024;
+	constexpr std::int64_t BaseTime = 1704067200ll * 1000000000;
+	constexpr std::uint64_t TimeRange = 365ull * 24 * 3600 * 1000000000;
+
+	[[nodiscard]] std::uint64_t Mix(std::uint64_t value, std::uint64_t salt) {
+		return Hash64(&value, sizeof(value), salt);
+	}
+
+	[[nodiscard]] unsigned DepthOf(FileSystem::Handle directory) {
+		return static_cast<unsigned>(directory >> DepthShift);
+	}
+
+	/// @brief Имя из префикса, номера и суффикса без выделения памяти
+	[[nodiscard]] std::string_view MakeName(char (&buffer)[32], std::string_view prefix, std::uint32_t index, std::string_view suffix) {
+		std::copy(prefix.begin(), prefix.end(), buffer);
+		char* end = std::to_chars(buffer + prefix.size(), buffer + sizeof(buffer), index).ptr;
+		end = std::copy(suffix.begin(), suffix.end(), end);
+		return std::string_view(buffer, static_cast<std::size_t>(end - buffer));
+	}
+
+	/// @brief Задержка операции: короткая - активным ожиданием, длинная - сном
+	void Delay(std::chrono::nanoseconds latency) {
+		if (latency.count() <= 0)
+			return;
+		if (latency >= SyntheticFileSystem::SpinThreshold) {
+			std::this_thread::sleep_for(latency);
+			return;
+		}
+		const auto deadline = std::chrono::steady_clock::now() + latency;
+		while (std::chrono::steady_clock::now() < deadline) {
+		}
+	}
+}
+
+SyntheticFileSystem::SyntheticFileSystem(const SyntheticTreeOptions& options) : _options(options) {
+	if (!(options.skew >= 0 && options.skew < 1))
+		throw std::invalid_argument("SyntheticTreeOptions::skew must be in [0, 1)");
+	if (options.depth > 255)
+		throw std::invalid_argument("SyntheticTreeOptions::depth must not exceed 255");
+}
+
+FileSystem::Handle SyntheticFileSystem::Root() const {
+	return Mix(_options.seed, 0) & PathMask;
+}
+
+FileSystem::Handle SyntheticFileSystem::Child(Handle directory, std::uint32_t index) {
+	const std::uint64_t depth = DepthOf(directory) + 1;
+	return (depth << DepthShift) | (Mix(directory, index) & PathMask);
+}
+
+std::uint32_t SyntheticFileSystem::Skewed(unsigned mean, std::uint64_t hash) const {
+	if (_options.skew == 0 || mean == 0)
+		return mean;
+	// Равномерное значение в (0, 1] из старших 53 битов хэша
+	const double uniform = (static_cast<double>(hash >> 11) + 1.0) / 9007199254740992.0;
+	// Парето: минимум mean * (1 - skew), среднее mean
+	const double value = static_cast<double>(mean) * (1.0 - _options.skew) * std::pow(uniform, -_options.skew);
+	return static_cast<std::uint32_t>(std::min(value, static_cast<double>(mean) * MaxSkewFactor) + 0.5);
+}
+
+SyntheticFileSystem::Counts SyntheticFileSystem::CountsOf(Handle directory) const {
+	return { DepthOf(directory) < _options.depth ? _options.fanout : 0, Skewed(_options.files, Mix(directory, FileSalt)) };
+}
+
+bool SyntheticFileSystem::ReadDirectory(Handle directory, NodeTable& nodes, std::vector<NodeTable::Entry>& entries, std::vector<Handle>& children) {
+	const Counts counts = CountsOf(directory);
+	Delay(_options.directoryLatency + _options.entryLatency * (counts.subdirectories + counts.files));
+
+	char name[32];
+	for (std::uint32_t i = 0; i < counts.subdirectories; ++i) {
+		entries.push_back({ NodeType::Directory, nodes.StoreName(MakeName(name, "dir_", i, "")), 0 });
+		children.push_back(Child(directory, i));
+	}
+	for (std::uint32_t i = 0; i < counts.files; ++i) {
+		const std::uint64_t file = Mix(directory, FileSalt + 1 + i);
+		entries.push_back({ NodeType::File, nodes.StoreName(MakeName(name, "file_", i, ".dat")),
+			Mix(file, SizeSalt) % MaxFileSize, BaseTime + static_cast<std::int64_t>(Mix(file, TimeSalt) % TimeRange) });
+	}
+	return true;
+}
+
+SyntheticTreeSize SyntheticFileSystem::Size() const {
+	SyntheticTreeSize size;
+	std::vector<Handle> pending{ Root() };
+	while (!pending.empty()) {
+		const Handle directory = pending.back();
+		pending.pop_back();
+		const Counts counts = CountsOf(directory);
+		++size.directories;
+		size.files += counts.files;
+		for (std::uint32_t i = 0; i < counts.subdirectories; ++i)
+			pending.push_back(Child(directory, i));
+	}
+	return size;
+}
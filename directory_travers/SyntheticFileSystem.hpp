@@ -0,0 +1,74 @@
+#pragma once
+#include "FileSystem.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Параметры синтетического дерева
+struct SyntheticTreeOptions {
+	/// Уровни поддиректорий под корнем (0 - только корень)
+	unsigned depth = 4;
+	/// Количество поддиректорий директории (кроме последнего уровня)
+	unsigned fanout = 8;
+	/// Среднее количество файлов директории
+	unsigned files = 32;
+	/// Неравномерность количества файлов от 0 (у всех директорий ровно files) до 1 (не включая):
+	/// количество распределено по Парето с показателем 1 / skew при том же среднем (не больше 4096 средних),
+	/// то есть немногие директории очень велики. Количество поддиректорий от нее не зависит,
+	/// поэтому число директорий дерева одинаково при любой неравномерности
+	double skew = 0;
+	/// Зерно генератора: одинаковые параметры дают одинаковое дерево
+	std::uint64_t seed = 1;
+	/// Задержка чтения директории (открытие и getdents)
+	std::chrono::nanoseconds directoryLatency{ 0 };
+	/// Дополнительная задержка на каждую запись (stat)
+	std::chrono::nanoseconds entryLatency{ 0 };
+};
+
+/// @brief Размер синтетического дерева
+struct SyntheticTreeSize {
+	std::uint64_t directories = 0;
+	std::uint64_t files = 0;
+};
+
+/// @brief Файловая система в памяти: дерево не хранится, а порождается по дескриптору директории.
+/// Дескриптор содержит глубину и хэш пути, из которого выводятся количества записей, имена ("dir_N", "file_N.dat"),
+/// размеры и mtime, поэтому дерево из миллионов записей не занимает памяти, а обход воспроизводим
+/// и не зависит от диска. Задержки от SpinThreshold выдерживаются сном и моделируют блокирующий ввод-вывод
+/// (потоки ждут одновременно даже на одном ядре); меньшие - активным ожиданием, как работа ядра
+/// над кэшированными метаданными (sleep_for округлил бы их до десятков микросекунд).
+class SyntheticFileSystem : public FileSystem {
+public:
+	static constexpr std::chrono::nanoseconds SpinThreshold{ 100000 };
+
+	///@brief Неверные параметры (skew вне [0, 1), depth больше 255) - std::invalid_argument
+	explicit SyntheticFileSystem(const SyntheticTreeOptions& options);
+
+	[[nodiscard]] Handle Root() const override;
+	[[nodiscard]] std::string RootPath() const override { return "synthetic"; }
+	bool ReadDirectory(Handle directory, NodeTable& nodes, std::vector<NodeTable::Entry>& entries, std::vector<Handle>& children) override;
+
+	///@brief Количество директорий (включая корень) и файлов дерева; считается без имен и задержек
+	[[nodiscard]] SyntheticTreeSize Size() const;
+
+	[[nodiscard]] const SyntheticTreeOptions& Options() const { return _options; }
+
+private:
+	/// @brief Количества записей директории
+	struct Counts {
+		std::uint32_t subdirectories;
+		std::uint32_t files;
+	};
+
+	//@brief Количества записей директории по ее дескриптору
+	[[nodiscard]] Counts CountsOf(Handle directory) const;
+
+	//@brief Дескриптор поддиректории index
+	[[nodiscard]] static Handle Child(Handle directory, std::uint32_t index);
+
+	//@brief Количество файлов со средним mean и разбросом по skew для равномерного значения из хэша
+	[[nodiscard]] std::uint32_t Skewed(unsigned mean, std::uint64_t hash) const;
+
+	const SyntheticTreeOptions _options;
+};
@@ -0,0 +1,36 @@
+#include "ThreadLocals.hpp"
+#include <atomic>
+#include <cstddef>
+
+namespace {
+	/// Номера экземпляров; 0 - пустая запись кэша
+	std::atomic<std::uint64_t> g_nextId{ 1 };
+
+	/// Сколько экземпляров поток помнит одновременно
+	constexpr std::size_t CacheSize = 8;
+
+	/// @brief Запись кэша потока
+	struct CacheEntry {
+		std::uint64_t id = 0;
+		void* local = nullptr;
+	};
+
+	/// Кэш потока: последние экземпляры, к которым он обращался, и запись для следующей замены
+	thread_local CacheEntry t_cache[CacheSize];
+	thread_local std::size_t t_next = 0;
+}
+
+ThreadLocals::ThreadLocals() : _id(g_nextId.fetch_add(1, std::memory_order_relaxed)) {}
+
+void* ThreadLocals::Cached() const {
+	for (const CacheEntry& entry : t_cache) {
+		if (entry.id == _id)
+			return entry.local;
+	}
+	return nullptr;
+}
+
+void ThreadLocals::Remember(void* local) const {
+	t_cache[t_next] = { _id, local };
+	t_next = (t_next + 1) % CacheSize;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief Объекты потоков одного экземпляра (блок вывода, арена имен, счетчики статистики).
+/// Объект создается один раз на пару (поток, экземпляр) и живет столько, сколько его хранит владелец.
+/// Поток помнит объекты нескольких последних экземпляров в thread_local и ищет их по номеру экземпляра,
+/// поэтому чередование экземпляров не требует блокировки; при промахе объект ищется под мьютексом
+/// по идентификатору потока, так что новый создается только для потока, который еще не обращался к экземпляру.
+class ThreadLocals {
+public:
+	ThreadLocals();
+
+	ThreadLocals(const ThreadLocals&) = delete;
+	ThreadLocals& operator=(const ThreadLocals&) = delete;
+
+	/// @brief Объект текущего потока. create() возвращает T*, которым владеет вызывающий экземпляр;
+	/// вызывается под мьютексом один раз на поток
+	template<typename T, typename Create>
+	[[nodiscard]] T& Local(Create&& create) {
+		void* local = Cached();
+		if (local == nullptr) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			const std::thread::id self = std::this_thread::get_id();
+			for (const auto& [thread, object] : _threads) {
+				if (thread == self)
+					local = object;
+			}
+			if (local == nullptr) {
+				local = static_cast<T*>(create());
+				_threads.emplace_back(self, local);
+			}
+			Remember(local);
+		}
+		return *static_cast<T*>(local);
+	}
+
+private:
+	//@brief Объект этого экземпляра из кэша потока (nullptr - нет в кэше)
+	[[nodiscard]] void* Cached() const;
+
+	//@brief Запоминание объекта в кэше потока
+	void Remember(void* local) const;
+
+	///Номер экземпляра (ключ кэша потока; номера не повторяются)
+	const std::uint64_t _id;
+	///Объекты по потокам
+	std::vector<std::pair<std::thread::id, void*>> _threads;
+	std::mutex _mutex;
+};
@@ -0,0 +1,360 @@
+#include "ThreadPool.hpp"
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+	/// Сколько раз поток ищет работу перед парковкой
+	constexpr int SpinRounds = 64;
+
+	/// Рабочий поток и пул текущего потока (nullptr вне пула)
+	thread_local void* t_pool = nullptr;
+	thread_local void* t_worker = nullptr;
+
+	/// Время выполнения замеряется у каждой TaskSampling-й задачи потока
+	constexpr unsigned TaskSampling = 16;
+	thread_local unsigned t_taskSample = 0;
+
+	/// Объектов задач в одном блоке и в одном пополнении списка потока;
+	/// список больше TaskCacheLimit отдает половину в общий запас
+	constexpr std::size_t TaskBlockSize = 256;
+	constexpr std::size_t TaskCacheLimit = 2 * TaskBlockSize;
+
+	/// @brief Генератор xorshift для выбора жертвы
+	std::uint64_t NextRandom(std::uint64_t& state) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	/// @brief Закрепление текущего потока за процессором.
+	/// Ошибка (процессор отключили после планирования размещения) не мешает работе: поток остается незакрепленным
+	void PinCurrentThread(int cpu) {
+#ifdef __linux__
+		if (cpu < 0 || cpu >= CPU_SETSIZE)
+			return;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		(void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+		(void)cpu;
+#endif
+	}
+}
+
+std::optional<SchedulingPolicy> ParseSchedulingPolicy(std::string_view name) {
+	if (name == "dfs")
+		return SchedulingPolicy::DepthFirst;
+	if (name == "bfs")
+		return SchedulingPolicy::BreadthFirst;
+	if (name == "hybrid")
+		return SchedulingPolicy::Hybrid;
+	return std::nullopt;
+}
+
+ThreadPool::ThreadPool(unsigned int threadPool, std::chrono::milliseconds debugSleep, Stats* stats,
+	SchedulingPolicy policy, std::size_t pendingLimit, const WorkerPlacement& placement) :
+	_threadPool(threadPool), _debugSleep(std::move(debugSleep)),
+	_stats(stats), _policy(policy), _pendingLimit(pendingLimit) {
+	const bool placed = !placement.cpus.empty() || !placement.nodes.empty();
+	if (placed && (placement.cpus.size() != _threadPool || placement.nodes.size() != _threadPool || placement.nodeCount == 0))
+		throw std::invalid_argument("WorkerPlacement must describe every worker thread");
+	const unsigned nodeCount = placed ? placement.nodeCount : 1;
+	for (unsigned i = 0; i < nodeCount; ++i)
+		_queues.push_back(std::make_unique<NodeQueue>());
+	_nodeWorkers.resize(nodeCount);
+	// Нулевой дек принадлежит потоку, вызывающему Wait: у него нет собственного std::thread
+	_workers.reserve(_threadPool + 1);
+	for (unsigned int i = 0; i <= _threadPool; ++i) {
+		auto worker = std::make_unique<Worker>();
+		worker->_random = 0x9E3779B97F4A7C15ull * (i + 1);
+		if (placed && i != 0) {
+			if (placement.nodes[i - 1] >= nodeCount)
+				throw std::invalid_argument("WorkerPlacement node is out of range");
+			worker->_node = placement.nodes[i - 1];
+			worker->_cpu = placement.cpus[i - 1];
+		}
+		_nodeWorkers[worker->_node].push_back(worker.get());
+		_workers.push_back(std::move(worker));
+	}
+	// Потоки запускаются после создания всех деков, чтобы перехват не видел недостроенный вектор
+	for (std::size_t i = 1; i < _workers.size(); ++i) {
+		Worker* current = _workers[i].get();
+		current->_thread = std::thread([this, current] { WorkerThread(*current); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	// Оставшиеся задачи выполняются с участием текущего потока (в пуле без потоков - только им)
+	if (t_pool != this)
+		Wait();
+	{
+		// Захватываем мьютекс, чтобы спящие потоки не пропустили сигнал
+		std::lock_guard<std::mutex> lock(_parkMutex);
+		_stop.store(true);
+		_epoch.fetch_add(1);
+	}
+	_parkCV.notify_all();
+	// Дожидаемся завершения всех потоков в пуле
+	for (auto& worker : _workers) {
+		if (worker->_thread.joinable()) worker->_thread.join();
+	}
+}
+
+void ThreadPool::Wait() {
+	if (t_pool == this)
+		throw std::logic_error("ThreadPool::Wait called from a pool task");
+	Worker& caller = *_workers.front();
+	// Wait может вызываться из задачи другого пула: его состояние восстанавливается на выходе
+	void* const outerPool = std::exchange(t_pool, this);
+	void* const outerWorker = std::exchange(t_worker, &caller);
+	while (_pending.load(std::memory_order_acquire) != 0) {
+		if (Task* task = FindTask(caller)) {
+			RunTask(task);
+			continue;
+		}
+		if (!Park(true))
+			break;
+	}
+	t_pool = outerPool;
+	t_worker = outerWorker;
+}
+
+void ThreadPool::Push(Task* item) {
+	const std::size_t pending = _pending.fetch_add(1, std::memory_order_relaxed) + 1;
+	std::size_t peak = _peakPending.load(std::memory_order_relaxed);
+	while (pending > peak && !_peakPending.compare_exchange_weak(peak, pending, std::memory_order_relaxed)) {
+	}
+	if (t_pool == this && t_worker != nullptr) {
+		// Задача из рабочего потока остается в его деке
+		static_cast<Worker*>(t_worker)->_deque.Push(item);
+	}
+	else {
+		NodeQueue& queue = _queues.size() == 1 ? *_queues.front()
+			: *_queues[_nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size()];
+		StatScope locked(_stats, StatTimer::InjectLock);
+		std::lock_guard<std::mutex> lock(queue._mutex);
+		queue._tasks.push_back(item);
+		queue._count.fetch_add(1, std::memory_order_release);
+	}
+	WakeOne();
+}
+
+void ThreadPool::WakeOne() {
+	// Пара к барьеру в WorkerThread: либо поток увидит задачу, либо мы увидим спящего
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_sleepers.load(std::memory_order_relaxed) == 0)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(_parkMutex);
+		_epoch.fetch_add(1, std::memory_order_relaxed);
+	}
+	_parkCV.notify_one();
+}
+
+void ThreadPool::WakeAll() {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_sleepers.load(std::memory_order_relaxed) == 0)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(_parkMutex);
+		_epoch.fetch_add(1, std::memory_order_relaxed);
+	}
+	_parkCV.notify_all();
+}
+
+void ThreadPool::RunTask(Task* task) {
+	// Выполнение задачи
+	{
+		// Время выполнения замеряется у каждой TaskSampling-й задачи потока: чтение часов дороже пустой задачи
+		const bool timed = _stats != nullptr && ++t_taskSample % TaskSampling == 0;
+		StatScope running(timed ? _stats : nullptr, StatTimer::TaskRun);
+		task->_run(*task);
+	}
+	if (_stats != nullptr)
+		_stats->Add(StatCounter::TasksRun);
+	FreeTask(task);
+	// Последняя задача будит ожидающий поток (и рабочие потоки после сигнала остановки)
+	if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		WakeAll();
+}
+
+bool ThreadPool::Park(bool caller) {
+	// Объявляем себя спящим, затем перепроверяем очереди
+	_sleepers.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const std::uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+	bool keepRunning = true;
+	if (!HasVisibleWork()) {
+		std::unique_lock<std::mutex> lock(_parkMutex);
+		// Вызывающему потоку достаточно отсутствия задач, рабочему нужен еще и сигнал остановки
+		if (_pending.load(std::memory_order_acquire) == 0 && (caller || _stop.load())) {
+			keepRunning = false;
+		}
+		else {
+			if (_stats != nullptr)
+				_stats->Add(StatCounter::Parks);
+			_parkCV.wait(lock, [this, epoch] { return _epoch.load(std::memory_order_relaxed) != epoch; });
+		}
+	}
+	_sleepers.fetch_sub(1, std::memory_order_relaxed);
+	return keepRunning;
+}
+
+ThreadPool::TaskCache& ThreadPool::LocalCache() {
+	return _threadLocals.Local<TaskCache>([this] {
+		std::lock_guard<std::mutex> lock(_tasksMutex);
+		_taskCaches.push_back(std::make_unique<TaskCache>());
+		return _taskCaches.back().get();
+	});
+}
+
+ThreadPool::Task* ThreadPool::AllocateTask() {
+	TaskCache& cache = LocalCache();
+	if (cache._free == nullptr) {
+		// Пополнение из общего запаса, а если он пуст - новым блоком
+		std::lock_guard<std::mutex> lock(_tasksMutex);
+		for (std::size_t i = 0; i < TaskBlockSize && _spareTasks != nullptr; ++i) {
+			Task* task = _spareTasks;
+			_spareTasks = task->_next;
+			task->_next = cache._free;
+			cache._free = task;
+			++cache._count;
+		}
+		if (cache._free == nullptr) {
+			_taskBlocks.push_back(std::make_unique<Task[]>(TaskBlockSize));
+			Task* block = _taskBlocks.back().get();
+			for (std::size_t i = 0; i < TaskBlockSize; ++i) {
+				block[i]._next = cache._free;
+				cache._free = &block[i];
+			}
+			cache._count += TaskBlockSize;
+		}
+	}
+	Task* task = cache._free;
+	cache._free = task->_next;
+	--cache._count;
+	return task;
+}
+
+void ThreadPool::FreeTask(Task* task) {
+	TaskCache& cache = LocalCache();
+	task->_next = cache._free;
+	cache._free = task;
+	// Задачи, созданные одним потоком и выполненные другим, не должны копиться у выполнившего
+	if (++cache._count > TaskCacheLimit) {
+		std::lock_guard<std::mutex> lock(_tasksMutex);
+		for (std::size_t i = 0; i < TaskCacheLimit / 2; ++i) {
+			Task* spare = cache._free;
+			cache._free = spare->_next;
+			spare->_next = _spareTasks;
+			_spareTasks = spare;
+		}
+		cache._count -= TaskCacheLimit / 2;
+	}
+}
+
+ThreadPool::Task* ThreadPool::FindTask(Worker& worker) {
+	// Свой дек: с конца - вглубь, с начала - по уровням
+	if (Task* task = _policy == SchedulingPolicy::BreadthFirst ? worker._deque.Steal() : worker._deque.Pop())
+		return task;
+
+	// Сначала работа своего узла, затем остальных по порядку: задачи других узлов несут чужие кэш-линии
+	const unsigned nodes = static_cast<unsigned>(_queues.size());
+	for (unsigned k = 0; k < nodes; ++k) {
+		const unsigned node = (worker._node + k) % nodes;
+		Task* task = TakeQueued(*_queues[node]);
+		if (task == nullptr)
+			task = StealFrom(node, worker);
+		if (task != nullptr) {
+			if (k != 0 && _stats != nullptr)
+				_stats->Add(StatCounter::TasksStolenRemote);
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+ThreadPool::Task* ThreadPool::TakeQueued(NodeQueue& queue) {
+	if (queue._count.load(std::memory_order_acquire) == 0)
+		return nullptr;
+	StatScope locked(_stats, StatTimer::InjectLock);
+	std::lock_guard<std::mutex> lock(queue._mutex);
+	if (queue._tasks.empty())
+		return nullptr;
+	Task* task = queue._tasks.front();
+	queue._tasks.pop_front();
+	queue._count.fetch_sub(1, std::memory_order_relaxed);
+	if (_stats != nullptr)
+		_stats->Add(StatCounter::TasksInjected);
+	return task;
+}
+
+ThreadPool::Task* ThreadPool::StealFrom(unsigned node, Worker& thief) {
+	const std::vector<Worker*>& victims = _nodeWorkers[node];
+	const std::size_t count = victims.size();
+	if (count == 0)
+		return nullptr;
+	const std::size_t start = static_cast<std::size_t>(NextRandom(thief._random) % count);
+	for (std::size_t k = 0; k < count; ++k) {
+		Worker& victim = *victims[(start + k) % count];
+		if (&victim == &thief)
+			continue;
+		if (Task* task = victim._deque.Steal()) {
+			if (_stats != nullptr)
+				_stats->Add(StatCounter::TasksStolen);
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+bool ThreadPool::HasVisibleWork() const {
+	for (const auto& queue : _queues) {
+		if (queue->_count.load(std::memory_order_acquire) > 0)
+			return true;
+	}
+	for (const auto& worker : _workers) {
+		if (!worker->_deque.Empty())
+			return true;
+	}
+	return false;
+}
+
+void ThreadPool::WorkerThread(Worker& worker) {
+	t_pool = this;
+	t_worker = &worker;
+	PinCurrentThread(worker._cpu);
+	bool searching = false;
+	std::chrono::steady_clock::time_point searchStart;
+	while (true) {
+		Task* task = FindTask(worker);
+		if (task == nullptr && _stats != nullptr && !searching) {
+			// Ожидание работы считается от первой неудачной попытки до следующей найденной задачи
+			searching = true;
+			searchStart = std::chrono::steady_clock::now();
+		}
+		for (int spin = 0; task == nullptr && spin < SpinRounds; ++spin) {
+			std::this_thread::yield();
+			task = FindTask(worker);
+		}
+		if (task != nullptr) {
+			if (searching) {
+				searching = false;
+				_stats->Record(StatTimer::QueueWait, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - searchStart).count()));
+			}
+			RunTask(task);
+			continue;
+		}
+		// Если пришел сигнал остановки и ни одной задачи не осталось, завершаем выполнение потока
+		if (!Park(false))
+			return;
+	}
+}
@@ -0,0 +1,242 @@
+#pragma once
+#include "CpuTopology.hpp"
+#include "Stats.hpp"
+#include "ThreadLocals.hpp"
+#include "WorkStealingDeque.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Порядок выполнения задач пула
+enum class SchedulingPolicy {
+	/// Поток берет из своего дека последнюю добавленную задачу: обход идет вглубь,
+	/// данные родителя еще в кэше, а очередь растет на ширину директорий вдоль текущего пути
+	DepthFirst,
+	/// Поток берет из своего дека самую старую задачу: обход идет по уровням,
+	/// и в очереди оказывается целый уровень дерева
+	BreadthFirst,
+	/// Вглубь, но невыполненных задач не больше лимита: при его достижении задача,
+	/// нашедшая поддиректорию, обходит ее сама (см. ThreadPool::Saturated)
+	Hybrid,
+};
+
+/// @brief Разбор имени политики ("dfs", "bfs", "hybrid"); std::nullopt для неизвестного имени
+[[nodiscard]] std::optional<SchedulingPolicy> ParseSchedulingPolicy(std::string_view name);
+
+/// @brief Пул потоков с перехватом задач.
+/// У каждого рабочего потока свой дек Чейза-Лева: задачи, созданные внутри рабочего потока,
+/// кладутся в его дек (LIFO), простаивающие потоки перехватывают задачи у случайной жертвы.
+/// Задачи извне пула попадают в общую очередь под мьютексом.
+/// При размещении по узлам NUMA (WorkerPlacement) потоки закрепляются за процессорами, у каждого узла
+/// своя общая очередь, а поиск работы идет от ближнего к дальнему: свой дек, очередь своего узла,
+/// деки потоков своего узла и только затем очереди и деки других узлов. Блоки объектов задач выделяет
+/// и первым записывает поток, которому они нужны, поэтому их страницы оказываются на его узле.
+/// Задача - объект фиксированного размера с захваченными значениями внутри (без std::function и отдельного
+/// выделения памяти); объекты берутся из блоков пула через список свободных объектов потока.
+/// Потоки без работы паркуются на условной переменной, и EnqueueTask будит их,
+/// только если есть спящие потоки.
+/// Счетчик невыполненных задач позволяет Wait узнать о завершении всей работы без опроса;
+/// поток, вызвавший Wait, сам выполняет задачи, поэтому пул без потоков работает как последовательный исполнитель.
+struct ThreadPool {
+	/// Количество потоков
+	unsigned int _threadPool;
+
+	/// Количество заморозки в миллисекундах
+	std::chrono::milliseconds _debugSleep;
+
+	/// Лимит невыполненных задач политики Hybrid по умолчанию
+	static constexpr std::size_t DefaultPendingLimit = 4096;
+
+	///@brief Конструктор класса ThreadPool.
+	/// stats - учет задач, перехватов и ожидания работы (nullptr - без учета);
+	/// pendingLimit - лимит невыполненных задач для SchedulingPolicy::Hybrid;
+	/// placement - процессоры и узлы рабочих потоков (пустое - без закрепления, одна общая очередь).
+	/// Размещение не на threadPool потоков или с узлом не меньше nodeCount - std::invalid_argument
+	ThreadPool(unsigned int threadPool, std::chrono::milliseconds debugSleep, Stats* stats = nullptr,
+		SchedulingPolicy policy = SchedulingPolicy::DepthFirst, std::size_t pendingLimit = DefaultPendingLimit,
+		const WorkerPlacement& placement = {});
+
+	///@brief Деструктор класса ThreadPool.
+	/// Выполняет оставшиеся задачи через Wait, затем останавливает потоки.
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// @brief Добавление задачи в очередь.
+	/// Функция, помещающаяся в Task::InlineSize байт, хранится в самой задаче, большая - в отдельном выделении
+	template<typename Function>
+	void EnqueueTask(Function&& function) {
+		using Callable = std::decay_t<Function>;
+		Task* task = AllocateTask();
+		if constexpr (sizeof(Callable) <= Task::InlineSize && alignof(Callable) <= alignof(std::max_align_t)) {
+			new (task->_storage) Callable(std::forward<Function>(function));
+			task->_run = [](Task& self) {
+				Callable& callable = *std::launder(reinterpret_cast<Callable*>(self._storage));
+				// Функция разрушается и при исключении
+				struct Destroy {
+					Callable& callable;
+					~Destroy() { callable.~Callable(); }
+				} destroy{ callable };
+				callable();
+			};
+		}
+		else {
+			Callable* stored = new Callable(std::forward<Function>(function));
+			std::memcpy(task->_storage, &stored, sizeof(stored));
+			task->_run = [](Task& self) {
+				Callable* callable;
+				std::memcpy(&callable, self._storage, sizeof(callable));
+				std::unique_ptr<Callable> owner(callable);
+				(*owner)();
+			};
+		}
+		Push(task);
+	}
+
+	/// @brief Пора ли выполнять найденную работу на месте, а не ставить в очередь:
+	/// только для SchedulingPolicy::Hybrid, когда невыполненных задач не меньше лимита
+	[[nodiscard]] bool Saturated() const {
+		return _policy == SchedulingPolicy::Hybrid && _pending.load(std::memory_order_relaxed) >= _pendingLimit;
+	}
+
+	///@brief Количество узлов (общих очередей) пула
+	[[nodiscard]] std::size_t Nodes() const { return _queues.size(); }
+
+	///@brief Наибольшее количество невыполненных задач за время жизни пула
+	[[nodiscard]] std::size_t PeakPending() const { return _peakPending.load(std::memory_order_relaxed); }
+
+	/// @brief Выполнение задач текущим потоком, пока не будут выполнены все задачи пула,
+	/// включая порожденные во время ожидания.
+	/// Вызывается одновременно не более чем из одного потока и не из задачи пула (std::logic_error).
+	void Wait();
+
+private:
+	/// @brief Задача: функция с захваченными значениями хранится внутри объекта
+	struct Task {
+		/// Места под функцию (задача обхода захватывает контекст, индекс узла, дескриптор и отметку)
+		static constexpr std::size_t InlineSize = 80;
+
+		/// Выполнение и разрушение функции
+		void (*_run)(Task&) = nullptr;
+		/// Следующий объект в списке свободных
+		Task* _next = nullptr;
+		alignas(std::max_align_t) unsigned char _storage[InlineSize];
+	};
+
+	/// @brief Свободные объекты задач одного потока
+	struct TaskCache {
+		Task* _free = nullptr;
+		std::size_t _count = 0;
+	};
+
+	/// @brief Рабочий поток и его дек
+	struct alignas(64) Worker {
+		WorkStealingDeque<Task> _deque;
+		std::thread _thread;
+		/// Состояние генератора для выбора жертвы
+		std::uint64_t _random = 0;
+		/// Узел потока (индекс общей очереди) и процессор, за которым он закреплен (-1 - без закрепления)
+		unsigned _node = 0;
+		int _cpu = -1;
+	};
+
+	/// @brief Общая очередь узла: задачи, добавленные не из рабочих потоков
+	struct alignas(64) NodeQueue {
+		std::deque<Task*> _tasks;
+		std::mutex _mutex;
+		/// Размер очереди (чтобы не захватывать мьютекс впустую)
+		std::atomic<std::size_t> _count{ 0 };
+	};
+
+	//@brief Цикл рабочего потока
+	void WorkerThread(Worker& worker);
+
+	//@brief Поиск задачи: свой дек, очередь своего узла, перехват у потока своего узла,
+	/// затем очереди и потоки других узлов
+	[[nodiscard]] Task* FindTask(Worker& worker);
+
+	//@brief Задача из общей очереди узла; nullptr, если очередь пуста
+	[[nodiscard]] Task* TakeQueued(NodeQueue& queue);
+
+	//@brief Перехват задачи у случайного потока узла node, кроме thief
+	[[nodiscard]] Task* StealFrom(unsigned node, Worker& thief);
+
+	//@brief Есть ли видимая работа в каком-либо деке или общей очереди
+	[[nodiscard]] bool HasVisibleWork() const;
+
+	//@brief Пробуждение одного спящего потока, если такие есть
+	void WakeOne();
+
+	//@brief Пробуждение всех спящих потоков, если такие есть
+	void WakeAll();
+
+	//@brief Выполнение задачи и уменьшение счетчика невыполненных задач
+	void RunTask(Task* task);
+
+	//@brief Постановка готовой задачи в дек потока или общую очередь
+	void Push(Task* task);
+
+	//@brief Объект задачи из списка потока (пополняется из общего запаса или нового блока)
+	[[nodiscard]] Task* AllocateTask();
+
+	//@brief Возврат объекта в список потока (излишек уходит в общий запас)
+	void FreeTask(Task* task);
+
+	//@brief Список свободных объектов текущего потока
+	[[nodiscard]] TaskCache& LocalCache();
+
+	//@brief Парковка до появления работы; false, если ждать больше нечего
+	/// (для вызывающего потока - все задачи выполнены, для рабочего - еще и получен сигнал остановки)
+	[[nodiscard]] bool Park(bool caller);
+
+	///Статистика (nullptr - без учета)
+	Stats* const _stats;
+	///Политика и лимит невыполненных задач
+	const SchedulingPolicy _policy;
+	const std::size_t _pendingLimit;
+
+	///Рабочие потоки; нулевой элемент - дек потока, вызывающего Wait
+	std::vector<std::unique_ptr<Worker>> _workers;
+
+	///Общие очереди узлов и рабочие потоки каждого узла (вызывающий поток относится к узлу 0)
+	std::vector<std::unique_ptr<NodeQueue>> _queues;
+	std::vector<std::vector<Worker*>> _nodeWorkers;
+	///Очередь для следующей задачи извне пула: такие задачи распределяются по узлам по кругу
+	std::atomic<unsigned> _nextQueue{ 0 };
+
+	///Мьютекс и условная переменная для парковки
+	std::mutex _parkMutex;
+	std::condition_variable _parkCV;
+	///Количество спящих или засыпающих потоков
+	std::atomic<unsigned int> _sleepers{ 0 };
+	///Счетчик пробуждений (защищает от потери сигнала между проверкой и ожиданием)
+	std::atomic<std::uint64_t> _epoch{ 0 };
+	///Флаг остановки
+	std::atomic<bool> _stop{ false };
+	///Задачи, добавленные, но еще не выполненные (достижение нуля будит Wait)
+	std::atomic<std::size_t> _pending{ 0 };
+	///Максимум _pending
+	std::atomic<std::size_t> _peakPending{ 0 };
+
+	///Блоки объектов задач, списки потоков и общий запас свободных объектов
+	std::vector<std::unique_ptr<Task[]>> _taskBlocks;
+	std::vector<std::unique_ptr<TaskCache>> _taskCaches;
+	Task* _spareTasks = nullptr;
+	std::mutex _tasksMutex;
+	///Поиск списка текущего потока
+	ThreadLocals _threadLocals;
+};
\ No newline at end of file
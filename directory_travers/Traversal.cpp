@@ -0,0 +1,396 @@
+#include "Traversal.hpp"
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <system_error>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace {
+	/// @brief Текстовое представление id потока (как у operator<<), вычисляемое один раз
+	const std::string& ThreadIdText(std::thread::id id) {
+		static const std::string idle = [] {
+			std::ostringstream text;
+			text << std::thread::id();
+			return text.str();
+		}();
+		if (id == std::thread::id())
+			return idle;
+		thread_local std::thread::id cachedId;
+		thread_local std::string cachedText;
+		if (cachedId != id || cachedText.empty()) {
+			std::ostringstream text;
+			text << id;
+			cachedText = text.str();
+			cachedId = id;
+		}
+		return cachedText;
+	}
+
+	/// @brief Перевод времени файловой системы в наносекунды от эпохи system_clock.
+	/// В C++17 у file_time_type нет clock_cast, поэтому сдвиг берется по текущему времени обоих часов.
+	/// Эпохи часов (libstdc++, libc++, MSVC) отличаются на целое число секунд: сдвиг округляется один раз,
+	/// и одно и то же время файла переводится точно, как у stat
+	std::int64_t FileTimeNanoseconds(std::filesystem::file_time_type time) {
+		using namespace std::chrono;
+		static const seconds shift = round<seconds>(std::filesystem::file_time_type::clock::now().time_since_epoch()
+			- system_clock::now().time_since_epoch());
+		return duration_cast<nanoseconds>(time.time_since_epoch() - shift).count();
+	}
+
+	/// @brief Заголовок машиночитаемого формата пишется до первой записи, если обход выводит списки
+	void BeginOutput(TraversalContext& context) {
+		const std::string_view header = StreamHeader(context._format);
+		if (header.empty() || context._summary != nullptr || context._duplicates != nullptr)
+			return;
+		context._output.Write(header);
+		// Задач еще нет: блок вызывающего потока уходит на запись раньше блоков рабочих потоков
+		context._output.Flush();
+	}
+
+	/// @brief Файл с несколькими жесткими ссылками, уже учтенный по другому пути (только с context._visited).
+	/// Запись такого файла остается в списке (снимок хранит полные списки), но с нулевым размером
+	bool RevisitedFile(const TraversalContext& context, const std::filesystem::path& path) {
+#ifdef _WIN32
+		(void)context;
+		(void)path;
+		return false;
+#else
+		struct stat info {};
+		if (context._visited == nullptr || ::stat(path.c_str(), &info) != 0 || info.st_nlink < 2)
+			return false;
+		return !FirstVisit(context, static_cast<std::uint64_t>(info.st_dev), static_cast<std::uint64_t>(info.st_ino));
+#endif
+	}
+
+	/// @brief Имя файла в виде узкой строки
+	std::string FileName(const std::filesystem::path& path) {
+		return path.filename().string();
+	}
+
+	/// @brief Буферы обхода FileSystem
+	struct HandleBuffers {
+		std::vector<NodeTable::Entry> entries;
+		std::vector<FileSystem::Handle> children;
+	};
+
+	/// @brief Буферы обхода directory_iterator
+	struct FilesystemBuffers {
+		std::vector<NodeTable::Entry> entries;
+	};
+
+	/// @brief Обход директории файловой системы FileSystem
+	void TraverseHandle(FileSystem& fileSystem, FileSystem::Handle directory, std::uint32_t node, TraversalContext& context) {
+		LocalBuffers<HandleBuffers> buffers;
+		std::vector<NodeTable::Entry>& entries = buffers->entries;
+		std::vector<FileSystem::Handle>& children = buffers->children;
+		entries.clear();
+		children.clear();
+		StatScope reading(context._stats, StatTimer::DirectoryRead);
+		fileSystem.ReadDirectory(directory, context._nodes, entries, children);
+		reading.Stop();
+		const std::uint32_t first = context._nodes.Append(node, entries);
+		FinishDirectory(context, node, first, entries);
+
+		std::size_t next = 0;
+		for (std::uint32_t i = 0; i < entries.size(); ++i) {
+			if (entries[i].type != NodeType::Directory)
+				continue;
+			if (context._debugSleep.count() > 0) {
+				std::this_thread::sleep_for(context._debugSleep);
+			}
+			DispatchSubdirectory(context, [&fileSystem, &context, handle = children[next++], child = first + i]() {
+				TraverseHandle(fileSystem, handle, child, context);
+			});
+		}
+	}
+}
+
+/// @brief Обход директории
+void TraverseDirectory(const std::filesystem::path& directory, std::uint32_t node, TraversalContext& context) {
+	LocalBuffers<FilesystemBuffers> buffers;
+	std::vector<NodeTable::Entry>& entries = buffers->entries;
+	entries.clear();
+	const bool metadata = WantsFileMetadata(context);
+	const bool directoryMetadata = WantsDirectoryMetadata(context);
+
+	// Отметка снимается до чтения списка: изменение во время чтения заметит следующий обход.
+	// Она же дает идентичность директории: stat раскрывает ссылки, поэтому цикл символических ссылок обрывается здесь
+	DirectoryStamp stamp;
+	const bool stamped = (context._previous != nullptr || context._snapshot != nullptr || context._visited != nullptr)
+		&& ReadStamp(directory, stamp);
+	if (stamped && !FirstVisit(context, stamp.device, stamp.inode)) {
+		FinishDirectory(context, node, 0, {});
+		return;
+	}
+	const snapshot::Directory* cached = nullptr;
+	if (stamped && context._previous != nullptr)
+		cached = context._previous->Find(PathHash(context._nodes, node), stamp);
+
+	StatScope reading(context._stats, StatTimer::DirectoryRead);
+	// Неполный список не попадает в снимок, иначе следующий обход взял бы его как неизменный
+	bool complete = true;
+	if (cached != nullptr) {
+		// Директория не изменилась: список из снимка, пути файлов строятся из имен
+		context._previous->Load(*cached, context._nodes, entries);
+		for (NodeTable::Entry& entry : entries) {
+			if (metadata && entry.type == NodeType::File) {
+				const std::filesystem::path path = directory / std::string(context._nodes.Name(entry.name));
+				std::error_code status;
+				entry.size = std::filesystem::file_size(path, status);
+				if (status || RevisitedFile(context, path))
+					entry.size = 0;
+				entry.mtime = FileTimeNanoseconds(std::filesystem::last_write_time(path, status));
+				if (status)
+					entry.mtime = 0;
+			}
+			else if (directoryMetadata && entry.type == NodeType::Directory) {
+				std::error_code status;
+				entry.mtime = FileTimeNanoseconds(std::filesystem::last_write_time(directory / std::string(context._nodes.Name(entry.name)), status));
+				if (status)
+					entry.mtime = 0;
+			}
+		}
+	}
+	else {
+		// Обходим все файлы и поддиректории в текущей директории.
+		// Ошибки (нет прав, запись исчезла) не прерывают обход: недоступное пропускается, неоткрытая директория сообщается
+		std::error_code error;
+		std::filesystem::directory_iterator it(directory, error);
+		if (error) {
+			ReportOpenFailure(context, node, error.value());
+			complete = false;
+		}
+		for (std::filesystem::directory_iterator end; !error && it != end; it.increment(error)) {
+			const auto& file = *it;
+			std::error_code status;
+			if (file.is_regular_file(status)) {
+				// Если это файл
+				NodeTable::Entry entry{ NodeType::File, context._nodes.StoreName(FileName(file.path())), 0 };
+				if (metadata) {
+					entry.size = file.file_size(status);
+					if (status || RevisitedFile(context, file.path()))
+						entry.size = 0;
+					entry.mtime = FileTimeNanoseconds(file.last_write_time(status));
+					if (status)
+						entry.mtime = 0;
+				}
+				entries.push_back(entry);
+			}
+			else if (file.is_directory(status)) {
+				// Если это поддиректория
+				NodeTable::Entry entry{ NodeType::Directory, context._nodes.StoreName(FileName(file.path())), 0 };
+				if (directoryMetadata) {
+					entry.mtime = FileTimeNanoseconds(file.last_write_time(status));
+					if (status)
+						entry.mtime = 0;
+				}
+				entries.push_back(entry);
+			}
+		}
+		// Ошибка чтения посреди списка: прочитанное выводится, директория сообщается
+		if (error && complete) {
+			ReportReadFailure(context, node, error.value());
+			complete = false;
+		}
+	}
+	reading.Stop();
+	const std::uint32_t first = context._nodes.Append(node, entries);
+	if (stamped && complete && context._snapshot != nullptr)
+		context._snapshot->Record(node, first, static_cast<std::uint32_t>(entries.size()), stamp, cached != nullptr);
+	// Вывод информации о директории (или учет в сводке) до постановки задач поддиректорий
+	FinishDirectory(context, node, first, entries);
+
+	// Путь директории один на все задачи поддиректорий: задача хранит указатель и индекс, а не полный путь
+	std::shared_ptr<const std::filesystem::path> parent;
+	for (std::uint32_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].type != NodeType::Directory)
+			continue;
+		if (context._debugSleep.count() > 0) {
+			std::this_thread::sleep_for(context._debugSleep);
+		}
+		if (!parent)
+			parent = std::make_shared<const std::filesystem::path>(directory);
+		// Добавляем задачу в очередь для обработки этой поддиректории
+		DispatchSubdirectory(context, [&context, parent, child = first + i]() {
+			// Рекурсивный вызов для обхода поддиректории
+			TraverseDirectory(*parent / std::string(context._nodes.Name(context._nodes[child])), child, context);
+		});
+	}
+}
+
+std::optional<TraversalBackend> ParseTraversalBackend(std::string_view name) {
+	if (name == "filesystem")
+		return TraversalBackend::Filesystem;
+#ifdef __linux__
+	if (name == "getdents")
+		return TraversalBackend::Getdents;
+	if (name == "uring")
+		return TraversalBackend::Uring;
+#endif
+	return std::nullopt;
+}
+
+std::uint32_t SnapshotFlags(TraversalBackend backend) {
+	// Только directory_iterator раскрывает символические ссылки на директории
+	return backend == TraversalBackend::Filesystem ? snapshot::FollowsSymlinks : 0;
+}
+
+std::uint32_t TraverseDirectory(const std::filesystem::path& directory, TraversalContext& context, TraversalBackend backend) {
+	const std::uint32_t root = context._nodes.AddRoot(directory.string());
+	if (context._summary != nullptr)
+		context._summary->AddRoot(root);
+	BeginOutput(context);
+	context._pool.EnqueueTask([&directory, &context, root, backend]() {
+#ifdef __linux__
+		if (backend == TraversalBackend::Getdents) {
+			TraverseDirectoryGetdents(directory, root, context);
+			return;
+		}
+		if (backend == TraversalBackend::Uring) {
+			TraverseDirectoryUring(directory, root, context);
+			return;
+		}
+#else
+		(void)backend;
+#endif
+		TraverseDirectory(directory, root, context);
+	});
+	// Текущий поток участвует в обходе и возвращается, когда выполнены все задачи
+	context._pool.Wait();
+	// Все задачи выполнены: неполные блоки потоков можно отдать на запись
+	context._output.Flush();
+	return root;
+}
+
+std::uint32_t TraverseFileSystem(FileSystem& fileSystem, TraversalContext& context) {
+	const std::uint32_t root = context._nodes.AddRoot(fileSystem.RootPath());
+	if (context._summary != nullptr)
+		context._summary->AddRoot(root);
+	BeginOutput(context);
+	context._pool.EnqueueTask([&fileSystem, &context, root]() {
+		TraverseHandle(fileSystem, fileSystem.Root(), root, context);
+	});
+	context._pool.Wait();
+	context._output.Flush();
+	return root;
+}
+
+bool FirstVisit(const TraversalContext& context, std::uint64_t device, std::uint64_t inode) {
+	if (context._visited == nullptr || (device == 0 && inode == 0) || context._visited->Insert(device, inode))
+		return true;
+	if (context._stats != nullptr)
+		context._stats->Add(StatCounter::InodesRevisited);
+	return false;
+}
+
+bool WantsFileMetadata(const TraversalContext& context) {
+	return context._summary != nullptr || context._duplicates != nullptr || context._format != OutputFormat::Text;
+}
+
+bool WantsDirectoryMetadata(const TraversalContext& context) {
+	return context._format != OutputFormat::Text && context._summary == nullptr && context._duplicates == nullptr;
+}
+
+void FinishDirectory(TraversalContext& context, std::uint32_t node, std::uint32_t first, const std::vector<NodeTable::Entry>& entries) {
+	if (context._stats != nullptr) {
+		context._stats->Add(StatCounter::DirectoriesRead);
+		context._stats->Add(StatCounter::EntriesRead, entries.size());
+	}
+	if (context._summary != nullptr)
+		context._summary->AddListing(node, first, entries);
+	if (context._duplicates != nullptr)
+		context._duplicates->AddListing(first, entries);
+	if (context._summary == nullptr && context._duplicates == nullptr)
+		WriteListing(context, node, first, entries);
+}
+
+namespace {
+	/// @brief Учет и сообщение "<action> <путь>: <ошибка>" для ReportOpenFailure и ReportReadFailure
+	void ReportFailure(TraversalContext& context, std::uint32_t node, int error, const char* action) {
+		context._openFailures.fetch_add(1, std::memory_order_relaxed);
+		if (context._stats != nullptr)
+			context._stats->Add(StatCounter::OpenFailures);
+		// Строка собирается целиком и пишется одним вызовом, чтобы сообщения потоков не перемешивались
+		std::string message = action;
+		message += ' ';
+		context._nodes.AppendPath(message, node);
+		message += ": ";
+		message += std::system_category().message(error);
+		message += '\n';
+		std::fputs(message.c_str(), stderr);
+	}
+}
+
+void ReportOpenFailure(TraversalContext& context, std::uint32_t node, int error) {
+	ReportFailure(context, node, error, "cannot open");
+}
+
+void ReportReadFailure(TraversalContext& context, std::uint32_t node, int error) {
+	ReportFailure(context, node, error, "cannot read");
+}
+
+void WriteListing(TraversalContext& context, std::uint32_t directory, std::uint32_t first, const std::vector<NodeTable::Entry>& entries) {
+	const NodeTable& nodes = context._nodes;
+	const std::uint32_t count = static_cast<std::uint32_t>(entries.size());
+	if (context._format != OutputFormat::Text) {
+		if (count == 0)
+			return;
+		// Путь директории восстанавливается и кодируется один раз на список; строки потока переиспользуются
+		thread_local std::string path;
+		thread_local std::string prefix;
+		thread_local std::string records;
+		path.clear();
+		prefix.clear();
+		records.clear();
+		nodes.AppendPath(path, directory);
+		AppendPathPrefix(prefix, context._format, path);
+		for (std::uint32_t i = 0; i < count; ++i) {
+			const Node& node = nodes[first + i];
+			AppendRecord(records, context._format, node.type, node.size, entries[i].mtime, prefix, nodes.Name(node));
+		}
+		context._output.Write(records);
+		return;
+	}
+	constexpr char separator = static_cast<char>(std::filesystem::path::preferred_separator);
+	// Разделитель не нужен только после корня, заданного с завершающим разделителем
+	const std::string_view name = nodes.Name(nodes[directory]);
+	const bool needSeparator = nodes[directory].parent != NodeTable::NoParent
+		|| name.empty() || (name.back() != '/' && name.back() != separator);
+
+	// Строка потока переиспользуется, поэтому форматирование не выделяет память после разогрева
+	thread_local std::string record;
+	record.clear();
+	// Выводим все поддиректории
+	const std::string& idle = ThreadIdText(std::thread::id());
+	for (std::uint32_t i = first; i < first + count; ++i) {
+		const Node& node = nodes[i];
+		if (node.type != NodeType::Directory)
+			continue;
+		record += '\t';
+		if (needSeparator) record += separator;
+		record += nodes.Name(node);
+		record += " (Thread ID: ";
+		record += idle;
+		record += ")\n";
+	}
+	// Выводим все файлы в текущей директории
+	const std::string& threadId = ThreadIdText(std::this_thread::get_id());
+	for (std::uint32_t i = first; i < first + count; ++i) {
+		const Node& node = nodes[i];
+		if (node.type != NodeType::File)
+			continue;
+		record += "\t\t";
+		if (needSeparator) record += separator;
+		record += nodes.Name(node);
+		record += " (Thread ID: ";
+		record += threadId;
+		record += ")\n";
+	}
+	context._output.Write(record);
+}
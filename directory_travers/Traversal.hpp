@@ -0,0 +1,169 @@
+#pragma once
+#include "Duplicates.hpp"
+#include "FileSystem.hpp"
+#include "InodeSet.hpp"
+#include "NodeTable.hpp"
+#include "OutputFormat.hpp"
+#include "OutputWriter.hpp"
+#include "Snapshot.hpp"
+#include "Stats.hpp"
+#include "Summary.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief Общее состояние обхода; задачи получают его по ссылке
+struct TraversalContext {
+	/// Пул, выполняющий задачи поддиректорий
+	ThreadPool& _pool;
+	/// Таблица найденных узлов
+	NodeTable& _nodes;
+	/// Вывод результатов
+	OutputWriter& _output;
+	/// Количество заморозки в миллисекундах
+	std::chrono::milliseconds _debugSleep;
+	/// Формат списков директорий
+	OutputFormat _format = OutputFormat::Text;
+	/// Глубина очереди io_uring на поток (способ Uring)
+	unsigned _queueDepth = 32;
+	/// Сводка в стиле du; если задана, списки директорий не выводятся, а размеры и mtime собираются
+	SummaryTable* _summary = nullptr;
+	/// Поиск дубликатов; если задан, списки директорий не выводятся, а размеры файлов собираются
+	DuplicateFinder* _duplicates = nullptr;
+	/// Снимок предыдущего обхода: директории с неизменной отметкой не перечитываются
+	const SnapshotReader* _previous = nullptr;
+	/// Запись снимка этого обхода
+	SnapshotWriter* _snapshot = nullptr;
+	/// Статистика обхода (открытие и чтение директорий, количество записей); nullptr - без учета
+	Stats* _stats = nullptr;
+	/// Посещенные пары (устройство, inode), общие для всех потоков; если заданы, директория, достижимая дважды
+	/// (символические ссылки, bind mount), читается один раз, а размер файла с несколькими жесткими ссылками
+	/// получает только первая найденная ссылка (сводка считает байты один раз, поиск дубликатов не сравнивает ссылки)
+	InodeSet* _visited = nullptr;
+	/// Директории, которые не удалось открыть или дочитать (их содержимое не попало в вывод целиком)
+	std::atomic<std::uint64_t> _openFailures{ 0 };
+};
+
+/// @brief Обход директории, уже добавленной в таблицу под индексом node.
+/// Записи директории добавляются в таблицу подряд, поддиректории отправляются в пул отдельными задачами,
+/// содержимое директории выводится через context._output.
+/// Если директория не изменилась с предыдущего снимка, ее список берется из снимка (размеры и mtime файлов
+/// для сводки все равно запрашиваются заново: изменение файла не меняет отметку директории).
+void TraverseDirectory(const std::filesystem::path& directory, std::uint32_t node, TraversalContext& context);
+
+/// @brief Способ чтения директорий
+enum class TraversalBackend {
+	/// std::filesystem::directory_iterator (переносимый)
+	Filesystem,
+	/// openat относительно дескриптора родителя и getdents64 с большим буфером (только Linux)
+	Getdents,
+	/// getdents64, а statx всех записей и openat поддиректорий пакетами через io_uring (только Linux).
+	/// Без io_uring те же операции выполняются синхронно.
+	Uring,
+};
+
+/// @brief Разбор имени способа обхода ("filesystem", "getdents", "uring").
+/// Возвращает std::nullopt для неизвестного имени или способа, недоступного на этой платформе.
+[[nodiscard]] std::optional<TraversalBackend> ParseTraversalBackend(std::string_view name);
+
+/// @brief Флаги снимка, записываемого способом обхода: снимок подходит только обходу с теми же флагами
+[[nodiscard]] std::uint32_t SnapshotFlags(TraversalBackend backend);
+
+#ifdef __linux__
+/// @brief Обход директории через getdents64.
+/// Тип записи берется из d_type, fstatat вызывается только для DT_UNKNOWN, символические ссылки не раскрываются.
+/// Вывод совпадает с TraverseDirectory.
+void TraverseDirectoryGetdents(const std::filesystem::path& directory, std::uint32_t node, TraversalContext& context);
+
+/// @brief Обход директории с метаданными через io_uring.
+/// В узлы записывается размер из statx; до context._queueDepth операций в полете на поток.
+void TraverseDirectoryUring(const std::filesystem::path& directory, std::uint32_t node, TraversalContext& context);
+#endif
+
+/// @brief Обход директории выбранным способом.
+/// Текущий поток выполняет задачи вместе с пулом и возвращается после обхода всего дерева
+/// и записи всего вывода. Возвращает индекс корня в таблице узлов.
+std::uint32_t TraverseDirectory(const std::filesystem::path& directory, TraversalContext& context, TraversalBackend backend);
+
+/// @brief Обход через интерфейс FileSystem (например, синтетического дерева в памяти) с тем же выводом,
+/// сводкой и статистикой, что и у обхода диска; снимки не используются. Возвращает индекс корня в таблице узлов.
+std::uint32_t TraverseFileSystem(FileSystem& fileSystem, TraversalContext& context);
+
+/// @brief Нужны ли обходу размеры и mtime файлов (сводка, поиск дубликатов или машиночитаемый формат списков)
+[[nodiscard]] bool WantsFileMetadata(const TraversalContext& context);
+
+/// @brief Нужно ли mtime поддиректорий: выводятся списки машиночитаемого формата.
+/// Размер директории выводится как 0 всеми способами обхода (st_size директории зависит от файловой системы)
+[[nodiscard]] bool WantsDirectoryMetadata(const TraversalContext& context);
+
+/// @brief Первое ли посещение директории или файла (устройство, inode); без context._visited всегда true.
+/// Пара (0, 0) означает, что идентичность неизвестна (например, на Windows), и тоже считается первым посещением.
+[[nodiscard]] bool FirstVisit(const TraversalContext& context, std::uint64_t device, std::uint64_t inode);
+
+/// @brief Завершение чтения директории: учет в сводке и поиске дубликатов или вывод списка.
+/// Вызывается до постановки задач поддиректорий, в том числе для директории, которую не удалось прочитать
+/// (с пустым списком), иначе сводка не узнает о завершении поддерева.
+void FinishDirectory(TraversalContext& context, std::uint32_t node, std::uint32_t first, const std::vector<NodeTable::Entry>& entries);
+
+/// @brief Сообщение о директории node, которую не удалось открыть (error - errno): строка в stderr,
+/// context._openFailures и счетчик статистики. Обход продолжается без содержимого этой директории.
+void ReportOpenFailure(TraversalContext& context, std::uint32_t node, int error);
+
+/// @brief То же для директории, чтение списка которой оборвалось ошибкой ("cannot read" в stderr).
+/// Прочитанные записи выводятся, но в снимок директория не записывается.
+void ReportReadFailure(TraversalContext& context, std::uint32_t node, int error);
+
+/// @brief Обход поддиректории задачей пула или, если пул переполнен (SchedulingPolicy::Hybrid),
+/// сразу в текущем потоке: очередь не растет сверх лимита на очень широких деревьях
+template<typename Function>
+void DispatchSubdirectory(TraversalContext& context, Function&& task) {
+	if (context._pool.Saturated())
+		task();
+	else
+		context._pool.EnqueueTask(std::forward<Function>(task));
+}
+
+/// @brief Буферы обхода текущего потока для текущей глубины вложенности.
+/// Буферы переиспользуются всеми директориями, которые обходит поток; поддиректория, обходимая на месте
+/// (DispatchSubdirectory), получает следующий уровень, не трогая буферы родителя.
+template<typename Buffers>
+class LocalBuffers {
+public:
+	LocalBuffers() {
+		std::vector<std::unique_ptr<Buffers>>& stack = Stack();
+		if (Depth() == stack.size())
+			stack.push_back(std::make_unique<Buffers>());
+		_buffers = stack[Depth()++].get();
+	}
+	~LocalBuffers() { --Depth(); }
+
+	LocalBuffers(const LocalBuffers&) = delete;
+	LocalBuffers& operator=(const LocalBuffers&) = delete;
+
+	Buffers* operator->() const { return _buffers; }
+	Buffers& operator*() const { return *_buffers; }
+
+private:
+	static std::vector<std::unique_ptr<Buffers>>& Stack() {
+		thread_local std::vector<std::unique_ptr<Buffers>> stack;
+		return stack;
+	}
+	static std::size_t& Depth() {
+		thread_local std::size_t depth = 0;
+		return depth;
+	}
+
+	Buffers* _buffers;
+};
+
+/// @brief Вывод директории одной записью через буфер текущего потока в формате context._format.
+/// Записи директории - узлы [first, first + entries.size()); имена берутся из таблицы, mtime - из entries.
+void WriteListing(TraversalContext& context, std::uint32_t directory, std::uint32_t first, const std::vector<NodeTable::Entry>& entries);
@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// @brief Дек Чейза-Лева для планировщика с перехватом задач.
+/// Владелец кладет и забирает элементы с нижнего конца (LIFO, горячие данные остаются в кэше),
+/// остальные потоки перехватывают элементы с верхнего конца (FIFO, крупные поддеревья).
+/// Реализация по "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê и др., 2013).
+/// Хранит указатели; nullptr означает "пусто" или "перехват не удался".
+template<typename T>
+class WorkStealingDeque {
+public:
+	explicit WorkStealingDeque(std::size_t capacity = 1024) {
+		std::size_t rounded = 1;
+		while (rounded < capacity)
+			rounded <<= 1;
+		_buffers.push_back(std::make_unique<Buffer>(rounded));
+		_buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+	}
+
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	///@brief Добавление элемента (только поток-владелец)
+	void Push(T* item) {
+		const std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+		const std::int64_t top = _top.load(std::memory_order_acquire);
+		Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+		if (bottom - top > static_cast<std::int64_t>(buffer->mask)) {
+			buffer = Grow(buffer, top, bottom);
+		}
+		buffer->Put(bottom, item);
+		// Публикация элемента для перехватчиков (acquire в Steal)
+		_bottom.store(bottom + 1, std::memory_order_release);
+	}
+
+	///@brief Извлечение последнего добавленного элемента (только поток-владелец)
+	[[nodiscard]] T* Pop() {
+		const std::int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+		Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+		_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t top = _top.load(std::memory_order_relaxed);
+		if (top > bottom) {
+			// Дек пуст
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		T* item = buffer->Get(bottom);
+		if (top == bottom) {
+			// Последний элемент: соревнуемся с перехватчиками
+			if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				item = nullptr;
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	///@brief Перехват самого старого элемента (любой поток)
+	[[nodiscard]] T* Steal() {
+		std::int64_t top = _top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return nullptr;
+		Buffer* buffer = _buffer.load(std::memory_order_acquire);
+		T* item = buffer->Get(top);
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return item;
+	}
+
+	///@brief Приблизительная проверка на пустоту (для решения о парковке)
+	[[nodiscard]] bool Empty() const {
+		const std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+		const std::int64_t top = _top.load(std::memory_order_relaxed);
+		return bottom <= top;
+	}
+
+private:
+	/// @brief Кольцевой буфер степени двойки
+	struct Buffer {
+		explicit Buffer(std::size_t capacity) : mask(capacity - 1), items(new std::atomic<T*>[capacity]) {}
+
+		void Put(std::int64_t index, T* item) {
+			items[static_cast<std::size_t>(index) & mask].store(item, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] T* Get(std::int64_t index) const {
+			return items[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+		}
+
+		std::size_t mask;
+		std::unique_ptr<std::atomic<T*>[]> items;
+	};
+
+	///@brief Увеличение буфера вдвое (только поток-владелец).
+	/// Старые буферы не освобождаются до уничтожения дека: перехватчик мог успеть их прочитать.
+	Buffer* Grow(Buffer* buffer, std::int64_t top, std::int64_t bottom) {
+		auto grown = std::make_unique<Buffer>((buffer->mask + 1) * 2);
+		for (std::int64_t i = top; i < bottom; ++i)
+			grown->Put(i, buffer->Get(i));
+		Buffer* result = grown.get();
+		_buffers.push_back(std::move(grown));
+		_buffer.store(result, std::memory_order_release);
+		return result;
+	}
+
+	///Верхний конец (перехват)
+	alignas(64) std::atomic<std::int64_t> _top{ 0 };
+	///Нижний конец (владелец)
+	alignas(64) std::atomic<std::int64_t> _bottom{ 0 };
+	///Текущий буфер
+	alignas(64) std::atomic<Buffer*> _buffer{ nullptr };
+	///Все выделенные буферы (изменяется только владельцем)
+	std::vector<std::unique_ptr<Buffer>> _buffers;
+};
\ No newline at end of file
@@ -1,208 +1,232 @@
 #include "args_parse/argument.hpp"
 #include "args_parse/ArgsParser.hpp"
+#include "CpuTopology.hpp"
+#include "IoUring.hpp"
+#include "Summary.hpp"
+#include "Traversal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
-#include <filesystem>
-#include <chrono>
-#include <queue>
-#include <mutex>
-#include <functional>
-
-struct Directory {
-	///id потока, обрабатывающего текущую директорию
-	std::thread::id _threadId;
-	
-	///Путь директории
-	std::filesystem::path _path;
-	
-	///Вектор всех файлов текущей директории
-	std::vector<std::filesystem::path> _filenames;
-	
-	///Вектор всех поддиректорий в директории
-	std::vector<Directory> _directories;
-
-	Directory(const std::filesystem::path path) : _path{ path } {}
-
-	///@brief Получение пути
-	[[nodiscard]] const std::filesystem::path& GetPath() const { return _path; }
-
-	///@brief Установка пути
-	void SetPath(const std::filesystem::path path) { _path = path; }
-
-	///@brief Добавление файла в вектор всех файлов
-	void AddFile(const std::filesystem::path& file)
-	{
-		_filenames.push_back(file);
-	}
-
-	///@brief Добавление файла в вектор всех директорий
-	void AddDirectory(const std::filesystem::path& file) {
-		_directories.push_back(Directory(file));
-	}
-};
-
-struct ThreadPool {
-	/// Количество потоков
-	unsigned int _threadPool;
-
-	/// Количество заморозки в миллисекундах
-	std::chrono::milliseconds _debugSleep;
-	
-	///Очередь
-	std::queue<std::function<void()>> _tasks;
-	
-	/// Мьютекст для очереди
-	std::mutex _taskMutex;
-	
-	///Условная переменная для очереди
-	std::condition_variable _taskCV;
-	
-	/// Мьютекст для пула
-	std::mutex _poolMutex;
-	
-	///Вектор потоков
-	std::vector<std::thread> _threads;
-	bool _stop;
-	
-	///@brief Конструктор класса ThreadPool
-	ThreadPool(unsigned int threadPool, std::chrono::milliseconds debugSleep) :
-		_threadPool(threadPool), _debugSleep(std::move(debugSleep)), _stop(false) {
-		// Создание потоков в пуле
-		for (unsigned int i = 0; i < _threadPool; ++i) {
-			_threads.emplace_back(std::bind(&ThreadPool::WorkerThread, this));
-		}
-	}
-
-	///@brief Деструктор класса ThreadPool
-	~ThreadPool() {
-		{
-			// Захватываем мьютекс для безопасного изменения переменной _stop
-			std::lock_guard<std::mutex> lock(_taskMutex);
-			_stop = true; // Устанавливаем флаг остановки
-		}
-		_taskCV.notify_all(); // Уведомляем все потоки о завершении
-		// Дожидаемся завершения всех потоков в пуле
-		for (auto& thread : _threads) {
-			if (thread.joinable()) thread.join();
-		}
-	}
-
-	//@brief Многопоточная обработка задач из очереди в пуле потоков
-	void WorkerThread() {
-		while (true) {
-			std::function<void()> task;
-			{
-				// Захват мьютекса для безопасного доступа к очереди задач
-				std::unique_lock<std::mutex> lock(_taskMutex);
-				// Ожидаем, пока не появится задача в очереди или не придет сигнал остановки
-				_taskCV.wait(lock, [this] { return !_tasks.empty() || _stop; });
-				// Если пришел сигнал остановки и очередь задач пуста, завершаем выполнение потока
-				if (_stop && _tasks.empty()) return;
-				// Получение задачу из очереди
-				task = std::move(_tasks.front()); 
-				// Удаление задачи из очереди
-				_tasks.pop();
-			}
-			// Выполнение задачи
-			task(); 
-		}
-	}
-
-	// @brief Добавление задачи в очередь
-	void EnqueueTask(std::function<void()>&& task) {
-		{
-			// Захват мьютекса для безопасного добавления задачи в очередь
-			std::lock_guard<std::mutex> lock(_taskMutex);
-			// Уведомляем один из потоков о наличии новой задачи
-			_tasks.emplace(std::move(task));
-		}
-		// Уведомляем один из потоков о наличии новой задачи
-		_taskCV.notify_one();
-	}
-};
-
-///@brief Перегрузка оператора вывода для класса Directory
-std::ostream& operator<<(std::ostream& os, const Directory& directory) {
-	// Выводим все поддиректории
-	for (const auto& subdir : directory._directories) {
-		os << "\t" << subdir.GetPath().string().substr(directory.GetPath().string().size()) <<
-			" (Thread ID: " << subdir._threadId << ")\n";
-		os << subdir;
-	}
-
-	// Выводим все файлы в текущей директории
-	for (const auto& file : directory._filenames) {
-		os << "\t\t" << file.string().substr(directory.GetPath().string().size()) <<
-			" (Thread ID: " << directory._threadId << ")\n";
-	}
-
-	return os;
-}
-
-/// @brief Обход директории
-static void TraverseDirectory(const std::filesystem::path& directory, ThreadPool& pool, std::chrono::milliseconds debugSleep) {
-	Directory dir(directory);
-	dir._threadId = std::this_thread::get_id();
-
-	// Обходим все файлы и поддиректории в текущей директории
-	for (const auto& file : std::filesystem::directory_iterator(directory)) {
-		if (file.is_regular_file()) { 
-			// Если это файл
-			dir.AddFile(file.path());
-		}
-		else if (file.is_directory()) { 
-			// Если это поддиректория
-			if (debugSleep.count() > 0) {
-				std::this_thread::sleep_for(debugSleep);
-			}
-			std::filesystem::path dirPath = file.path();
-			dir.AddDirectory(dirPath);
-			// Добавляем задачу в очередь для обработки этой поддиректории
-			pool.EnqueueTask([&pool, dirPath, debugSleep]() {
-				// Рекурсивный вызов для обхода поддиректории
-				TraverseDirectory(dirPath, pool, debugSleep);
-			});
-		}
-	}
-	{
-		// Захват мьютекса для безопасного вывода
-		std::lock_guard<std::mutex> lock(pool._poolMutex);
-		// Вывод информации о директории
-		std::cout << dir;
-	}
-}
-
 
 int main(int argc, const char** argv) {
 	args_parse::ArgsParser parser(argc, argv);
 	args_parse::Argument<bool> help('h', "help", false);
 	help.SetDescription("Outputs a description of all added command line arguments");
 	args_parse::Argument<unsigned int> thread_pool('t', "thread-pool", true, new args_parse::Validator<unsigned int>());
-	thread_pool.SetDescription("Sets the number of threads (number)");
+	thread_pool.SetDescription("Sets the number of worker threads (number, default: number of CPUs available to the process, 0: traverse in the calling thread only)");
 	args_parse::Argument<std::chrono::milliseconds> debug_sleep(
 		'd', "debug-sleep", true, new args_parse::Validator<std::chrono::milliseconds>());
-	debug_sleep.SetDescription("Input of the debug sleep thread (ms/s)");
+	debug_sleep.SetDescription("Input of the debug sleep thread (ns/us/ms/s/m/h, e.g. 1m30s)");
 	args_parse::Argument<std::string> source_path('s', "source-path", true, new args_parse::Validator<std::string>());
 	source_path.SetDescription("Enter the directory path (without any delimiter/=) (path)");
 
+	args_parse::Argument<std::string> backend('b', "backend", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::None));
+	backend.SetDescription("Directory reading backend: filesystem (default), getdents (Linux, uses d_type) or uring (Linux, batched statx/openat through io_uring)");
+	args_parse::Argument<unsigned int> queue_depth('q', "queue-depth", true, new args_parse::Validator<unsigned int>());
+	queue_depth.SetDescription("io_uring requests in flight per thread for the uring backend (number, default: 32, 0: synchronous calls)");
+
+	args_parse::Argument<std::string> format("format", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::None));
+	format.SetDescription("Listing format: text (default, indented with thread ids), ndjson (one JSON object per entry), tsv (type, size, mtime, path) or binary (length-prefixed records, 8-byte aligned)");
+	args_parse::Argument<bool> summarize("summarize", false);
+	summarize.SetDescription("Prints du-style directory totals (apparent size, file count, newest mtime) sorted by size instead of listings");
+	args_parse::Argument<unsigned int> max_depth("max-depth", true, new args_parse::Validator<unsigned int>());
+	max_depth.SetDescription("Deepest directory level shown by --summarize (number, 0: source path only)");
+	args_parse::Argument<unsigned int> top("top", true, new args_parse::Validator<unsigned int>());
+	top.SetDescription("Largest directories shown by --summarize (number)");
+
+	args_parse::Argument<bool> find_duplicates("find-duplicates", false);
+	find_duplicates.SetDescription("Prints groups of files with identical content (compared by size, first and last 4 KiB, then full hash) instead of listings");
+	args_parse::Argument<unsigned int> io_budget("io-budget", true, new args_parse::Validator<unsigned int>());
+	io_budget.SetDescription("MiB of file data read at once by --find-duplicates (number, default: 64)");
+	args_parse::Argument<std::string> snapshot_file("snapshot", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::Writable));
+	snapshot_file.SetDescription("Snapshot file of the previous run: unchanged directories (by mtime/ctime) are not re-read, the new snapshot replaces it (path)");
+	args_parse::Argument<bool> dedupe("dedupe", false);
+	dedupe.SetDescription("Reads every directory once by device and inode (directories reached again through symlinks or bind mounts are skipped) and counts the size of hardlinked files once in --summarize and --find-duplicates");
+	args_parse::Argument<unsigned int> dedupe_capacity("dedupe-capacity", true, new args_parse::Validator<unsigned int>());
+	dedupe_capacity.SetDescription("Directories and hardlinked files tracked by --dedupe without locking, 16 bytes each; more still work through a locked fallback (number, default: 1048576)");
+
+	args_parse::Argument<std::string> schedule("schedule", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::None));
+	schedule.SetDescription("Task order: dfs (default, depth-first), bfs (breadth-first) or hybrid (depth-first, subdirectories are traversed inline once --max-pending tasks are queued)");
+	args_parse::Argument<unsigned int> max_pending("max-pending", true, new args_parse::Validator<unsigned int>());
+	max_pending.SetDescription("Queued task limit of --schedule=hybrid (number, default: 4096)");
+	args_parse::Argument<std::string> affinity("affinity", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::None));
+	affinity.SetDescription("Worker placement from /sys/devices/system topology: none (default, not pinned), compact (pinned, fills one NUMA node first) or spread (pinned, round-robin over NUMA nodes); pinned workers prefer tasks of their own node");
+	args_parse::Argument<std::string> cpus("cpus", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::None));
+	cpus.SetDescription("Pins worker threads to these CPUs in turn, e.g. 0-7,16-23 (overrides --affinity)");
+	args_parse::Argument<bool> stats("stats", false);
+	stats.SetDescription("Prints traversal and thread pool statistics (tasks, queue wait, directory read time, entries/s, output, lock times) to stderr");
+	args_parse::Argument<std::string> stats_json("stats-json", true, new args_parse::Validator<std::string>(args_parse::PathPolicy::Writable));
+	stats_json.SetDescription("Writes the same statistics as JSON to a file (path)");
+
 	parser.Add(&help);
 	parser.Add(&thread_pool);
 	parser.Add(&debug_sleep);
 	parser.Add(&source_path);
-
-	if (parser.Parse()) {
-		if (help.GetIsDefined()) {
-			parser.ShowHelp();
+	parser.Add(&backend);
+	parser.Add(&queue_depth);
+	parser.Add(&format);
+	parser.Add(&summarize);
+	parser.Add(&max_depth);
+	parser.Add(&top);
+	parser.Add(&find_duplicates);
+	parser.Add(&io_budget);
+	parser.Add(&snapshot_file);
+	parser.Add(&dedupe);
+	parser.Add(&dedupe_capacity);
+	parser.Add(&schedule);
+	parser.Add(&max_pending);
+	parser.Add(&affinity);
+	parser.Add(&cpus);
+	parser.Add(&stats);
+	parser.Add(&stats_json);
+
+	const args_parse::ParseResult result = parser.Parse();
+	// Все ошибки разбора выводятся одной записью; скрипт узнает о них по коду возврата
+	result.Render(std::cerr);
+	if (!result)
+		return 1;
+	if (help.GetIsDefined()) {
+		parser.ShowHelp();
+	}
+	if (source_path.GetIsDefined()) {
+
+		std::filesystem::path sourcePath = source_path.GetValue().value();
+		// По умолчанию по потоку на доступный процессу процессор; 0 - обход только в текущем потоке
+		const CpuTopology topology = CpuTopology::Detect();
+		unsigned int threadPool = thread_pool.GetIsDefined() ? thread_pool.GetValue().value() : topology.CpuCount();
+		std::chrono::milliseconds debugSleep = debug_sleep.GetIsDefined() ? debug_sleep.GetValue() : std::chrono::milliseconds(0);
+		const std::optional<TraversalBackend> traversalBackend =
+			backend.GetIsDefined() ? ParseTraversalBackend(backend.GetValue().value()) : TraversalBackend::Filesystem;
+		if (!traversalBackend) {
+			std::cerr << "Unknown or unsupported backend: " << backend.GetValue().value() << '\n';
+			return 1;
+		}
+		const std::optional<SchedulingPolicy> policy =
+			schedule.GetIsDefined() ? ParseSchedulingPolicy(schedule.GetValue().value()) : SchedulingPolicy::DepthFirst;
+		if (!policy) {
+			std::cerr << "Unknown scheduling policy: " << schedule.GetValue().value() << '\n';
+			return 1;
+		}
+		const std::optional<OutputFormat> outputFormat =
+			format.GetIsDefined() ? ParseOutputFormat(format.GetValue().value()) : OutputFormat::Text;
+		if (!outputFormat) {
+			std::cerr << "Unknown output format: " << format.GetValue().value() << '\n';
+			return 1;
+		}
+		const std::optional<AffinityPolicy> affinityPolicy =
+			affinity.GetIsDefined() ? ParseAffinityPolicy(affinity.GetValue().value()) : AffinityPolicy::None;
+		if (!affinityPolicy) {
+			std::cerr << "Unknown affinity policy: " << affinity.GetValue().value() << '\n';
+			return 1;
+		}
+		WorkerPlacement placement = PlanPlacement(topology, threadPool, *affinityPolicy);
+		if (cpus.GetIsDefined()) {
+			const std::optional<std::vector<unsigned>> cpuList = ParseCpuList(cpus.GetValue().value());
+			if (!cpuList) {
+				std::cerr << "Invalid CPU list: " << cpus.GetValue().value() << '\n';
+				return 1;
+			}
+			try {
+				placement = PlanPlacement(topology, threadPool, *cpuList);
+			}
+			catch (const std::invalid_argument& error) {
+				std::cerr << error.what() << '\n';
+				return 1;
+			}
+		}
+#ifdef __linux__
+		if (*traversalBackend == TraversalBackend::Uring && !IoUringAvailable())
+			std::cerr << "io_uring is not available, the uring backend falls back to synchronous calls\n";
+#endif
+		// Статистика создается первой: пул и поток записи пользуются ею до своего разрушения
+		std::optional<Stats> statistics;
+		if (stats.GetIsDefined() || stats_json.GetIsDefined())
+			statistics.emplace();
+		Stats* const statsInUse = statistics ? &*statistics : nullptr;
+		// Поток записи создается раньше пула: задачи, оставшиеся при разрушении пула, еще могут выводить
+		OutputWriter output(OutputWriter::DefaultBudget, statsInUse);
+		NodeTable nodes;
+		ThreadPool pool(threadPool, debugSleep, statsInUse, *policy,
+			max_pending.GetIsDefined() ? std::max(1u, max_pending.GetValue().value()) : ThreadPool::DefaultPendingLimit, placement);
+		TraversalContext context{ pool, nodes, output, debugSleep };
+		context._stats = statsInUse;
+		context._format = *outputFormat;
+		if (queue_depth.GetIsDefined())
+			context._queueDepth = queue_depth.GetValue().value();
+
+		// В режиме сводки списки директорий не выводятся, итоги печатаются после обхода
+		SummaryTable summary;
+		if (summarize.GetIsDefined())
+			context._summary = &summary;
+
+		DuplicateFinder duplicates(io_budget.GetIsDefined()
+			? std::max<std::size_t>(1, io_budget.GetValue().value()) * 1024 * 1024 : DuplicateFinder::DefaultBudget);
+		if (find_duplicates.GetIsDefined())
+			context._duplicates = &duplicates;
+
+		// Множество посещенных пар (устройство, inode) общее для всех потоков пула
+		std::optional<InodeSet> visited;
+		if (dedupe.GetIsDefined()) {
+			visited.emplace(dedupe_capacity.GetIsDefined() ? dedupe_capacity.GetValue().value() : InodeSet::DefaultCapacity);
+			context._visited = &*visited;
 		}
-		if (source_path.GetIsDefined()) {
 
-			std::filesystem::path sourcePath = source_path.GetValue().value();
-			unsigned int threadPool = thread_pool.GetIsDefined() ? thread_pool.GetValue().value() : 0;
-			std::chrono::milliseconds debugSleep = debug_sleep.GetIsDefined() ? debug_sleep.GetValue() : std::chrono::milliseconds(0);
-			ThreadPool pool(threadPool, debugSleep);
+		// Снимок предыдущего обхода читается, если он есть и не поврежден; новый пишется после обхода
+		std::optional<SnapshotReader> previous;
+		SnapshotWriter snapshot(SnapshotFlags(*traversalBackend));
+		if (snapshot_file.GetIsDefined()) {
+			const std::filesystem::path file = snapshot_file.GetValue().value();
+			if (std::filesystem::exists(file)) {
+				previous.emplace(file);
+				if (!previous->Valid())
+					std::cerr << "Ignoring snapshot " << file.string() << ": " << previous->Error() << '\n';
+				else if (previous->Flags() != SnapshotFlags(*traversalBackend))
+					std::cerr << "Ignoring snapshot " << file.string() << ": it was written by a backend that lists directories differently\n";
+				else
+					context._previous = &*previous;
+			}
+			context._snapshot = &snapshot;
+		}
 
-			TraverseDirectory(sourcePath, pool, debugSleep);
+		TraverseDirectory(sourcePath, context, *traversalBackend);
+		if (context._snapshot != nullptr) {
+			std::string error;
+			if (!snapshot.Save(snapshot_file.GetValue().value(), nodes, error))
+				std::cerr << "Snapshot was not saved: " << error << '\n';
+			else
+				std::cerr << "Snapshot: " << snapshot.Reused() << " of " << snapshot.Directories() << " directories reused\n";
+		}
+		if (context._duplicates != nullptr) {
+			// Хэши считаются тем же пулом после обхода
+			output.Write(DuplicateFinder::Report(duplicates.Find(pool, nodes), nodes));
+			output.Flush();
+		}
+		if (context._summary != nullptr) {
+			output.Write(summary.Report(nodes,
+				max_depth.GetIsDefined() ? max_depth.GetValue().value() : SummaryTable::Unlimited,
+				top.GetIsDefined() ? top.GetValue().value() : SummaryTable::Unlimited));
+			output.Flush();
+		}
+		if (statistics) {
+			const StatsReport report = statistics->Collect();
+			if (stats.GetIsDefined())
+				std::cerr << report.Table();
+			if (stats_json.GetIsDefined()) {
+				std::ofstream file(stats_json.GetValue().value(), std::ios::binary | std::ios::trunc);
+				if (!(file << report.Json()))
+					std::cerr << "Statistics were not written to " << stats_json.GetValue().value() << '\n';
+			}
 		}
+		// Как у du: неоткрытые директории (сообщены в stderr) дают ненулевой код возврата
+		if (context._openFailures.load() != 0)
+			return 1;
 	}
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	/// Включен ли подсчет выделений памяти
+	std::atomic<bool> g_countAllocations{ false };
+	/// Количество выделений памяти при включенном подсчете
+	std::atomic<std::size_t> g_allocations{ 0 };
+
+	void* CountedAllocate(std::size_t size) {
+		if (g_countAllocations.load(std::memory_order_relaxed))
+			g_allocations.fetch_add(1, std::memory_order_relaxed);
+		if (void* ptr = std::malloc(size == 0 ? 1 : size))
+			return ptr;
+		throw std::bad_alloc();
+	}
+
+	/// @brief Подсчет выделений памяти в пределах области видимости
+	struct AllocationScope {
+		AllocationScope() {
+			g_allocations.store(0);
+			g_countAllocations.store(true);
+		}
+		~AllocationScope() { g_countAllocations.store(false); }
+
+		[[nodiscard]] std::size_t Count() const { return g_allocations.load(); }
+	};
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+TEST_CASE("Parse does not allocate on a frozen schema", "[ArgsParser][alloc]") {
+	const char* argv[] = { "worker", "-v", "--thread-pool=16", "-n-42", "--ratio=0.75",
+		"--timeout=1m30s", "-d250ms", "--verb", "--thread=8", "--retries=3" };
+	const int argc = static_cast<int>(std::size(argv));
+
+	args_parse::Validator<unsigned int> unsignedValidator;
+	args_parse::Validator<int> intValidator;
+	args_parse::Validator<float> floatValidator;
+	args_parse::Validator<std::chrono::milliseconds> durationValidator;
+
+	args_parse::Argument<bool> verbose('v', "verbose", false);
+	args_parse::Argument<unsigned int> threadPool('t', "thread-pool", true, &unsignedValidator);
+	args_parse::Argument<int> number('n', "number", true, &intValidator);
+	args_parse::Argument<float> ratio('r', "ratio", true, &floatValidator);
+	args_parse::Argument<std::chrono::milliseconds> timeout("timeout", true, &durationValidator);
+	args_parse::Argument<std::chrono::milliseconds> debugSleep('d', "debug-sleep", true, &durationValidator);
+	args_parse::Argument<unsigned int> retries("retries", true, &unsignedValidator);
+	verbose.SetDescription("Verbose output with a description long enough to defeat SSO");
+
+	args_parse::ArgsParser parser(argc, argv);
+	parser.Add(&verbose);
+	parser.Add(&threadPool);
+	parser.Add(&number);
+	parser.Add(&ratio);
+	parser.Add(&timeout);
+	parser.Add(&debugSleep);
+	parser.Add(&retries);
+	parser.Freeze();
+
+	bool parsed = false;
+	std::size_t allocations = 0;
+	{
+		AllocationScope scope;
+		parsed = parser.Parse().Ok();
+		allocations = scope.Count();
+	}
+
+	REQUIRE(parsed);
+	REQUIRE(allocations == 0);
+	REQUIRE(verbose.GetIsDefined());
+	REQUIRE(threadPool.GetValue() == 8u);
+	REQUIRE(number.GetValue() == -42);
+	REQUIRE(ratio.GetValue() == 0.75f);
+	REQUIRE(timeout.GetValue() == std::chrono::seconds(90));
+	REQUIRE(debugSleep.GetValue() == std::chrono::milliseconds(250));
+	REQUIRE(retries.GetValue() == 3u);
+}
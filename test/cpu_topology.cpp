@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <CpuTopology.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	/// @brief Два узла разного размера; номер второго узла не совпадает с его индексом
+	CpuTopology TwoNodes() {
+		CpuTopology topology;
+		topology.nodes.push_back({ 0, { 0, 1, 2 } });
+		topology.nodes.push_back({ 2, { 8, 9 } });
+		return topology;
+	}
+}
+
+TEST_CASE("CPU lists are parsed like sysfs writes them", "[CpuTopology]") {
+	REQUIRE(ParseCpuList("0-3,8,10-11\n") == std::vector<unsigned>{ 0, 1, 2, 3, 8, 10, 11 });
+	REQUIRE(ParseCpuList("5") == std::vector<unsigned>{ 5 });
+	// Список упорядочивается, повторы убираются
+	REQUIRE(ParseCpuList("3,1,1-2") == std::vector<unsigned>{ 1, 2, 3 });
+	REQUIRE(ParseCpuList(std::to_string(MaxCpu - 1)) == std::vector<unsigned>{ MaxCpu - 1 });
+}
+
+TEST_CASE("Malformed CPU lists are rejected", "[CpuTopology]") {
+	for (const char* list : { "", "\n", "3-1", "1,,2", "1-", "-1", "a", "1;2", "0-3,x" }) {
+		INFO("list \"" << list << '"');
+		REQUIRE_FALSE(ParseCpuList(list).has_value());
+	}
+	// Номера от MaxCpu не поддерживаются, в том числе как конец диапазона
+	REQUIRE_FALSE(ParseCpuList(std::to_string(MaxCpu)).has_value());
+	REQUIRE_FALSE(ParseCpuList("0-" + std::to_string(MaxCpu)).has_value());
+}
+
+TEST_CASE("Compact placement fills nodes in order and wraps around", "[CpuTopology]") {
+	const CpuTopology topology = TwoNodes();
+	const WorkerPlacement wrapped = PlanPlacement(topology, 7, AffinityPolicy::Compact);
+	REQUIRE(wrapped.cpus == std::vector<int>{ 0, 1, 2, 8, 9, 0, 1 });
+	REQUIRE(wrapped.nodes == std::vector<unsigned>{ 0, 0, 0, 1, 1, 0, 0 });
+	REQUIRE(wrapped.nodeCount == 2);
+
+	// Потоки уместились в первый узел: очередь одна
+	const WorkerPlacement first = PlanPlacement(topology, 2, AffinityPolicy::Compact);
+	REQUIRE(first.cpus == std::vector<int>{ 0, 1 });
+	REQUIRE(first.nodes == std::vector<unsigned>{ 0, 0 });
+	REQUIRE(first.nodeCount == 1);
+}
+
+TEST_CASE("Spread placement alternates nodes with more threads than CPUs", "[CpuTopology]") {
+	const WorkerPlacement placement = PlanPlacement(TwoNodes(), 7, AffinityPolicy::Spread);
+	REQUIRE(placement.cpus == std::vector<int>{ 0, 8, 1, 9, 2, 8, 0 });
+	REQUIRE(placement.nodes == std::vector<unsigned>{ 0, 1, 0, 1, 0, 1, 0 });
+	REQUIRE(placement.nodeCount == 2);
+}
+
+TEST_CASE("Placement without pinning or threads is empty", "[CpuTopology]") {
+	const WorkerPlacement none = PlanPlacement(TwoNodes(), 4, AffinityPolicy::None);
+	REQUIRE(none.cpus.empty());
+	REQUIRE(none.nodeCount == 1);
+	REQUIRE(PlanPlacement(TwoNodes(), 0, AffinityPolicy::Spread).cpus.empty());
+	REQUIRE(PlanPlacement(CpuTopology{}, 4, AffinityPolicy::Compact).cpus.empty());
+}
+
+TEST_CASE("An explicit CPU list is used in order and must be available", "[CpuTopology]") {
+	const WorkerPlacement placement = PlanPlacement(TwoNodes(), 3, std::vector<unsigned>{ 9, 1 });
+	REQUIRE(placement.cpus == std::vector<int>{ 9, 1, 9 });
+	REQUIRE(placement.nodes == std::vector<unsigned>{ 1, 0, 1 });
+	REQUIRE(placement.nodeCount == 2);
+	REQUIRE_THROWS_AS(PlanPlacement(TwoNodes(), 2, std::vector<unsigned>{ 5 }), std::invalid_argument);
+}
@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+
+#include <filesystem>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	/// @brief Разбор argv с набором аргументов флаг/число; возвращает результат разбора
+	struct DiagnosticCli {
+		args_parse::Validator<unsigned int> unsignedValidator;
+		args_parse::Argument<bool> verbose{ 'v', "verbose", false };
+		args_parse::Argument<unsigned int> threads{ 't', "threads", true, &unsignedValidator };
+		args_parse::Argument<unsigned int> threadPool{ "thread-pool", true, &unsignedValidator };
+
+		args_parse::ParseResult Parse(std::vector<const char*> argv, args_parse::DiagnosticsSink* sink = nullptr) {
+			argv.insert(argv.begin(), "program");
+			_argv = std::move(argv);
+			args_parse::ArgsParser parser(static_cast<int>(_argv.size()), _argv.data());
+			parser.Add(&verbose);
+			parser.Add(&threads);
+			parser.Add(&threadPool);
+			parser.SetDiagnosticsSink(sink);
+			return parser.Parse();
+		}
+
+	private:
+		std::vector<const char*> _argv;
+	};
+
+	/// @brief Единственная ошибка разбора
+	args_parse::Diagnostic Single(const args_parse::ParseResult& result) {
+		REQUIRE(result.diagnostics.size() == 1);
+		return result.diagnostics.front();
+	}
+
+	/// @brief Получатель, запоминающий ошибки
+	class CollectingSink : public args_parse::DiagnosticsSink {
+	public:
+		void Report(const args_parse::Diagnostic& diagnostic) override { reported.push_back(diagnostic); }
+
+		std::vector<args_parse::Diagnostic> reported;
+	};
+}
+
+TEST_CASE("InvalidFormat diagnostic", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const args_parse::Diagnostic diagnostic = Single(cli.Parse({ "-v", "stray" }));
+	REQUIRE(diagnostic.kind == args_parse::DiagnosticKind::InvalidFormat);
+	REQUIRE(diagnostic.tokenIndex == 2);
+	REQUIRE(diagnostic.token == "stray");
+	REQUIRE(cli.verbose.GetIsDefined());
+}
+
+TEST_CASE("UnknownArgument diagnostic", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const args_parse::Diagnostic diagnostic = Single(cli.Parse({ "--output=file" }));
+	REQUIRE(diagnostic.kind == args_parse::DiagnosticKind::UnknownArgument);
+	REQUIRE(diagnostic.tokenIndex == 1);
+	REQUIRE(diagnostic.name == "output");
+	REQUIRE(diagnostic.value == "file");
+}
+
+TEST_CASE("AmbiguousPrefix diagnostic", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const args_parse::Diagnostic diagnostic = Single(cli.Parse({ "--thread=4" }));
+	REQUIRE(diagnostic.kind == args_parse::DiagnosticKind::AmbiguousPrefix);
+	REQUIRE(diagnostic.name == "thread");
+	REQUIRE_FALSE(cli.threads.GetIsDefined());
+	REQUIRE_FALSE(cli.threadPool.GetIsDefined());
+}
+
+TEST_CASE("MissingValue diagnostic", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const args_parse::Diagnostic diagnostic = Single(cli.Parse({ "--threads" }));
+	REQUIRE(diagnostic.kind == args_parse::DiagnosticKind::MissingValue);
+	REQUIRE(diagnostic.token == "--threads");
+}
+
+TEST_CASE("InvalidValue diagnostic", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const args_parse::Diagnostic diagnostic = Single(cli.Parse({ "-t=-3" }));
+	REQUIRE(diagnostic.kind == args_parse::DiagnosticKind::InvalidValue);
+	REQUIRE(diagnostic.name == "t");
+	REQUIRE(diagnostic.value == "-3");
+	REQUIRE_FALSE(cli.threads.GetValue().has_value());
+}
+
+TEST_CASE("ResponseFileUnreadable diagnostic", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const std::string token = "@" + (std::filesystem::temp_directory_path() / "args_parse_test_no_such.rsp").string();
+	const args_parse::Diagnostic diagnostic = Single(cli.Parse({ token.c_str() }));
+	REQUIRE(diagnostic.kind == args_parse::DiagnosticKind::ResponseFileUnreadable);
+	REQUIRE(diagnostic.token == token);
+}
+
+TEST_CASE("ResponseFileCycle and ResponseFileTooDeep diagnostics", "[Diagnostics]") {
+	// Подробно проверяются в response_file.cpp; здесь - текст для каждого вида ошибки
+	args_parse::ParseResult result;
+	result.Add({ 1, args_parse::DiagnosticKind::ResponseFileCycle, "@a.rsp", "a.rsp", {} });
+	result.Add({ 2, args_parse::DiagnosticKind::ResponseFileTooDeep, "@b.rsp", "b.rsp", {} });
+	std::ostringstream text;
+	result.Render(text);
+	REQUIRE(text.str() == "Response file includes itself: @a.rsp\nResponse files are nested too deeply: @b.rsp\n");
+}
+
+TEST_CASE("All errors are collected and rendered in order", "[Diagnostics]") {
+	DiagnosticCli cli;
+	const args_parse::ParseResult result = cli.Parse({ "stray", "--zzzzzzzz", "--threads", "-t=x", "-v" });
+	REQUIRE_FALSE(result.Ok());
+	REQUIRE(result.diagnostics.size() == 4);
+	REQUIRE(cli.verbose.GetIsDefined());
+
+	std::ostringstream text;
+	result.Render(text);
+	REQUIRE(text.str() ==
+		"Invalid argument format: stray\n"
+		"Unknown argument: --zzzzzzzz\n"
+		"Missing value for argument: --threads\n"
+		"Invalid value for argument: -t=x\n");
+
+	std::ostringstream empty;
+	DiagnosticCli ok;
+	ok.Parse({ "-v" }).Render(empty);
+	REQUIRE(empty.str().empty());
+}
+
+TEST_CASE("A diagnostics sink receives errors instead of the result", "[Diagnostics]") {
+	DiagnosticCli cli;
+	CollectingSink sink;
+	const args_parse::ParseResult result = cli.Parse({ "--threads", "stray" }, &sink);
+	REQUIRE(result.Ok());
+	REQUIRE(sink.reported.size() == 2);
+	REQUIRE(sink.reported[0].kind == args_parse::DiagnosticKind::MissingValue);
+	REQUIRE(sink.reported[1].kind == args_parse::DiagnosticKind::InvalidFormat);
+}
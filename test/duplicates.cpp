@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Duplicates.hpp>
+
+#include "traversal_support.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	/// @brief Содержимое файла размером size без повторяющихся блоков
+	std::string Content(std::size_t size) {
+		std::string text(size, '\0');
+		for (std::size_t i = 0; i < size; ++i)
+			text[i] = static_cast<char>((i * 31 + i / 251) % 256);
+		return text;
+	}
+
+	/// @brief Пары файлов в корне дерева, учтенные поиском так же, как их учел бы обход
+	class Files {
+	public:
+		explicit Files(const std::filesystem::path& root) : _root(root), _rootNode(_nodes.AddRoot(root.string())) {}
+
+		/// @brief Создание файла name с содержимым text
+		void Add(const std::string& name, const std::string& text) {
+			std::ofstream(_root / name, std::ios::binary) << text;
+			_files.emplace_back(name, text.size());
+		}
+
+		/// @brief Учет всех файлов одной директорией и поиск групп; before - действие между учетом и поиском
+		template<typename Action>
+		std::vector<std::vector<std::string>> Find(DuplicateFinder& finder, Action before) {
+			std::vector<NodeTable::Entry> entries;
+			for (const auto& [name, size] : _files)
+				entries.push_back({ NodeType::File, _nodes.StoreName(name), size });
+			finder.AddListing(_nodes.Append(_rootNode, entries), entries);
+			before();
+			ThreadPool pool(2, std::chrono::milliseconds(0));
+			std::vector<std::vector<std::string>> groups;
+			for (const DuplicateGroup& group : finder.Find(pool, _nodes)) {
+				std::vector<std::string> names;
+				for (const std::uint32_t node : group.nodes)
+					names.emplace_back(_nodes.Name(_nodes[node]));
+				std::sort(names.begin(), names.end());
+				groups.push_back(names);
+			}
+			return groups;
+		}
+
+	private:
+		std::filesystem::path _root;
+		NodeTable _nodes;
+		std::uint32_t _rootNode;
+		std::vector<std::pair<std::string, std::uint64_t>> _files;
+	};
+
+	/// @brief Копия text с измененным байтом at
+	std::string Changed(std::string text, std::size_t at) {
+		text[at] = static_cast<char>(text[at] ^ 0x5A);
+		return text;
+	}
+}
+
+TEST_CASE("Only files with identical content are grouped", "[Duplicates]") {
+	const test_support::TemporaryTree tree("directory_travers_test_duplicates");
+	Files files(tree.Root());
+	// У каждой пары свой размер, чтобы пары не смешивались
+	const std::size_t large = 4 * DuplicateFinder::ProbeSize + 100;
+	files.Add("same_1", Content(large));
+	files.Add("same_2", Content(large));
+	files.Add("small_1", Content(100));
+	files.Add("small_2", Content(100));
+	// Отличие в начале, в конце и в середине, которую не покрывают ни начало, ни конец
+	const std::string head = Content(large + 1);
+	files.Add("head_1", head);
+	files.Add("head_2", Changed(head, 0));
+	const std::string tail = Content(large + 2);
+	files.Add("tail_1", tail);
+	files.Add("tail_2", Changed(tail, tail.size() - 1));
+	const std::string middle = Content(large + 3);
+	files.Add("middle_1", middle);
+	files.Add("middle_2", Changed(middle, middle.size() / 2));
+	// Пустые файлы одинаковы, но не рассматриваются
+	files.Add("empty_1", "");
+	files.Add("empty_2", "");
+
+	DuplicateFinder finder;
+	const auto groups = files.Find(finder, [] {});
+	// Группы упорядочены по лишнему месту
+	REQUIRE(groups == std::vector<std::vector<std::string>>{ { "same_1", "same_2" }, { "small_1", "small_2" } });
+}
+
+TEST_CASE("A file that shrinks after the walk is not grouped", "[Duplicates]") {
+	const test_support::TemporaryTree tree("directory_travers_test_duplicates_shrunk");
+	Files files(tree.Root());
+	const std::string text = Content(4 * DuplicateFinder::ProbeSize);
+	files.Add("kept", text);
+	files.Add("shrunk", text);
+	files.Add("copy", text);
+
+	DuplicateFinder finder;
+	const auto groups = files.Find(finder, [&tree, &text] {
+		std::ofstream(tree.Root() / "shrunk", std::ios::binary | std::ios::trunc) << text.substr(0, 100);
+	});
+	REQUIRE(groups == std::vector<std::vector<std::string>>{ { "copy", "kept" } });
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+
+#include <chrono>
+#include <string_view>
+#include <tuple>
+
+namespace {
+	using args_parse::DurationError;
+	using namespace std::chrono_literals;
+
+	DurationError ErrorOf(std::string_view value) {
+		return std::get<0>(args_parse::ParseDuration(value));
+	}
+
+	std::chrono::nanoseconds ValueOf(std::string_view value) {
+		const auto [error, ns] = args_parse::ParseDuration(value);
+		REQUIRE(error == DurationError::None);
+		return ns;
+	}
+
+	// Разбор выполняется и на этапе компиляции
+	static_assert(std::get<1>(args_parse::ParseDuration("1m30s")) == std::chrono::seconds(90));
+}
+
+TEST_CASE("Durations with every unit", "[Validator][duration]") {
+	REQUIRE(ValueOf("15ns") == 15ns);
+	REQUIRE(ValueOf("15us") == 15us);
+	REQUIRE(ValueOf("15ms") == 15ms);
+	REQUIRE(ValueOf("15s") == 15s);
+	REQUIRE(ValueOf("15m") == 15min);
+	REQUIRE(ValueOf("15h") == 15h);
+}
+
+TEST_CASE("Compound and decimal durations", "[Validator][duration]") {
+	REQUIRE(ValueOf("1m30s") == 90s);
+	REQUIRE(ValueOf("1h 2m 3s") == 1h + 2min + 3s);
+	REQUIRE(ValueOf("2s500ms") == 2500ms);
+	REQUIRE(ValueOf("1.5s") == 1500ms);
+	REQUIRE(ValueOf(".5ms") == 500us);
+	REQUIRE(ValueOf("0.25h") == 15min);
+	// Разряды меньше наносекунды отбрасываются
+	REQUIRE(ValueOf("1.0000000009s") == 1s);
+	REQUIRE(ValueOf("1.5ns") == 1ns);
+	REQUIRE(ValueOf("1 ms") == 1ms);
+}
+
+TEST_CASE("Malformed durations report the reason", "[Validator][duration]") {
+	REQUIRE(ErrorOf("") == DurationError::Empty);
+	REQUIRE(ErrorOf("   ") == DurationError::Empty);
+	REQUIRE(ErrorOf("-5s") == DurationError::InvalidNumber);
+	REQUIRE(ErrorOf("s") == DurationError::InvalidNumber);
+	REQUIRE(ErrorOf(".s") == DurationError::InvalidNumber);
+	REQUIRE(ErrorOf("10") == DurationError::InvalidUnit);
+	REQUIRE(ErrorOf("10sec") == DurationError::InvalidUnit);
+	REQUIRE(ErrorOf("10min") == DurationError::InvalidUnit);
+	REQUIRE(ErrorOf("10d") == DurationError::InvalidUnit);
+	REQUIRE(ErrorOf("1s,5") == DurationError::InvalidNumber);
+}
+
+TEST_CASE("Durations that do not fit nanoseconds are rejected", "[Validator][duration]") {
+	// nanoseconds::max() - около 292 лет
+	REQUIRE(ValueOf("9223372036854775807ns") == std::chrono::nanoseconds::max());
+	REQUIRE(ErrorOf("9223372036854775808ns") == DurationError::Overflow);
+	REQUIRE(ErrorOf("2562048h") == DurationError::Overflow);
+	REQUIRE(ErrorOf("99999999999999999999999s") == DurationError::Overflow);
+	// Каждая часть помещается, сумма - нет
+	REQUIRE(ErrorOf("2562047h 2562047h") == DurationError::Overflow);
+}
+
+TEST_CASE("Duration validator converts to milliseconds", "[Validator][duration]") {
+	const args_parse::Validator<std::chrono::milliseconds> validator;
+	REQUIRE(validator.ValidValue("1.5s") == std::make_tuple(true, 1500ms));
+	REQUIRE(validator.Parse("10x") == std::make_tuple(DurationError::InvalidUnit, 0ms));
+	REQUIRE_FALSE(std::get<0>(validator.ValidValue("")));
+}
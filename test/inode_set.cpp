@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <InodeSet.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST_CASE("InodeSet stays exact past its capacity", "[InodeSet]") {
+	// 64 шарда по ProbeLimit ячеек: большая часть пар уходит в запасные множества
+	InodeSet set(64);
+	constexpr std::uint64_t Pairs = 100000;
+	for (std::uint64_t inode = 1; inode <= Pairs; ++inode)
+		REQUIRE(set.Insert(inode % 3, inode));
+	REQUIRE(set.Size() == Pairs);
+	REQUIRE(set.OverflowSize() > 0);
+	REQUIRE(set.OverflowSize() < Pairs);
+
+	// Повторы найдены и в таблицах, и в запасных множествах
+	for (std::uint64_t inode = 1; inode <= Pairs; ++inode)
+		REQUIRE_FALSE(set.Insert(inode % 3, inode));
+	REQUIRE(set.Size() == Pairs);
+	// Тот же inode на другом устройстве - другая пара
+	REQUIRE(set.Insert(7, 1));
+	REQUIRE(set.Size() == Pairs + 1);
+}
+
+TEST_CASE("InodeSet keeps pairs that cannot be encoded", "[InodeSet]") {
+	InodeSet set(1024);
+	// inode от 2^48 и устройство ~0 не кодируются ключом
+	REQUIRE(set.Insert(1, 1ull << 48));
+	REQUIRE(set.Insert(1, ~0ull));
+	REQUIRE(set.Insert(~0ull, 5));
+	REQUIRE_FALSE(set.Insert(1, 1ull << 48));
+	REQUIRE_FALSE(set.Insert(1, ~0ull));
+	REQUIRE_FALSE(set.Insert(~0ull, 5));
+	// Устройства сверх MaxDevices не получают компактного номера
+	for (std::uint64_t device = 0; device < InodeSet::MaxDevices + 100; ++device)
+		REQUIRE(set.Insert(device, 42));
+	for (std::uint64_t device = 0; device < InodeSet::MaxDevices + 100; ++device)
+		REQUIRE_FALSE(set.Insert(device, 42));
+	REQUIRE(set.Size() == 3 + InodeSet::MaxDevices + 100);
+	REQUIRE(set.OverflowSize() >= 3 + 100);
+}
+
+TEST_CASE("Concurrent inserts report every pair exactly once", "[InodeSet]") {
+	// Потоки добавляют пересекающиеся диапазоны; емкость мала, поэтому гонки идут и за запасные множества
+	constexpr unsigned Threads = 8;
+	constexpr std::uint64_t PerThread = 40000;
+	constexpr std::uint64_t Stride = PerThread / 2;
+	InodeSet set(256);
+	std::atomic<std::uint64_t> first{ 0 };
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < Threads; ++t) {
+		threads.emplace_back([&set, &first, t] {
+			std::uint64_t inserted = 0;
+			for (std::uint64_t i = 0; i < PerThread; ++i)
+				inserted += set.Insert(i % 2, t * Stride + i);
+			first.fetch_add(inserted);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	const std::uint64_t distinct = (Threads - 1) * Stride + PerThread;
+	REQUIRE(first.load() == distinct);
+	REQUIRE(set.Size() == distinct);
+	REQUIRE(set.OverflowSize() > 0);
+}
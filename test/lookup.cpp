@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+	/// @brief Набор аргументов, в котором одно длинное имя - префикс другого
+	struct LookupCli {
+		args_parse::Argument<bool> stats{ "stats", false };
+		args_parse::Argument<bool> statsJson{ "stats-json", false };
+		args_parse::Argument<bool> threadPool{ 't', "thread-pool", false };
+		args_parse::Argument<bool> verbose{ 'v', "verbose", false };
+
+		explicit LookupCli(args_parse::ArgsParser& parser) {
+			parser.Add(&stats);
+			parser.Add(&statsJson);
+			parser.Add(&threadPool);
+			parser.Add(&verbose);
+		}
+	};
+
+	/// @brief Поиск длинного имени через FindArgument ("--" + name)
+	args_parse::ArgumentBase* FindLong(const args_parse::ArgsParser& parser, std::string_view token) {
+		return parser.FindArgument({ token, token.substr(2), {} });
+	}
+
+	/// @brief Одни и те же проверки до и после заморозки индекса
+	void CheckLookup(const args_parse::ArgsParser& parser, const LookupCli& cli) {
+		// Точное совпадение имеет приоритет над префиксом другого имени
+		REQUIRE(FindLong(parser, "--stats") == &cli.stats);
+		REQUIRE(FindLong(parser, "--stats-json") == &cli.statsJson);
+		// Уникальный префикс
+		REQUIRE(FindLong(parser, "--stats-") == &cli.statsJson);
+		REQUIRE(FindLong(parser, "--thread") == &cli.threadPool);
+		REQUIRE(FindLong(parser, "--verb") == &cli.verbose);
+		// Неоднозначный префикс и неизвестное имя
+		REQUIRE_THROWS_AS(FindLong(parser, "--sta"), std::invalid_argument);
+		REQUIRE_THROWS_AS(FindLong(parser, "--unknown"), std::invalid_argument);
+		// Однобуквенное длинное имя не считается префиксом
+		REQUIRE_THROWS_AS(FindLong(parser, "--v"), std::invalid_argument);
+		// Короткие имена
+		REQUIRE(parser.FindArgument({ "-t", "t", {} }) == &cli.threadPool);
+		REQUIRE_THROWS_AS(parser.FindArgument({ "-x", "x", {} }), std::invalid_argument);
+	}
+}
+
+TEST_CASE("Exact, unique-prefix and ambiguous long name lookup", "[ArgsParser][lookup]") {
+	const char* argv[] = { "program" };
+	args_parse::ArgsParser parser(1, argv);
+	LookupCli cli(parser);
+
+	SECTION("Before Freeze") {
+		REQUIRE_FALSE(parser.IsFrozen());
+		CheckLookup(parser, cli);
+	}
+
+	SECTION("After Freeze") {
+		parser.Freeze();
+		REQUIRE(parser.IsFrozen());
+		CheckLookup(parser, cli);
+	}
+}
+
+TEST_CASE("Frozen parser rejects new arguments and duplicate names", "[ArgsParser][lookup]") {
+	const char* argv[] = { "program" };
+	args_parse::ArgsParser parser(1, argv);
+	LookupCli cli(parser);
+	args_parse::Argument<bool> duplicate("stats", false);
+	REQUIRE_THROWS_AS(parser.Add(&duplicate), std::invalid_argument);
+
+	parser.Freeze();
+	args_parse::Argument<bool> late("late", false);
+	REQUIRE_THROWS_AS(parser.Add(&late), std::logic_error);
+}
+
+TEST_CASE("Parse resolves exact names before prefixes", "[ArgsParser][lookup]") {
+	const char* argv[] = { "program", "--stats", "--thread", "-v" };
+	args_parse::ArgsParser parser(static_cast<int>(std::size(argv)), argv);
+	LookupCli cli(parser);
+
+	const args_parse::ParseResult result = parser.Parse();
+	REQUIRE(result.Ok());
+	REQUIRE(cli.stats.GetIsDefined());
+	REQUIRE_FALSE(cli.statsJson.GetIsDefined());
+	REQUIRE(cli.threadPool.GetIsDefined());
+	REQUIRE(cli.verbose.GetIsDefined());
+
+	const char* ambiguous[] = { "program", "--sta" };
+	args_parse::ArgsParser second(2, ambiguous);
+	LookupCli other(second);
+	const args_parse::ParseResult failed = second.Parse();
+	REQUIRE(failed.diagnostics.size() == 1);
+	REQUIRE(failed.diagnostics[0].kind == args_parse::DiagnosticKind::AmbiguousPrefix);
+	REQUIRE_FALSE(other.stats.GetIsDefined());
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <NodeTable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Добавление одной записи под parent
+	std::uint32_t AddChild(NodeTable& nodes, std::uint32_t parent, const std::string& name, NodeType type = NodeType::Directory) {
+		const std::vector<NodeTable::Entry> entries{ { type, nodes.StoreName(name), 0 } };
+		return nodes.Append(parent, entries);
+	}
+
+	/// @brief Полный путь узла
+	std::string PathOf(const NodeTable& nodes, std::uint32_t index) {
+		std::string path;
+		nodes.AppendPath(path, index);
+		return path;
+	}
+}
+
+TEST_CASE("AppendPath joins names from the root", "[NodeTable]") {
+	NodeTable nodes;
+	const std::uint32_t root = nodes.AddRoot("/data");
+	const std::uint32_t directory = AddChild(nodes, root, "logs");
+	const std::uint32_t file = AddChild(nodes, directory, "today.txt", NodeType::File);
+
+	REQUIRE(PathOf(nodes, root) == "/data");
+	REQUIRE(PathOf(nodes, directory) == "/data/logs");
+	REQUIRE(PathOf(nodes, file) == "/data/logs/today.txt");
+	REQUIRE(nodes[file].parent == directory);
+	REQUIRE(nodes[file].type == NodeType::File);
+	REQUIRE(nodes.Name(nodes[file]) == "today.txt");
+
+	// Разделитель после корня не удваивается
+	const std::uint32_t slashRoot = nodes.AddRoot("/data/");
+	REQUIRE(PathOf(nodes, AddChild(nodes, slashRoot, "x")) == "/data/x");
+
+	// Путь дописывается к уже имеющейся строке
+	std::string prefixed = "path: ";
+	nodes.AppendPath(prefixed, file);
+	REQUIRE(prefixed == "path: /data/logs/today.txt");
+}
+
+TEST_CASE("AppendPath handles chains deeper than its stack buffer", "[NodeTable]") {
+	NodeTable nodes;
+	std::uint32_t current = nodes.AddRoot("root");
+	std::string expected = "root";
+	// Цепочка длиннее 256 уровней уходит в дополнительный вектор
+	for (int depth = 1; depth <= 1000; ++depth) {
+		const std::string name = "d" + std::to_string(depth);
+		current = AddChild(nodes, current, name);
+		expected += '/' + name;
+		if (depth == 255 || depth == 256 || depth == 257 || depth == 1000)
+			REQUIRE(PathOf(nodes, current) == expected);
+	}
+}
+
+TEST_CASE("Append reserves consecutive indices across segments", "[NodeTable]") {
+	NodeTable nodes;
+	const std::uint32_t root = nodes.AddRoot("root");
+	// Больше одного сегмента (65536 узлов)
+	std::vector<NodeTable::Entry> entries;
+	for (int i = 0; i < 70000; ++i)
+		entries.push_back({ NodeType::File, nodes.StoreName("f" + std::to_string(i)), static_cast<std::uint64_t>(i) });
+	const std::uint32_t first = nodes.Append(root, entries);
+
+	REQUIRE(first == root + 1);
+	REQUIRE(nodes.Size() == 70001);
+	for (std::uint32_t i : { 0u, 65534u, 65535u, 65536u, 69999u }) {
+		REQUIRE(nodes[first + i].size == i);
+		REQUIRE(PathOf(nodes, first + i) == "root/f" + std::to_string(i));
+	}
+}
+
+TEST_CASE("Threads append with their own name arenas", "[NodeTable]") {
+	constexpr unsigned Threads = 4;
+	constexpr int PerThread = 5000;
+	NodeTable nodes;
+	const std::uint32_t root = nodes.AddRoot("root");
+	std::vector<std::vector<std::uint32_t>> added(Threads);
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < Threads; ++t) {
+		threads.emplace_back([&nodes, &added, root, t] {
+			for (int i = 0; i < PerThread; ++i)
+				added[t].push_back(AddChild(nodes, root, "t" + std::to_string(t) + "_" + std::to_string(i)));
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	REQUIRE(nodes.Size() == 1 + Threads * PerThread);
+	for (unsigned t = 0; t < Threads; ++t) {
+		for (int i = 0; i < PerThread; ++i)
+			REQUIRE(nodes.Name(nodes[added[t][i]]) == "t" + std::to_string(t) + "_" + std::to_string(i));
+	}
+}
+
+TEST_CASE("A thread switching between tables keeps one arena per table", "[NodeTable]") {
+	// Раньше каждая смена таблицы заводила новую арену 1 МиБ, а после 4096 смен - исключение
+	constexpr std::uint32_t Switches = 5000;
+	NodeTable first;
+	NodeTable second;
+	const std::uint32_t firstRoot = first.AddRoot("first");
+	const std::uint32_t secondRoot = second.AddRoot("second");
+	std::vector<std::uint32_t> added;
+	std::size_t initialUsage = 0;
+	for (std::uint32_t i = 0; i < Switches; ++i) {
+		added.push_back(AddChild(first, firstRoot, "a" + std::to_string(i)));
+		AddChild(second, secondRoot, "b" + std::to_string(i));
+		if (i == 0)
+			initialUsage = first.MemoryUsage();
+	}
+	for (std::uint32_t i = 0; i < Switches; ++i)
+		REQUIRE(first.Name(first[added[i]]) == "a" + std::to_string(i));
+	// Все имена уместились в первый блок той же арены, узлы - в первый сегмент
+	REQUIRE(first.MemoryUsage() == initialUsage);
+}
@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+
+TEST_CASE("Numeric values take the whole string", "[Validator][numbers]") {
+	const args_parse::Validator<int> intValidator;
+	REQUIRE(intValidator.ValidValue("42") == std::make_tuple(true, 42));
+	REQUIRE(intValidator.ValidValue("-42") == std::make_tuple(true, -42));
+	REQUIRE(intValidator.ValidValue("+7") == std::make_tuple(true, 7));
+
+	// Пустая строка, мусор в конце и в начале, пробелы
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("12abc")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("abc")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue(" 12")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("12 ")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("+")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("+-1")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("1.5")));
+}
+
+TEST_CASE("Numeric values reject overflow", "[Validator][numbers]") {
+	const args_parse::Validator<int> intValidator;
+	REQUIRE(intValidator.ValidValue("2147483647") == std::make_tuple(true, std::numeric_limits<int>::max()));
+	REQUIRE(intValidator.ValidValue("-2147483648") == std::make_tuple(true, std::numeric_limits<int>::min()));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("2147483648")));
+	REQUIRE_FALSE(std::get<0>(intValidator.ValidValue("-2147483649")));
+
+	const args_parse::Validator<std::uint8_t> byteValidator;
+	REQUIRE(byteValidator.ValidValue("255") == std::make_tuple(true, std::uint8_t{ 255 }));
+	REQUIRE_FALSE(std::get<0>(byteValidator.ValidValue("256")));
+
+	const args_parse::Validator<unsigned long long> wideValidator;
+	REQUIRE(wideValidator.ValidValue("18446744073709551615") == std::make_tuple(true, std::numeric_limits<unsigned long long>::max()));
+	REQUIRE_FALSE(std::get<0>(wideValidator.ValidValue("18446744073709551616")));
+}
+
+TEST_CASE("Unsigned values reject a sign", "[Validator][numbers]") {
+	const args_parse::Validator<unsigned int> unsignedValidator;
+	REQUIRE(unsignedValidator.ValidValue("0") == std::make_tuple(true, 0u));
+	REQUIRE(unsignedValidator.ValidValue("+5") == std::make_tuple(true, 5u));
+	// istringstream превращал "-5" в 4294967291; from_chars отклоняет знак
+	REQUIRE_FALSE(std::get<0>(unsignedValidator.ValidValue("-5")));
+	REQUIRE_FALSE(std::get<0>(unsignedValidator.ValidValue("-0")));
+	REQUIRE_FALSE(std::get<0>(unsignedValidator.ValidValue("4294967296")));
+}
+
+TEST_CASE("Floating-point values", "[Validator][numbers]") {
+	const args_parse::Validator<double> doubleValidator;
+	REQUIRE(doubleValidator.ValidValue("10.5") == std::make_tuple(true, 10.5));
+	REQUIRE(doubleValidator.ValidValue("-0.25") == std::make_tuple(true, -0.25));
+	REQUIRE(doubleValidator.ValidValue("1e3") == std::make_tuple(true, 1000.0));
+	REQUIRE_FALSE(std::get<0>(doubleValidator.ValidValue("10,5")));
+	REQUIRE_FALSE(std::get<0>(doubleValidator.ValidValue("1.5x")));
+	REQUIRE_FALSE(std::get<0>(doubleValidator.ValidValue("1e999")));
+}
+
+TEST_CASE("Character values are read as a single character", "[Validator][numbers]") {
+	const args_parse::Validator<char> charValidator;
+	REQUIRE(charValidator.ValidValue("x") == std::make_tuple(true, 'x'));
+	// Число - не код символа: читается первый символ, как у operator>>
+	REQUIRE(charValidator.ValidValue("65") == std::make_tuple(true, '6'));
+	REQUIRE_FALSE(std::get<0>(charValidator.ValidValue("")));
+
+	// Байтовые целые остаются числами
+	REQUIRE(args_parse::Validator<signed char>{}.ValidValue("65") == std::make_tuple(true, static_cast<signed char>(65)));
+	STATIC_REQUIRE_FALSE(args_parse::IsFromCharsNumber<char>);
+	STATIC_REQUIRE_FALSE(args_parse::IsFromCharsNumber<wchar_t>);
+	STATIC_REQUIRE_FALSE(args_parse::IsFromCharsNumber<char16_t>);
+	STATIC_REQUIRE_FALSE(args_parse::IsFromCharsNumber<char32_t>);
+	STATIC_REQUIRE_FALSE(args_parse::IsFromCharsNumber<bool>);
+	STATIC_REQUIRE(args_parse::IsFromCharsNumber<unsigned char>);
+	STATIC_REQUIRE(args_parse::IsFromCharsNumber<double>);
+}
@@ -0,0 +1,272 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <OutputFormat.hpp>
+#include <Traversal.hpp>
+
+#include "traversal_support.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
+
+namespace {
+	/// @brief Допустима ли строка как UTF-8 (проверка независимо от OutputFormat.cpp)
+	bool IsUtf8(std::string_view text) {
+		for (std::size_t i = 0; i < text.size();) {
+			const unsigned char c = static_cast<unsigned char>(text[i]);
+			std::size_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+			if (length == 0 || text.size() - i < length)
+				return false;
+			std::uint32_t code = length == 1 ? c : c & (0xFF >> (length + 1));
+			for (std::size_t k = 1; k < length; ++k) {
+				const unsigned char next = static_cast<unsigned char>(text[i + k]);
+				if ((next & 0xC0) != 0x80)
+					return false;
+				code = (code << 6) | (next & 0x3F);
+			}
+			const std::uint32_t least[] = { 0, 0, 0x80, 0x800, 0x10000 };
+			if (code < least[length] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+				return false;
+			i += length;
+		}
+		return true;
+	}
+
+	/// @brief Запись NDJSON для пути из одного имени
+	std::string JsonRecord(std::string_view name) {
+		std::string out;
+		AppendRecord(out, OutputFormat::Ndjson, NodeType::File, 1, 0, "", name);
+		return out;
+	}
+}
+
+TEST_CASE("NDJSON keeps valid UTF-8 and replaces invalid bytes", "[OutputFormat]") {
+	// Допустимые последовательности из двух, трех и четырех байтов остаются как есть
+	REQUIRE(JsonRecord("\xC3\xA9t\xC3\xA9") == "{\"path\":\"\xC3\xA9t\xC3\xA9\",\"type\":\"file\",\"size\":1,\"mtime\":null}\n");
+	REQUIRE(JsonRecord("\xE2\x82\xAC\xF0\x9F\x98\x80").find("\xE2\x82\xAC\xF0\x9F\x98\x80") != std::string::npos);
+
+	const std::pair<std::string_view, std::string_view> replaced[] = {
+		// Одиночный байт Latin-1 и байт продолжения без начала
+		{ "a\xFF" "b", "a\\ufffdb" },
+		{ "\x80", "\\ufffd" },
+		// Оборванная последовательность: заменяется начало, остаток разбирается заново
+		{ "\xE2\x82", "\\ufffd\\ufffd" },
+		{ "\xC3" "a", "\\ufffda" },
+		// Избыточная форма, суррогат и значение больше U+10FFFF
+		{ "\xC0\xAF", "\\ufffd\\ufffd" },
+		{ "\xE0\x80\xAF", "\\ufffd\\ufffd\\ufffd" },
+		{ "\xED\xA0\x80", "\\ufffd\\ufffd\\ufffd" },
+		{ "\xF4\x90\x80\x80", "\\ufffd\\ufffd\\ufffd\\ufffd" },
+		// Управляющие символы и кавычки по-прежнему экранируются
+		{ "\x01\"\\", "\\u0001\\\"\\\\" },
+	};
+	for (const auto& [name, escaped] : replaced) {
+		const std::string record = JsonRecord(name);
+		INFO(record);
+		REQUIRE(record == "{\"path\":\"" + std::string(escaped) + "\",\"type\":\"file\",\"size\":1,\"mtime\":null}\n");
+		REQUIRE(IsUtf8(record));
+	}
+
+	// Любые байты дают допустимый UTF-8; префикс директории экранируется так же
+	std::string all;
+	for (int c = 1; c < 256; ++c)
+		all += static_cast<char>(c);
+	std::string prefix;
+	AppendPathPrefix(prefix, OutputFormat::Ndjson, all);
+	std::string record;
+	AppendRecord(record, OutputFormat::Ndjson, NodeType::Directory, 0, 0, prefix, all);
+	REQUIRE(IsUtf8(record));
+}
+
+#ifdef __linux__
+namespace {
+	/// @brief Запись списка со всеми полями форматов
+	struct Record {
+		std::string type;
+		std::uint64_t size = 0;
+		std::int64_t mtime = 0;
+		std::string path;
+
+		bool operator<(const Record& other) const { return path < other.path; }
+		bool operator==(const Record& other) const {
+			return std::tie(path, type, size, mtime) == std::tie(other.path, other.type, other.size, other.mtime);
+		}
+	};
+
+	/// @brief Ожидаемый список: размеры файлов, 0 у директорий, mtime всех записей из lstat
+	std::vector<Record> Expected(const std::filesystem::path& root) {
+		std::vector<Record> records;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+			struct stat info {};
+			REQUIRE(::lstat(entry.path().c_str(), &info) == 0);
+			const bool directory = S_ISDIR(info.st_mode);
+			records.push_back({ directory ? "dir" : "file", directory ? 0 : static_cast<std::uint64_t>(info.st_size),
+				static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec, entry.path().string() });
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+
+	/// @brief Весь вывод обхода root в формате format
+	std::string Traverse(const std::filesystem::path& root, TraversalBackend backend, OutputFormat format) {
+		test_support::CaptureStdout capture;
+		{
+			OutputWriter output;
+			NodeTable nodes;
+			ThreadPool pool(2, std::chrono::milliseconds(0));
+			TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0), format };
+			TraverseDirectory(root, context, backend);
+		}
+		return capture.Text();
+	}
+
+	/// @brief Разбор строки JSON после открывающей кавычки до закрывающей (только экранирование AppendRecord)
+	std::string ParseJsonString(const std::string& line, std::size_t& at) {
+		std::string text;
+		while (line.at(at) != '"') {
+			if (line[at] != '\\') {
+				text += line[at++];
+				continue;
+			}
+			const char escape = line.at(at + 1);
+			at += 2;
+			if (escape == 'u') {
+				const unsigned code = static_cast<unsigned>(std::stoul(line.substr(at, 4), nullptr, 16));
+				at += 4;
+				text += code == 0xFFFD ? std::string("\xEF\xBF\xBD") : std::string(1, static_cast<char>(code));
+			}
+			else
+				text += escape == 'n' ? '\n' : escape == 't' ? '\t' : escape == 'r' ? '\r' : escape;
+		}
+		++at;
+		return text;
+	}
+
+	std::vector<Record> ParseNdjson(const std::string& text) {
+		std::vector<Record> records;
+		std::istringstream lines(text);
+		std::string line;
+		while (std::getline(lines, line)) {
+			REQUIRE(line.rfind("{\"path\":\"", 0) == 0);
+			Record record;
+			std::size_t at = std::strlen("{\"path\":\"");
+			record.path = ParseJsonString(line, at);
+			REQUIRE(line.compare(at, 9, ",\"type\":\"") == 0);
+			at += 9;
+			record.type = ParseJsonString(line, at);
+			REQUIRE(line.compare(at, 8, ",\"size\":") == 0);
+			at += 8;
+			std::size_t used = 0;
+			record.size = std::stoull(line.substr(at), &used);
+			at += used;
+			REQUIRE(line.compare(at, 9, ",\"mtime\":") == 0);
+			at += 9;
+			if (line.compare(at, 4, "null") != 0)
+				record.mtime = std::stoll(line.substr(at));
+			REQUIRE(line.back() == '}');
+			records.push_back(record);
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+
+	std::vector<Record> ParseTsv(const std::string& text) {
+		std::istringstream lines(text);
+		std::string line;
+		std::getline(lines, line);
+		REQUIRE(line == "type\tsize\tmtime\tpath");
+		std::vector<Record> records;
+		while (std::getline(lines, line)) {
+			std::istringstream fields(line);
+			Record record;
+			std::string size, mtime, path;
+			std::getline(fields, record.type, '\t');
+			std::getline(fields, size, '\t');
+			std::getline(fields, mtime, '\t');
+			std::getline(fields, path);
+			record.size = std::stoull(size);
+			record.mtime = mtime.empty() ? 0 : std::stoll(mtime);
+			for (std::size_t i = 0; i < path.size(); ++i) {
+				if (path[i] == '\\') {
+					const char escape = path[++i];
+					record.path += escape == 'n' ? '\n' : escape == 't' ? '\t' : escape == 'r' ? '\r' : escape;
+				}
+				else
+					record.path += path[i];
+			}
+			records.push_back(record);
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+
+	std::vector<Record> ParseBinary(const std::string& text) {
+		REQUIRE(text.size() >= sizeof(binary_output::StreamHeader));
+		binary_output::StreamHeader stream{};
+		std::memcpy(&stream, text.data(), sizeof(stream));
+		REQUIRE(std::memcmp(stream.magic, binary_output::Magic, sizeof(stream.magic)) == 0);
+		REQUIRE(stream.version == binary_output::Version);
+		REQUIRE(stream.byteOrder == binary_output::ByteOrderMark);
+		std::vector<Record> records;
+		for (std::size_t at = sizeof(stream); at < text.size();) {
+			binary_output::RecordHeader header{};
+			REQUIRE(text.size() - at >= sizeof(header));
+			std::memcpy(&header, text.data() + at, sizeof(header));
+			REQUIRE(header.length % binary_output::Alignment == 0);
+			REQUIRE(header.length >= sizeof(header) + header.pathLength);
+			REQUIRE(text.size() - at >= header.length);
+			records.push_back({ static_cast<NodeType>(header.type) == NodeType::Directory ? "dir" : "file", header.size, header.mtime,
+				text.substr(at + sizeof(header), header.pathLength) });
+			at += header.length;
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+
+	/// @brief Пути, не являющиеся UTF-8, в NDJSON выводятся с заменой байтов
+	std::vector<Record> AsJsonPaths(std::vector<Record> records) {
+		for (auto& record : records) {
+			std::string path;
+			AppendPathPrefix(path, OutputFormat::Ndjson, record.path);
+			path.pop_back();
+			std::size_t at = 0;
+			path += '"';
+			record.path = ParseJsonString(path, at);
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+}
+
+TEST_CASE("Machine-readable formats round-trip the same tree on every backend", "[OutputFormat]") {
+	const test_support::TemporaryTree tree("directory_travers_test_formats");
+	// Имена с табуляцией, переводом строки и байтом, не образующим UTF-8
+	std::ofstream(tree.Root() / "dir_0" / "tab\there") << "tab";
+	std::ofstream(tree.Root() / "dir_1" / "line\nbreak") << "newline";
+	std::ofstream(tree.Root() / "dir_2" / "latin\xE9.txt") << "latin-1";
+	const std::vector<Record> expected = Expected(tree.Root());
+	REQUIRE(expected.size() == 32);
+
+	for (TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring }) {
+		INFO("backend " << static_cast<int>(backend));
+		REQUIRE(ParseTsv(Traverse(tree.Root(), backend, OutputFormat::Tsv)) == expected);
+		REQUIRE(ParseBinary(Traverse(tree.Root(), backend, OutputFormat::Binary)) == expected);
+		const std::string ndjson = Traverse(tree.Root(), backend, OutputFormat::Ndjson);
+		REQUIRE(IsUtf8(ndjson));
+		REQUIRE(ndjson.find("latin\\ufffd.txt") != std::string::npos);
+		REQUIRE(ParseNdjson(ndjson) == AsJsonPaths(expected));
+	}
+}
+#endif
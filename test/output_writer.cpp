@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <MpscQueue.hpp>
+#include <OutputWriter.hpp>
+
+#include "traversal_support.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Узел очереди: номер производителя и порядковый номер у него
+	struct Message {
+		std::atomic<Message*> _next{ nullptr };
+		unsigned producer = 0;
+		std::size_t sequence = 0;
+	};
+
+	/// @brief Запись потока thread с номером sequence; длина меняется, чтобы записи пересекали границы блоков
+	std::string Record(unsigned thread, std::size_t sequence) {
+		return "thread " + std::to_string(thread) + " record " + std::to_string(sequence) + ' '
+			+ std::string(sequence % 97, 'x') + '\n';
+	}
+
+	/// @brief Проверка вывода: каждая запись ровно один раз, записи потока - в порядке записи
+	void CheckRecords(const std::string& text, unsigned threads, std::size_t records) {
+		std::vector<std::size_t> next(threads, 0);
+		std::istringstream lines(text);
+		std::string line;
+		std::size_t total = 0;
+		while (std::getline(lines, line)) {
+			std::istringstream fields(line);
+			std::string threadWord, recordWord;
+			unsigned thread = 0;
+			std::size_t sequence = 0;
+			fields >> threadWord >> thread >> recordWord >> sequence;
+			REQUIRE(thread < threads);
+			// Запись не разорвана и не перемешана с чужой
+			REQUIRE(line + '\n' == Record(thread, sequence));
+			REQUIRE(sequence == next[thread]);
+			++next[thread];
+			++total;
+		}
+		REQUIRE(total == threads * records);
+	}
+}
+
+TEST_CASE("MpscQueue keeps each producer's order and loses nothing", "[MpscQueue]") {
+	constexpr unsigned Producers = 4;
+	constexpr std::size_t PerProducer = 50000;
+	std::vector<std::vector<Message>> messages(Producers);
+	for (unsigned p = 0; p < Producers; ++p) {
+		messages[p] = std::vector<Message>(PerProducer);
+		for (std::size_t i = 0; i < PerProducer; ++i) {
+			messages[p][i].producer = p;
+			messages[p][i].sequence = i;
+		}
+	}
+
+	MpscQueue<Message> queue;
+	REQUIRE(queue.Pop() == nullptr);
+	std::vector<std::thread> producers;
+	for (unsigned p = 0; p < Producers; ++p) {
+		producers.emplace_back([&queue, &messages, p] {
+			for (auto& message : messages[p])
+				queue.Push(&message);
+		});
+	}
+
+	// Потребитель повторяет Pop, пока не получит все узлы (nullptr бывает и при непустой очереди)
+	std::vector<std::size_t> next(Producers, 0);
+	std::size_t received = 0;
+	bool ordered = true;
+	while (received < Producers * PerProducer) {
+		Message* message = queue.Pop();
+		if (message == nullptr) {
+			std::this_thread::yield();
+			continue;
+		}
+		ordered = ordered && message->sequence == next[message->producer];
+		++next[message->producer];
+		++received;
+	}
+	for (auto& producer : producers)
+		producer.join();
+
+	REQUIRE(ordered);
+	REQUIRE(queue.Pop() == nullptr);
+	for (unsigned p = 0; p < Producers; ++p)
+		REQUIRE(next[p] == PerProducer);
+}
+
+#ifdef __linux__
+TEST_CASE("OutputWriter writes every record whole and in per-thread order", "[OutputWriter]") {
+	constexpr unsigned Threads = 4;
+	constexpr std::size_t Records = 20000;
+	test_support::CaptureStdout capture;
+	{
+		// Маленький лимит: потоки ждут места в очереди
+		OutputWriter output(4 * OutputWriter::ChunkSize);
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < Threads; ++t) {
+			threads.emplace_back([&output, t] {
+				for (std::size_t i = 0; i < Records; ++i)
+					output.Write(Record(t, i));
+			});
+		}
+		for (auto& thread : threads)
+			thread.join();
+		output.Flush();
+	}
+	CheckRecords(capture.Text(), Threads, Records);
+}
+
+TEST_CASE("OutputWriter gives records larger than a chunk their own chunk", "[OutputWriter]") {
+	const std::string large(OutputWriter::ChunkSize * 3 + 5, 'L');
+	test_support::CaptureStdout capture;
+	{
+		OutputWriter output;
+		output.Write("before\n");
+		output.Write(large);
+		output.Write("\nafter\n");
+		// Деструктор записывает то, что не передано через Flush
+	}
+	REQUIRE(capture.Text() == "before\n" + large + "\nafter\n");
+}
+#endif
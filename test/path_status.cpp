@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+#include <args_parse/PathStatus.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <tuple>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	using args_parse::PathPolicy;
+
+	/// @brief Временная директория с файлом "file" и поддиректорией "dir", удаляемая вместе с объектом
+	class PathTree {
+	public:
+		explicit PathTree(const std::string& name) : _root(std::filesystem::temp_directory_path() / name) {
+			std::filesystem::remove_all(_root);
+			std::filesystem::create_directories(_root / "dir");
+			std::ofstream(_root / "file") << "x";
+		}
+		~PathTree() {
+			std::error_code error;
+			std::filesystem::permissions(_root / "locked", std::filesystem::perms::owner_all, error);
+			std::filesystem::remove_all(_root, error);
+		}
+
+		/// @brief Путь внутри директории
+		std::string operator/(const std::string& name) const { return (_root / name).string(); }
+
+	private:
+		std::filesystem::path _root;
+	};
+
+	/// @brief Проверка пути по политике с отдельным кэшем
+	bool Valid(const std::string& path, PathPolicy policy) {
+		args_parse::PathStatusCache cache;
+		return args_parse::ValidatePath(path, policy, cache);
+	}
+}
+
+TEST_CASE("PathPolicy::None accepts any non-empty string", "[PathStatus]") {
+	REQUIRE(Valid("no/such/path", PathPolicy::None));
+	REQUIRE_FALSE(Valid("", PathPolicy::None));
+}
+
+TEST_CASE("PathPolicy::MustExist and MustBeDirectory", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_exist");
+	REQUIRE(Valid(tree / "file", PathPolicy::MustExist));
+	REQUIRE(Valid(tree / "dir", PathPolicy::MustExist));
+	REQUIRE_FALSE(Valid(tree / "missing", PathPolicy::MustExist));
+
+	REQUIRE(Valid(tree / "dir", PathPolicy::MustBeDirectory));
+	REQUIRE_FALSE(Valid(tree / "file", PathPolicy::MustBeDirectory));
+	REQUIRE_FALSE(Valid(tree / "missing", PathPolicy::MustBeDirectory));
+}
+
+TEST_CASE("PathPolicy::Readable", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_read");
+	REQUIRE(Valid(tree / "file", PathPolicy::Readable));
+	REQUIRE(Valid(tree / "dir", args_parse::DefaultPathPolicy));
+	REQUIRE_FALSE(Valid(tree / "missing", PathPolicy::Readable));
+#ifndef _WIN32
+	// Для root права доступа не проверяются ядром
+	if (::geteuid() != 0) {
+		std::filesystem::create_directory(tree / "locked");
+		::chmod((tree / "locked").c_str(), 0);
+		REQUIRE_FALSE(Valid(tree / "locked", PathPolicy::Readable));
+	}
+#endif
+}
+
+TEST_CASE("PathPolicy::Writable checks the parent of a missing path", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_write");
+	REQUIRE(Valid(tree / "file", PathPolicy::Writable));
+	REQUIRE(Valid(tree / "missing", PathPolicy::Writable));
+	REQUIRE_FALSE(Valid(tree / "missing/child", PathPolicy::Writable));
+	// Существование требуется отдельно
+	REQUIRE_FALSE(Valid(tree / "missing", PathPolicy::Writable | PathPolicy::MustExist));
+}
+
+TEST_CASE("PathPolicy::CreateIfMissing creates a file or a directory", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_create");
+	REQUIRE(Valid(tree / "new_file", PathPolicy::CreateIfMissing | PathPolicy::MustExist));
+	REQUIRE(std::filesystem::is_regular_file(tree / "new_file"));
+
+	REQUIRE(Valid(tree / "a/b", PathPolicy::CreateIfMissing | PathPolicy::MustBeDirectory));
+	REQUIRE(std::filesystem::is_directory(tree / "a/b"));
+
+	// Существующий файл не превращается в директорию
+	REQUIRE_FALSE(Valid(tree / "file", PathPolicy::CreateIfMissing | PathPolicy::MustBeDirectory));
+}
+
+TEST_CASE("Repeated queries are answered from the cache", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_cache");
+	args_parse::PathStatusCache cache;
+
+	REQUIRE(args_parse::ValidatePath(tree / "dir", args_parse::DefaultPathPolicy, cache));
+	// stat и access на чтение
+	REQUIRE(cache.SystemCalls() == 2);
+	REQUIRE(args_parse::ValidatePath(tree / "dir", args_parse::DefaultPathPolicy, cache));
+	REQUIRE(cache.SystemCalls() == 2);
+	// Тот же файл, записанный иначе: stat нужен, права берутся из записи файла
+	REQUIRE(args_parse::ValidatePath(tree / "dir/../dir", args_parse::DefaultPathPolicy, cache));
+#ifndef _WIN32
+	REQUIRE(cache.SystemCalls() == 3);
+#endif
+
+	// Новый вид доступа проверяется одним вызовом
+	const std::size_t before = cache.SystemCalls();
+	REQUIRE(args_parse::ValidatePath(tree / "dir", PathPolicy::Writable, cache));
+	REQUIRE(cache.SystemCalls() == before + 1);
+}
+
+#ifndef _WIN32
+TEST_CASE("Paths are checked as given, after symbolic links", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_link");
+	std::filesystem::create_directories(tree / "deep/inner");
+	std::ofstream(tree / "deep/only_here") << "x";
+	std::filesystem::create_directory_symlink(tree / "deep/inner", tree / "jump");
+
+	// Ядро поднимается из цели ссылки (deep), а не из директории, где лежит ссылка
+	args_parse::PathStatusCache cache;
+	REQUIRE(args_parse::ValidatePath(tree / "jump/../only_here", PathPolicy::MustExist, cache));
+	REQUIRE_FALSE(args_parse::ValidatePath(tree / "only_here", PathPolicy::MustExist, cache));
+	REQUIRE(args_parse::ValidatePath(tree / "jump/..", PathPolicy::MustBeDirectory, cache));
+}
+#endif
+
+TEST_CASE("Invalidate and Clear drop stale answers", "[PathStatus]") {
+	PathTree tree("args_parse_test_path_stale");
+	args_parse::PathStatusCache cache;
+
+	REQUIRE_FALSE(args_parse::ValidatePath(tree / "later", PathPolicy::MustExist, cache));
+	std::ofstream(tree / "later") << "x";
+	// Без сброса кэш отвечает состоянием на момент первого запроса
+	REQUIRE_FALSE(args_parse::ValidatePath(tree / "later", PathPolicy::MustExist, cache));
+	cache.Invalidate(tree / "later");
+	REQUIRE(args_parse::ValidatePath(tree / "later", PathPolicy::MustExist, cache));
+
+	std::filesystem::remove(tree / "later");
+	REQUIRE(args_parse::ValidatePath(tree / "later", PathPolicy::MustExist, cache));
+	cache.Clear();
+	REQUIRE_FALSE(args_parse::ValidatePath(tree / "later", PathPolicy::MustExist, cache));
+}
+
+TEST_CASE("Each parser owns its path cache and clears it on Parse", "[PathStatus][ArgsParser]") {
+	PathTree tree("args_parse_test_path_parse");
+	const std::string token = "--output=" + (tree / "created_between_parses");
+	const char* argv[] = { "program", token.c_str() };
+	args_parse::ArgsParser parser(2, argv);
+	args_parse::Validator<std::string> existingFile(PathPolicy::MustExist);
+	args_parse::Argument<std::string> output('o', "output", true, &existingFile);
+	parser.Add(&output);
+
+	args_parse::ArgsParser other(2, argv);
+	args_parse::Argument<std::string> otherOutput('o', "output", true, &existingFile);
+	other.Add(&otherOutput);
+
+	REQUIRE_FALSE(parser.Parse().Ok());
+	std::ofstream(tree / "created_between_parses") << "x";
+	// Другой парсер не видит ответов первого
+	REQUIRE(other.Parse().Ok());
+	REQUIRE(parser.Parse().Ok());
+	REQUIRE(output.GetValue() == tree / "created_between_parses");
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+#include <args_parse/ResponseFile.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+	/// @brief Аргументы из текста файла ответов
+	std::vector<std::string> Tokenize(std::string text) {
+		std::vector<std::string> tokens;
+		args_parse::TokenizeResponseBuffer(text.data(), text.size(), [&tokens](std::string_view token) {
+			tokens.emplace_back(token);
+		});
+		return tokens;
+	}
+
+	/// @brief Временная директория для файлов ответов, удаляемая вместе с объектом
+	class ResponseDirectory {
+	public:
+		explicit ResponseDirectory(const std::string& name) : _root(std::filesystem::temp_directory_path() / name) {
+			std::filesystem::remove_all(_root);
+			std::filesystem::create_directories(_root);
+		}
+		~ResponseDirectory() {
+			std::error_code error;
+			std::filesystem::remove_all(_root, error);
+		}
+
+		/// @brief Запись файла; возвращает аргумент "@path"
+		std::string Write(const std::string& name, const std::string& text) const {
+			std::ofstream(_root / name, std::ios::binary) << text;
+			return "@" + (_root / name).string();
+		}
+
+	private:
+		std::filesystem::path _root;
+	};
+}
+
+TEST_CASE("Response file tokens are split on whitespace", "[ResponseFile]") {
+	REQUIRE(Tokenize("") == std::vector<std::string>{});
+	REQUIRE(Tokenize("  \t\n ") == std::vector<std::string>{});
+	REQUIRE(Tokenize("-v --thread-pool=4\r\n\t-d 1s") == std::vector<std::string>{ "-v", "--thread-pool=4", "-d", "1s" });
+}
+
+TEST_CASE("Response file quotes and backslash escapes", "[ResponseFile]") {
+	// Кавычки снимаются, внутри них пробелы сохраняются
+	REQUIRE(Tokenize("--path=\"my dir/file\"") == std::vector<std::string>{ "--path=my dir/file" });
+	REQUIRE(Tokenize("'a b' \"c d\"") == std::vector<std::string>{ "a b", "c d" });
+	// Другая кавычка внутри кавычек - обычный символ
+	REQUIRE(Tokenize("\"it's\" 'say \"hi\"'") == std::vector<std::string>{ "it's", "say \"hi\"" });
+	// Обратная косая черта экранирует вне кавычек и в двойных, но не в одинарных кавычках
+	REQUIRE(Tokenize("a\\ b") == std::vector<std::string>{ "a b" });
+	REQUIRE(Tokenize("\"a\\\"b\"") == std::vector<std::string>{ "a\"b" });
+	REQUIRE(Tokenize("'a\\b'") == std::vector<std::string>{ "a\\b" });
+	// Завершающая обратная косая черта остается
+	REQUIRE(Tokenize("end\\") == std::vector<std::string>{ "end\\" });
+	// Пустые кавычки - пустой аргумент
+	REQUIRE(Tokenize("'' x") == std::vector<std::string>{ "", "x" });
+}
+
+TEST_CASE("Response file comments run to the end of the line", "[ResponseFile]") {
+	REQUIRE(Tokenize("# comment -v\n-t4 # trailing\n#last") == std::vector<std::string>{ "-t4" });
+	// '#' не в начале аргумента и в кавычках - обычный символ
+	REQUIRE(Tokenize("--name=a#b '#quoted'") == std::vector<std::string>{ "--name=a#b", "#quoted" });
+}
+
+TEST_CASE("Response files expand in place and may nest", "[ResponseFile][ArgsParser]") {
+	ResponseDirectory directory("args_parse_test_response_nest");
+	const std::string inner = directory.Write("inner.rsp", "--number=7 # inner\n");
+	const std::string outer = directory.Write("outer.rsp", "-v\n" + inner + "\n");
+
+	const char* argv[] = { "program", outer.c_str(), "--ratio=2" };
+	args_parse::ArgsParser parser(3, argv);
+	args_parse::Validator<int> intValidator;
+	args_parse::Argument<bool> verbose('v', "verbose", false);
+	args_parse::Argument<int> number('n', "number", true, &intValidator);
+	args_parse::Argument<int> ratio('r', "ratio", true, &intValidator);
+	parser.Add(&verbose);
+	parser.Add(&number);
+	parser.Add(&ratio);
+
+	const args_parse::ParseResult result = parser.Parse();
+	REQUIRE(result.Ok());
+	REQUIRE(verbose.GetIsDefined());
+	REQUIRE(number.GetValue() == 7);
+	REQUIRE(ratio.GetValue() == 2);
+	// Отображения принадлежат результату разбора
+	REQUIRE(result.responseFiles.size() == 2);
+
+	// Повторный разбор отображает файлы заново, прежний результат их не теряет
+	const args_parse::ParseResult second = parser.Parse();
+	REQUIRE(second.Ok());
+	REQUIRE(second.responseFiles.size() == 2);
+	REQUIRE(result.responseFiles.size() == 2);
+}
+
+TEST_CASE("Response file cycles and nesting depth are diagnostics", "[ResponseFile][ArgsParser]") {
+	ResponseDirectory directory("args_parse_test_response_cycle");
+	args_parse::Argument<bool> verbose('v', "verbose", false);
+
+	SECTION("File includes itself") {
+		const std::string self = directory.Write("self.rsp", "-v @" + (std::filesystem::temp_directory_path() / "args_parse_test_response_cycle" / "self.rsp").string());
+		const char* argv[] = { "program", self.c_str() };
+		args_parse::ArgsParser parser(2, argv);
+		parser.Add(&verbose);
+		const args_parse::ParseResult result = parser.Parse();
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].kind == args_parse::DiagnosticKind::ResponseFileCycle);
+		REQUIRE(result.diagnostics[0].tokenIndex == 1);
+		// Аргументы до цикла разобраны
+		REQUIRE(verbose.GetIsDefined());
+	}
+
+	SECTION("Two files include each other") {
+		const std::string second = directory.Write("b.rsp", "");
+		const std::string first = directory.Write("a.rsp", second);
+		directory.Write("b.rsp", first);
+		const char* argv[] = { "program", first.c_str() };
+		args_parse::ArgsParser parser(2, argv);
+		parser.Add(&verbose);
+		const args_parse::ParseResult result = parser.Parse();
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].kind == args_parse::DiagnosticKind::ResponseFileCycle);
+		REQUIRE(result.diagnostics[0].token == first);
+	}
+
+	SECTION("Chain longer than the nesting limit") {
+		// 40 разных файлов: каждый ссылается на следующий
+		std::string next = directory.Write("chain_40.rsp", "-v");
+		for (int k = 39; k >= 0; --k)
+			next = directory.Write("chain_" + std::to_string(k) + ".rsp", next);
+		const char* argv[] = { "program", next.c_str() };
+		args_parse::ArgsParser parser(2, argv);
+		parser.Add(&verbose);
+		const args_parse::ParseResult result = parser.Parse();
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].kind == args_parse::DiagnosticKind::ResponseFileTooDeep);
+		REQUIRE_FALSE(verbose.GetIsDefined());
+	}
+
+	SECTION("Missing file") {
+		const std::string missing = "@" + (std::filesystem::temp_directory_path() / "args_parse_test_response_cycle" / "missing.rsp").string();
+		const char* argv[] = { "program", missing.c_str(), "-v" };
+		args_parse::ArgsParser parser(3, argv);
+		parser.Add(&verbose);
+		const args_parse::ParseResult result = parser.Parse();
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].kind == args_parse::DiagnosticKind::ResponseFileUnreadable);
+		REQUIRE(result.diagnostics[0].name == missing.substr(1));
+		// Остальные аргументы разбираются дальше
+		REQUIRE(verbose.GetIsDefined());
+	}
+}
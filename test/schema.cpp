@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/Schema.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	constexpr char HelpName[] = "help";
+	constexpr char ThreadPoolName[] = "thread-pool";
+	constexpr char DebugSleepName[] = "debug-sleep";
+	constexpr char RetriesName[] = "retries";
+
+	using HelpOpt = args_parse::Opt<'h', HelpName, bool>;
+	using ThreadPoolOpt = args_parse::Opt<'t', ThreadPoolName, unsigned int>;
+	using DebugSleepOpt = args_parse::Opt<'d', DebugSleepName, std::chrono::milliseconds>;
+	using RetriesOpt = args_parse::Opt<args_parse::NoShortName, RetriesName, unsigned int>;
+	using TestSchema = args_parse::Schema<HelpOpt, ThreadPoolOpt, DebugSleepOpt, RetriesOpt>;
+
+	static_assert(TestSchema::FindShort('t') == 1);
+	static_assert(TestSchema::FindLong("thread") == 1);
+	static_assert(TestSchema::FindLong("re") == 3);
+	static_assert(TestSchema::FindLong("x") == TestSchema::NotFound);
+
+	// Имя может быть префиксом другого имени
+	constexpr char StatsName[] = "stats";
+	constexpr char StatsJsonName[] = "stats-json";
+	using StatsOpt = args_parse::Opt<args_parse::NoShortName, StatsName, bool>;
+	using StatsJsonOpt = args_parse::Opt<args_parse::NoShortName, StatsJsonName, std::string>;
+	using PrefixSchema = args_parse::Schema<StatsJsonOpt, StatsOpt, HelpOpt>;
+
+	static_assert(PrefixSchema::FindLong("stats") == 1);
+	static_assert(PrefixSchema::FindLong("stats-json") == 0);
+	static_assert(PrefixSchema::FindLong("stats-") == 0);
+	static_assert(PrefixSchema::FindLong("sta") == PrefixSchema::Ambiguous);
+
+	// Строка, проверяемая как существующая директория
+	constexpr char SourceName[] = "source";
+	using SourceOpt = args_parse::Opt<'s', SourceName, std::string, args_parse::DefaultPathPolicy>;
+	using PathSchema = args_parse::Schema<SourceOpt>;
+}
+
+TEST_CASE("Compile-time schema parses values", "[Schema]") {
+	const char* argv[] = { "program", "-h", "--thread=4", "-d1.5s", "--retries=2" };
+	const auto result = TestSchema::Parse(5, argv);
+
+	REQUIRE(result.Get<HelpOpt>() == true);
+	REQUIRE(result.Get<ThreadPoolOpt>() == 4u);
+	REQUIRE(result.Get<DebugSleepOpt>() == std::chrono::milliseconds(1500));
+	REQUIRE(result.Get<RetriesOpt>() == 2u);
+}
+
+TEST_CASE("Compile-time schema rejects bad input", "[Schema]") {
+	const char* unknown[] = { "program", "--verbose" };
+	REQUIRE_THROWS_AS(TestSchema::Parse(2, unknown), std::invalid_argument);
+
+	const char* invalid[] = { "program", "-t=abc" };
+	REQUIRE_THROWS_AS(TestSchema::Parse(2, invalid), std::invalid_argument);
+
+	const char* missing[] = { "program", "--retries" };
+	REQUIRE_THROWS_AS(TestSchema::Parse(2, missing), std::invalid_argument);
+}
+
+TEST_CASE("Compile-time schema prefers exact names over longer names", "[Schema]") {
+	const char* argv[] = { "program", "--stats" };
+	const auto result = PrefixSchema::Parse(2, argv);
+	REQUIRE(result.Get<StatsOpt>() == true);
+	REQUIRE_FALSE(result.Get<StatsJsonOpt>().has_value());
+
+	const char* ambiguous[] = { "program", "--sta" };
+	REQUIRE_THROWS_AS(PrefixSchema::Parse(2, ambiguous), std::invalid_argument);
+}
+TEST_CASE("Compile-time schema checks paths only when asked", "[Schema]") {
+	// Строка без политики - любое непустое значение, даже не существующий путь
+	const char* plain[] = { "program", "--stats-json=no/such/dir/out.json" };
+	REQUIRE(PrefixSchema::Parse(2, plain).Get<StatsJsonOpt>() == std::string("no/such/dir/out.json"));
+
+	const char* missing[] = { "program", "--source=no/such/dir" };
+	REQUIRE_THROWS_AS(PathSchema::Parse(2, missing), std::invalid_argument);
+	const char* current[] = { "program", "-s=." };
+	REQUIRE(PathSchema::Parse(2, current).Get<SourceOpt>() == std::string("."));
+}
@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Hash.hpp>
+#include <Snapshot.hpp>
+#include <Traversal.hpp>
+
+#include "traversal_support.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+namespace {
+	/// @brief Обход tree с записью снимка в file; previous - снимок прошлого обхода (nullptr - без него).
+	/// Возвращает сколько директорий взято из previous
+	std::uint64_t TraverseWithSnapshot(const std::filesystem::path& tree, const std::filesystem::path& file,
+		const SnapshotReader* previous = nullptr) {
+		test_support::CaptureStdout capture;
+		SnapshotWriter snapshot(SnapshotFlags(TraversalBackend::Getdents));
+		OutputWriter output;
+		NodeTable nodes;
+		ThreadPool pool(2, std::chrono::milliseconds(0));
+		TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+		context._previous = previous;
+		context._snapshot = &snapshot;
+		TraverseDirectory(tree, context, TraversalBackend::Getdents);
+		std::string error;
+		REQUIRE(snapshot.Save(file, nodes, error));
+		REQUIRE(error.empty());
+		return snapshot.Reused();
+	}
+
+	std::string ReadBytes(const std::filesystem::path& file) {
+		std::ifstream input(file, std::ios::binary);
+		return { std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+	}
+
+	void WriteBytes(const std::filesystem::path& file, const std::string& bytes) {
+		std::ofstream(file, std::ios::binary | std::ios::trunc) << bytes;
+	}
+
+	/// @brief Пересчет обеих контрольных сумм после правки bytes (как в SnapshotWriter::Save)
+	void Reseal(std::string& bytes) {
+		snapshot::Header header{};
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		const std::size_t directoryBytes = header.directoryCount * sizeof(snapshot::Directory);
+		const std::size_t entryBytes = header.entryCount * sizeof(snapshot::Entry);
+		const char* directories = bytes.data() + sizeof(header);
+		std::uint64_t checksum = Hash64(directories, directoryBytes);
+		checksum = Hash64(directories + directoryBytes, entryBytes, checksum);
+		header.bodyChecksum = Hash64(directories + directoryBytes + entryBytes, header.nameBytes, checksum);
+		header.headerChecksum = Hash64(&header, offsetof(snapshot::Header, headerChecksum));
+		std::memcpy(bytes.data(), &header, sizeof(header));
+	}
+
+	/// @brief Файл снимка во временной директории, удаляемый вместе с объектом
+	struct SnapshotFile {
+		std::filesystem::path path = std::filesystem::temp_directory_path() / "directory_travers_test.snapshot";
+		std::filesystem::path damaged = std::filesystem::temp_directory_path() / "directory_travers_test_damaged.snapshot";
+		~SnapshotFile() {
+			std::error_code error;
+			std::filesystem::remove(path, error);
+			std::filesystem::remove(damaged, error);
+		}
+	};
+}
+
+TEST_CASE("A saved snapshot validates and lets an unchanged tree be reused", "[Snapshot]") {
+	const test_support::TemporaryTree tree("directory_travers_test_snapshot");
+	const SnapshotFile file;
+	REQUIRE(TraverseWithSnapshot(tree.Root(), file.path) == 0);
+
+	const SnapshotReader reader(file.path);
+	REQUIRE(reader.Valid());
+	REQUIRE(reader.Error().empty());
+	// Корень, dir_0..2, их nested и deeper, empty
+	REQUIRE(reader.Directories() == 11);
+	REQUIRE(reader.Flags() == SnapshotFlags(TraversalBackend::Getdents));
+
+	// Список корня берется из снимка; поддиректории тоже не изменились
+	REQUIRE(TraverseWithSnapshot(tree.Root(), file.damaged, &reader) == 11);
+}
+
+TEST_CASE("Truncated snapshots are rejected", "[Snapshot]") {
+	const test_support::TemporaryTree tree("directory_travers_test_snapshot_truncated");
+	const SnapshotFile file;
+	TraverseWithSnapshot(tree.Root(), file.path);
+	const std::string bytes = ReadBytes(file.path);
+	REQUIRE(bytes.size() > sizeof(snapshot::Header));
+
+	for (std::size_t length : { std::size_t{ 0 }, std::size_t{ 7 }, sizeof(snapshot::Header) - 1, sizeof(snapshot::Header),
+		sizeof(snapshot::Header) + 1, bytes.size() / 2, bytes.size() - 1 }) {
+		WriteBytes(file.damaged, bytes.substr(0, length));
+		const SnapshotReader reader(file.damaged);
+		INFO("length " << length << ": " << reader.Error());
+		REQUIRE_FALSE(reader.Valid());
+	}
+	// Лишние байты в конце - тоже несовпадение размера
+	WriteBytes(file.damaged, bytes + '\0');
+	REQUIRE_FALSE(SnapshotReader(file.damaged).Valid());
+}
+
+TEST_CASE("A flipped bit anywhere in a snapshot is detected", "[Snapshot]") {
+	const test_support::TemporaryTree tree("directory_travers_test_snapshot_flipped");
+	const SnapshotFile file;
+	TraverseWithSnapshot(tree.Root(), file.path);
+	const std::string bytes = ReadBytes(file.path);
+
+	std::size_t accepted = 0;
+	for (std::size_t offset = 0; offset < bytes.size(); ++offset) {
+		std::string damaged = bytes;
+		damaged[offset] = static_cast<char>(damaged[offset] ^ (1 << (offset % 8)));
+		WriteBytes(file.damaged, damaged);
+		accepted += SnapshotReader(file.damaged).Valid();
+	}
+	REQUIRE(accepted == 0);
+}
+
+TEST_CASE("Snapshots of another version or format are rejected", "[Snapshot]") {
+	const test_support::TemporaryTree tree("directory_travers_test_snapshot_version");
+	const SnapshotFile file;
+	TraverseWithSnapshot(tree.Root(), file.path);
+	const std::string bytes = ReadBytes(file.path);
+
+	std::string newer = bytes;
+	const std::uint32_t version = snapshot::Version + 1;
+	std::memcpy(&newer[offsetof(snapshot::Header, version)], &version, sizeof(version));
+	WriteBytes(file.damaged, newer);
+	const SnapshotReader newerReader(file.damaged);
+	REQUIRE_FALSE(newerReader.Valid());
+	REQUIRE(newerReader.Error() == "unsupported snapshot version " + std::to_string(version));
+
+	std::string foreign = bytes;
+	foreign[0] = 'X';
+	WriteBytes(file.damaged, foreign);
+	const SnapshotReader foreignReader(file.damaged);
+	REQUIRE_FALSE(foreignReader.Valid());
+	REQUIRE(foreignReader.Error() == "not a snapshot file");
+
+	const SnapshotReader missing(file.damaged.string() + ".missing");
+	REQUIRE_FALSE(missing.Valid());
+	REQUIRE(missing.Error().find("cannot open") == 0);
+}
+
+TEST_CASE("Entry names that are not a single path component are rejected", "[Snapshot]") {
+	const test_support::TemporaryTree tree("directory_travers_test_snapshot_names");
+	// Длинные имена: разделу имен хватает байтов на имя длиннее NAME_MAX
+	std::ofstream(tree.Root() / std::string(200, 'a')) << "a";
+	std::ofstream(tree.Root() / std::string(200, 'b')) << "b";
+	const SnapshotFile file;
+	TraverseWithSnapshot(tree.Root(), file.path);
+	const std::string bytes = ReadBytes(file.path);
+	snapshot::Header header{};
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	REQUIRE(header.nameBytes > 300);
+	const std::size_t entryAt = sizeof(header) + header.directoryCount * sizeof(snapshot::Directory);
+	const std::size_t namesAt = entryAt + header.entryCount * sizeof(snapshot::Entry);
+
+	// Первая запись получает имя name; контрольные суммы пересчитываются, так что отвергает только проверка имен
+	const auto withName = [&](std::uint16_t length, const std::function<void(char*)>& fill) {
+		std::string damaged = bytes;
+		snapshot::Entry entry{};
+		std::memcpy(&entry, &damaged[entryAt], sizeof(entry));
+		entry.nameOffset = 0;
+		entry.nameLength = length;
+		std::memcpy(&damaged[entryAt], &entry, sizeof(entry));
+		fill(&damaged[namesAt]);
+		Reseal(damaged);
+		WriteBytes(file.damaged, damaged);
+		return SnapshotReader(file.damaged);
+	};
+
+	// Контроль: допустимое имя после пересчета сумм принимается
+	REQUIRE(withName(3, [](char* name) { std::memcpy(name, "abc", 3); }).Valid());
+
+	const std::pair<std::uint16_t, std::function<void(char*)>> invalid[] = {
+		{ std::uint16_t{ 300 }, [](char* name) { std::memset(name, 'x', 300); } },
+		{ std::uint16_t{ 0 }, [](char*) {} },
+		{ std::uint16_t{ 1 }, [](char* name) { name[0] = '.'; } },
+		{ std::uint16_t{ 2 }, [](char* name) { std::memcpy(name, "..", 2); } },
+		{ std::uint16_t{ 3 }, [](char* name) { std::memcpy(name, "a/b", 3); } },
+		{ std::uint16_t{ 3 }, [](char* name) { std::memcpy(name, "a\0b", 3); } },
+	};
+	for (const auto& [length, fill] : invalid) {
+		const SnapshotReader reader = withName(length, fill);
+		INFO("length " << length);
+		REQUIRE_FALSE(reader.Valid());
+		REQUIRE(reader.Error() == "snapshot entry has an invalid name");
+	}
+}
+#endif
@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Stats.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+	/// @brief Номер корзины, в которую Stats::Record положил единственную длительность nanoseconds
+	std::size_t RecordedBucket(std::uint64_t nanoseconds) {
+		Stats stats;
+		stats.Record(StatTimer::TaskRun, nanoseconds);
+		const StatTimerTotals& totals = stats.Collect().Get(StatTimer::TaskRun);
+		REQUIRE(totals.count == 1);
+		REQUIRE(totals.maxNs == nanoseconds);
+		const auto it = std::find(totals.buckets.begin(), totals.buckets.end(), 1u);
+		REQUIRE(it != totals.buckets.end());
+		return static_cast<std::size_t>(it - totals.buckets.begin());
+	}
+}
+
+TEST_CASE("Durations fall into power-of-two buckets", "[Stats]") {
+	REQUIRE(RecordedBucket(0) == 0);
+	REQUIRE(RecordedBucket(1) == 1);
+	// Корзина b: от 2^(b-1) до 2^b - 1
+	for (std::size_t k = 1; k < StatTimerTotals::Buckets - 1; ++k) {
+		INFO("k " << k);
+		REQUIRE(RecordedBucket((std::uint64_t{ 1 } << k) - 1) == k);
+		REQUIRE(RecordedBucket(std::uint64_t{ 1 } << k) == k + 1);
+	}
+	// Длительности от 2^62 собираются в последней корзине
+	REQUIRE(RecordedBucket(std::uint64_t{ 1 } << 63) == StatTimerTotals::Buckets - 1);
+	REQUIRE(RecordedBucket(~std::uint64_t{ 0 }) == StatTimerTotals::Buckets - 1);
+}
+
+TEST_CASE("Percentile bounds the exact value from above and never exceeds the maximum", "[Stats]") {
+	REQUIRE(StatTimerTotals{}.Percentile(0.5) == 0);
+
+	const std::vector<std::vector<std::uint64_t>> samples = {
+		{ 5 },
+		{ 0, 0, 0 },
+		{ 1000, 1000, 1000, 3000 },
+		{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1000000 },
+		{ 4096, 4095, 8191, 8192, std::uint64_t{ 1 } << 40 },
+		{ std::uint64_t{ 1 } << 63, ~std::uint64_t{ 0 } },
+	};
+	for (const auto& sample : samples) {
+		Stats stats;
+		for (const std::uint64_t value : sample)
+			stats.Record(StatTimer::TaskRun, value);
+		const StatTimerTotals& totals = stats.Collect().Get(StatTimer::TaskRun);
+		std::vector<std::uint64_t> sorted = sample;
+		std::sort(sorted.begin(), sorted.end());
+		REQUIRE(totals.maxNs == sorted.back());
+
+		std::uint64_t previous = 0;
+		for (const double fraction : { 0.01, 0.5, 0.9, 0.99, 1.0 }) {
+			const std::uint64_t estimate = totals.Percentile(fraction);
+			const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+			INFO("fraction " << fraction << " of " << sorted.size() << " values");
+			REQUIRE(estimate <= totals.maxNs);
+			REQUIRE(estimate >= std::min(sorted[std::max<std::size_t>(rank, 1) - 1], totals.maxNs));
+			REQUIRE(estimate >= previous);
+			previous = estimate;
+		}
+		REQUIRE(totals.Percentile(1.0) == totals.maxNs);
+	}
+}
+
+TEST_CASE("A thread switching between Stats keeps one slot in each", "[Stats]") {
+	Stats first;
+	Stats second;
+	for (int i = 0; i < 1000; ++i) {
+		first.Add(StatCounter::TasksRun);
+		second.Add(StatCounter::TasksRun, 2);
+	}
+	const StatsReport firstReport = first.Collect();
+	const StatsReport secondReport = second.Collect();
+	REQUIRE(firstReport.threads.size() == 1);
+	REQUIRE(secondReport.threads.size() == 1);
+	REQUIRE(firstReport.Get(StatCounter::TasksRun) == 1000);
+	REQUIRE(secondReport.Get(StatCounter::TasksRun) == 2000);
+}
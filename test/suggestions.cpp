@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <args_parse/argument.hpp>
+#include <args_parse/ArgsParser.hpp>
+#include <args_parse/EditDistance.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	/// @brief Расстояние Левенштейна полной матрицей динамического программирования
+	std::size_t NaiveDistance(std::string_view lhs, std::string_view rhs) {
+		std::vector<std::vector<std::size_t>> table(lhs.size() + 1, std::vector<std::size_t>(rhs.size() + 1));
+		for (std::size_t i = 0; i <= lhs.size(); ++i)
+			table[i][0] = i;
+		for (std::size_t j = 0; j <= rhs.size(); ++j)
+			table[0][j] = j;
+		for (std::size_t i = 1; i <= lhs.size(); ++i)
+			for (std::size_t j = 1; j <= rhs.size(); ++j)
+				table[i][j] = std::min({ table[i - 1][j] + 1, table[i][j - 1] + 1,
+					table[i - 1][j - 1] + (lhs[i - 1] == rhs[j - 1] ? 0 : 1) });
+		return table[lhs.size()][rhs.size()];
+	}
+
+	/// @brief Случайная строка из небольшого алфавита (чтобы совпадения были частыми)
+	std::string RandomString(std::mt19937& random, std::size_t length) {
+		std::uniform_int_distribution<int> letter('a', 'd');
+		std::string text(length, ' ');
+		for (auto& symbol : text)
+			symbol = static_cast<char>(letter(random));
+		return text;
+	}
+
+	/// @brief Набор аргументов для проверки подсказок
+	struct SuggestCli {
+		args_parse::Validator<int> intValidator;
+		args_parse::Argument<bool> verbose{ 'v', "verbose", false };
+		args_parse::Argument<bool> version{ 'V', "version", false };
+		args_parse::Argument<int> threads{ 't', "threads", true, &intValidator };
+		args_parse::Argument<bool> trace{ "trace", false };
+		args_parse::Argument<bool> stats{ "stats", false };
+
+		SuggestCli() { Register(_parser); }
+
+		/// @brief Подсказки в виде "--name" / "-x"
+		std::vector<std::string> Suggest(std::string_view name) const {
+			std::vector<std::string> rendered;
+			for (const auto& suggestion : _parser.Suggest(name))
+				rendered.push_back((suggestion.isShort ? "-" : "--") + std::string(suggestion.name));
+			return rendered;
+		}
+
+		/// @brief Единственная ошибка разбора одного аргумента
+		args_parse::Diagnostic Unknown(const char* token) {
+			const char* argv[] = { "program", token };
+			args_parse::ArgsParser parser(2, argv);
+			Register(parser);
+			const args_parse::ParseResult result = parser.Parse();
+			REQUIRE(result.diagnostics.size() == 1);
+			REQUIRE(result.diagnostics[0].kind == args_parse::DiagnosticKind::UnknownArgument);
+			std::ostringstream text;
+			result.Render(text);
+			_rendered = text.str();
+			return result.diagnostics[0];
+		}
+
+		/// @brief Текст последней ошибки
+		const std::string& Rendered() const { return _rendered; }
+
+	private:
+		void Register(args_parse::ArgsParser& parser) {
+			parser.Add(&verbose);
+			parser.Add(&version);
+			parser.Add(&threads);
+			parser.Add(&trace);
+			parser.Add(&stats);
+		}
+
+		const char* _argv[1] = { "program" };
+		args_parse::ArgsParser _parser{ 1, _argv };
+		std::string _rendered;
+	};
+}
+
+TEST_CASE("Myers distance matches the dynamic programming table", "[EditDistance]") {
+	std::mt19937 random(20240521);
+	std::uniform_int_distribution<std::size_t> length(0, 80);
+	for (int round = 0; round < 2000; ++round) {
+		// Длины больше 64 проверяют и запасной алгоритм без битовых масок
+		const std::string pattern = RandomString(random, length(random));
+		const std::string text = RandomString(random, length(random));
+		const args_parse::EditDistancePattern compiled(pattern);
+		const std::size_t expected = NaiveDistance(pattern, text);
+		for (std::size_t maxDistance : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 3 }, std::size_t{ 10 }, std::size_t{ 200 } }) {
+			INFO("pattern=" << pattern << " text=" << text << " maxDistance=" << maxDistance);
+			REQUIRE(compiled.Distance(text, maxDistance) == std::min(expected, maxDistance + 1));
+		}
+	}
+}
+
+TEST_CASE("Myers distance on edge cases", "[EditDistance]") {
+	REQUIRE(args_parse::EditDistancePattern("").Distance("", 3) == 0);
+	REQUIRE(args_parse::EditDistancePattern("").Distance("abc", 3) == 3);
+	REQUIRE(args_parse::EditDistancePattern("kitten").Distance("sitting", 5) == 3);
+	REQUIRE(args_parse::EditDistancePattern("flaw").Distance("lawn", 5) == 2);
+	const std::string wide(64, 'a');
+	REQUIRE(args_parse::EditDistancePattern(wide).Distance(wide + "b", 3) == 1);
+	REQUIRE(args_parse::EditDistancePattern(wide + "b").Distance(wide, 3) == 1);
+}
+
+TEST_CASE("Suggestions are ranked by distance, then by name", "[ArgsParser][suggest]") {
+	const SuggestCli cli;
+	REQUIRE(cli.Suggest("verbos") == std::vector<std::string>{ "--verbose", "--version" });
+	REQUIRE(cli.Suggest("versoin") == std::vector<std::string>{ "--version", "--verbose" });
+	// Одинаковое расстояние - по алфавиту
+	REQUIRE(cli.Suggest("trads") == std::vector<std::string>{ "--threads", "--trace", "--stats" });
+	REQUIRE(cli.Suggest("zzzzzzzz").empty());
+}
+
+TEST_CASE("Single letters are compared with short names", "[ArgsParser][suggest]") {
+	const SuggestCli cli;
+	REQUIRE(cli.Suggest("T") == std::vector<std::string>{ "-t" });
+	// Обе буквы зарегистрированы: точное совпадение раньше
+	REQUIRE(cli.Suggest("v") == std::vector<std::string>{ "-v", "-V" });
+	REQUIRE(cli.Suggest("x").empty());
+}
+
+TEST_CASE("UnknownArgument keeps every suggestion", "[ArgsParser][suggest][Diagnostics]") {
+	SuggestCli cli;
+
+	const args_parse::Diagnostic longName = cli.Unknown("--trads");
+	REQUIRE(longName.suggestions[0].name == "threads");
+	REQUIRE(longName.suggestions[1].name == "trace");
+	REQUIRE(longName.suggestions[2].name == "stats");
+	REQUIRE_FALSE(longName.suggestions[0].isShort);
+	REQUIRE(cli.Rendered() == "Unknown argument: --trads (did you mean --threads, --trace or --stats?)\n");
+
+	const args_parse::Diagnostic shortName = cli.Unknown("-T=4");
+	REQUIRE(shortName.suggestions[0].name == "t");
+	REQUIRE(shortName.suggestions[0].isShort);
+	REQUIRE(shortName.suggestions[1].name.empty());
+	REQUIRE(cli.Rendered() == "Unknown argument: -T=4 (did you mean -t?)\n");
+
+	// Текст после '-' сравнивается и с длинными именами
+	cli.Unknown("-xerbose");
+	REQUIRE(cli.Rendered() == "Unknown argument: -xerbose (did you mean --verbose?)\n");
+
+	cli.Unknown("--zzzzzzzz");
+	REQUIRE(cli.Rendered() == "Unknown argument: --zzzzzzzz\n");
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Summary.hpp>
+#include <SyntheticFileSystem.hpp>
+#include <Traversal.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+TEST_CASE("Subtree totals add up to every file of the tree", "[Summary]") {
+	SyntheticTreeOptions options;
+	options.depth = 4;
+	options.fanout = 5;
+	options.files = 7;
+	options.skew = 0.5;
+	SyntheticFileSystem fileSystem(options);
+	const SyntheticTreeSize size = fileSystem.Size();
+
+	for (unsigned threads : { 0u, 4u }) {
+		OutputWriter output;
+		NodeTable nodes;
+		SummaryTable summary;
+		ThreadPool pool(threads, std::chrono::milliseconds(0));
+		TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+		context._summary = &summary;
+		const std::uint32_t root = TraverseFileSystem(fileSystem, context);
+
+		// Ожидаемые итоги корня - по всем узлам таблицы
+		std::uint64_t bytes = 0;
+		std::uint64_t directories = 0;
+		for (std::uint32_t i = 0; i < nodes.Size(); ++i) {
+			if (nodes[i].type == NodeType::File)
+				bytes += nodes[i].size;
+			else if (i != root)
+				++directories;
+		}
+		const DirectorySummary* total = summary.Find(root);
+		REQUIRE(total != nullptr);
+		REQUIRE(total->_subtree.files == size.files);
+		REQUIRE(total->_subtree.directories == size.directories - 1);
+		REQUIRE(total->_subtree.directories == directories);
+		REQUIRE(total->_subtree.bytes == bytes);
+		REQUIRE(total->_subtree.newest != 0);
+
+		// Итоги директории - ее файлы и итоги поддиректорий
+		for (std::uint32_t i = 0; i < nodes.Size(); ++i) {
+			if (nodes[i].type != NodeType::Directory)
+				continue;
+			const DirectorySummary* directory = summary.Find(i);
+			REQUIRE(directory != nullptr);
+			Totals expected = directory->_own;
+			for (std::uint32_t k = 0; k < directory->_childCount; ++k)
+				expected += directory->_children[k]._subtree;
+			REQUIRE(directory->_subtree.bytes == expected.bytes);
+			REQUIRE(directory->_subtree.files == expected.files);
+			REQUIRE(directory->_pending.load() == 0);
+		}
+
+		// Строка отчета на каждую директорию, корень - самый большой
+		const std::string report = summary.Report(nodes);
+		std::size_t lines = 0;
+		for (const char c : report)
+			lines += c == '\n';
+		REQUIRE(lines == size.directories + 1);
+		REQUIRE(summary.Report(nodes, 0).find("\tsynthetic\n") != std::string::npos);
+	}
+}
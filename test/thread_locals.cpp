@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <ThreadLocals.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// @brief Экземпляр с объектами потоков, считающий созданные объекты
+	struct Owner {
+		std::vector<std::unique_ptr<int>> locals;
+		std::mutex localsMutex;
+		ThreadLocals threadLocals;
+
+		int& Local() {
+			return threadLocals.Local<int>([this] {
+				std::lock_guard<std::mutex> lock(localsMutex);
+				locals.push_back(std::make_unique<int>(0));
+				return locals.back().get();
+			});
+		}
+	};
+}
+
+TEST_CASE("Alternating instances reuse each thread's object", "[ThreadLocals]") {
+	// Экземпляров больше, чем помнит кэш потока: часть обращений идет мимо кэша
+	constexpr std::size_t Instances = 20;
+	constexpr unsigned Threads = 4;
+	constexpr int Rounds = 1000;
+	std::vector<Owner> owners(Instances);
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < Threads; ++t) {
+		threads.emplace_back([&owners] {
+			for (int round = 0; round < Rounds; ++round)
+				for (Owner& owner : owners)
+					++owner.Local();
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	for (Owner& owner : owners) {
+		REQUIRE(owner.locals.size() == Threads);
+		for (const auto& local : owner.locals)
+			REQUIRE(*local == Rounds);
+	}
+}
+
+TEST_CASE("A new instance does not see a destroyed one's objects", "[ThreadLocals]") {
+	for (int i = 0; i < 100; ++i) {
+		Owner owner;
+		REQUIRE(owner.Local() == 0);
+		owner.Local() = i + 1;
+		REQUIRE(owner.locals.size() == 1);
+	}
+}
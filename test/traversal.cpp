@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Traversal.hpp>
+
+#include "traversal_support.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace {
+	/// @brief Запись списка: тип, размер и полный путь
+	struct Record {
+		std::string type;
+		std::uint64_t size = 0;
+		std::string path;
+
+		bool operator<(const Record& other) const { return std::tie(path, type, size) < std::tie(other.path, other.type, other.size); }
+		bool operator==(const Record& other) const { return std::tie(path, type, size) == std::tie(other.path, other.type, other.size); }
+	};
+
+	/// @brief Обход root в формате TSV; записи упорядочены по пути
+	std::vector<Record> ListTsv(const std::filesystem::path& root, TraversalBackend backend,
+		SchedulingPolicy policy = SchedulingPolicy::DepthFirst, unsigned threads = 2) {
+		test_support::CaptureStdout capture;
+		{
+			OutputWriter output;
+			NodeTable nodes;
+			ThreadPool pool(threads, std::chrono::milliseconds(0), nullptr, policy);
+			TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0), OutputFormat::Tsv };
+			TraverseDirectory(root, context, backend);
+		}
+		std::istringstream lines(capture.Text());
+		std::string line;
+		std::getline(lines, line);
+		REQUIRE(line == "type\tsize\tmtime\tpath");
+		std::vector<Record> records;
+		while (std::getline(lines, line)) {
+			std::istringstream fields(line);
+			Record record;
+			std::string size, mtime;
+			std::getline(fields, record.type, '\t');
+			std::getline(fields, size, '\t');
+			std::getline(fields, mtime, '\t');
+			std::getline(fields, record.path);
+			record.size = std::stoull(size);
+			records.push_back(record);
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+
+	/// @brief Ожидаемый список по std::filesystem: размеры файлов, у директорий 0
+	std::vector<Record> Expected(const std::filesystem::path& root) {
+		std::vector<Record> records;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+			const bool directory = entry.is_directory();
+			records.push_back({ directory ? "dir" : "file", directory ? 0 : entry.file_size(), entry.path().string() });
+		}
+		std::sort(records.begin(), records.end());
+		return records;
+	}
+}
+
+TEST_CASE("Every backend lists the same tree", "[Traversal]") {
+	const test_support::TemporaryTree tree("directory_travers_test_backends");
+	const std::vector<Record> expected = Expected(tree.Root());
+	REQUIRE(expected.size() == 29);
+	for (TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring })
+		REQUIRE(ListTsv(tree.Root(), backend) == expected);
+}
+
+TEST_CASE("A pool without threads traverses on the calling thread", "[Traversal]") {
+	const test_support::TemporaryTree tree("directory_travers_test_no_threads");
+	const std::vector<Record> expected = Expected(tree.Root());
+	for (TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring })
+		REQUIRE(ListTsv(tree.Root(), backend, SchedulingPolicy::DepthFirst, 0) == expected);
+}
+
+TEST_CASE("Every backend lists the same tree under every scheduling policy", "[Traversal]") {
+	const test_support::TemporaryTree tree("directory_travers_test_policies");
+	const std::vector<Record> expected = Expected(tree.Root());
+	for (SchedulingPolicy policy : { SchedulingPolicy::DepthFirst, SchedulingPolicy::BreadthFirst, SchedulingPolicy::Hybrid })
+		for (TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring })
+			REQUIRE(ListTsv(tree.Root(), backend, policy, 3) == expected);
+}
+
+TEST_CASE("A directory that cannot be opened is reported", "[Traversal]") {
+	const std::filesystem::path missing = std::filesystem::temp_directory_path() / "directory_travers_test_missing";
+	std::filesystem::remove_all(missing);
+	for (TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring }) {
+		test_support::CaptureStdout capture;
+		Stats stats;
+		OutputWriter output;
+		NodeTable nodes;
+		ThreadPool pool(2, std::chrono::milliseconds(0));
+		TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+		context._stats = &stats;
+		TraverseDirectory(missing, context, backend);
+		REQUIRE(context._openFailures.load() == 1);
+		REQUIRE(stats.Collect().Get(StatCounter::OpenFailures) == 1);
+	}
+}
+
+TEST_CASE("A directory whose listing fails is counted like one that cannot be opened", "[Traversal]") {
+	// getdents64 с ошибкой не удается вызвать на обычной ФС, поэтому проверяется сам учет
+	Stats stats;
+	OutputWriter output;
+	NodeTable nodes;
+	ThreadPool pool(1, std::chrono::milliseconds(0));
+	TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0) };
+	context._stats = &stats;
+	const std::uint32_t root = nodes.AddRoot("directory_travers_test_unreadable");
+	ReportReadFailure(context, root, EIO);
+	REQUIRE(context._openFailures.load() == 1);
+	REQUIRE(stats.Collect().Get(StatCounter::OpenFailures) == 1);
+}
+
+namespace {
+	/// @brief Обход широкого дерева в дочернем процессе с малым RLIMIT_NOFILE.
+	/// Код выхода 0 - прочитаны все директории и ни одна не пропущена
+	int TraverseWithFewDescriptors(const std::filesystem::path& root, std::uint32_t directories,
+		TraversalBackend backend, SchedulingPolicy policy, unsigned threads) {
+		const pid_t child = ::fork();
+		if (child == 0) {
+			const int null = ::open("/dev/null", O_WRONLY);
+			::dup2(null, STDOUT_FILENO);
+			::dup2(null, STDERR_FILENO);
+			::close(null);
+			const struct rlimit files { 64, 64 };
+			if (::setrlimit(RLIMIT_NOFILE, &files) != 0)
+				::_exit(2);
+			std::uint32_t read = 0;
+			std::uint64_t failures = 0;
+			{
+				OutputWriter output;
+				NodeTable nodes;
+				ThreadPool pool(threads, std::chrono::milliseconds(0), nullptr, policy);
+				TraversalContext context{ pool, nodes, output, std::chrono::milliseconds(0), OutputFormat::Tsv };
+				TraverseDirectory(root, context, backend);
+				for (std::uint32_t i = 0; i < nodes.Size(); ++i)
+					read += nodes[i].type == NodeType::Directory;
+				failures = context._openFailures.load();
+			}
+			::_exit(read == directories && failures == 0 ? 0 : 1);
+		}
+		int status = 0;
+		if (child < 0 || ::waitpid(child, &status, 0) != child || !WIFEXITED(status))
+			return -1;
+		return WEXITSTATUS(status);
+	}
+}
+
+TEST_CASE("Wide trees are traversed completely with few file descriptors", "[Traversal]") {
+	// 1500 поддиректорий корня, у каждой своя поддиректория: в очереди bfs родителей больше, чем дескрипторов
+	const std::filesystem::path root = std::filesystem::temp_directory_path() / "directory_travers_test_wide";
+	std::filesystem::remove_all(root);
+	constexpr std::uint32_t Width = 1500;
+	for (std::uint32_t i = 0; i < Width; ++i)
+		std::filesystem::create_directories(root / ("dir_" + std::to_string(i)) / "inner");
+	const std::uint32_t directories = 1 + 2 * Width;
+
+	for (SchedulingPolicy policy : { SchedulingPolicy::DepthFirst, SchedulingPolicy::BreadthFirst, SchedulingPolicy::Hybrid })
+		for (TraversalBackend backend : { TraversalBackend::Filesystem, TraversalBackend::Getdents, TraversalBackend::Uring })
+			for (unsigned threads : { 0u, 2u }) {
+				INFO("backend " << static_cast<int>(backend) << ", policy " << static_cast<int>(policy) << ", threads " << threads);
+				REQUIRE(TraverseWithFewDescriptors(root, directories, backend, policy, threads) == 0);
+			}
+	std::filesystem::remove_all(root);
+}
+#endif
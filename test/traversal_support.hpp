@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace test_support {
+	/// @brief Небольшое дерево во временной директории с файлами разного размера, пустой директорией
+	/// и именами с пробелами; удаляется вместе с объектом
+	class TemporaryTree {
+	public:
+		explicit TemporaryTree(const std::string& name) : _root(std::filesystem::temp_directory_path() / name) {
+			std::filesystem::remove_all(_root);
+			for (int d = 0; d < 3; ++d) {
+				const auto directory = _root / ("dir_" + std::to_string(d));
+				std::filesystem::create_directories(directory / "nested" / "deeper");
+				for (int f = 0; f < 5; ++f)
+					std::ofstream(directory / ("file_" + std::to_string(f) + ".dat")) << std::string(static_cast<std::size_t>(d * 100 + f), 'x');
+				std::ofstream(directory / "nested" / "deeper" / "leaf.txt") << "leaf";
+			}
+			std::filesystem::create_directories(_root / "empty");
+			std::ofstream(_root / "with space.txt") << "spaced";
+		}
+		~TemporaryTree() {
+			std::error_code error;
+			std::filesystem::remove_all(_root, error);
+		}
+
+		TemporaryTree(const TemporaryTree&) = delete;
+		TemporaryTree& operator=(const TemporaryTree&) = delete;
+
+		[[nodiscard]] const std::filesystem::path& Root() const { return _root; }
+
+	private:
+		std::filesystem::path _root;
+	};
+
+#ifdef __linux__
+	/// @brief Перехват всего, что записано в дескриптор 1, на время жизни объекта
+	/// (OutputWriter пишет прямо в дескриптор, минуя std::cout)
+	class CaptureStdout {
+	public:
+		CaptureStdout() : _file(std::filesystem::temp_directory_path() / ("directory_travers_test_stdout_" + std::to_string(::getpid()))) {
+			std::fflush(stdout);
+			_saved = ::dup(STDOUT_FILENO);
+			const int file = ::open(_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+			::dup2(file, STDOUT_FILENO);
+			::close(file);
+		}
+		~CaptureStdout() {
+			Restore();
+			std::error_code error;
+			std::filesystem::remove(_file, error);
+		}
+
+		CaptureStdout(const CaptureStdout&) = delete;
+		CaptureStdout& operator=(const CaptureStdout&) = delete;
+
+		/// @brief Возврат дескриптора 1 и все перехваченные байты
+		[[nodiscard]] std::string Text() {
+			Restore();
+			std::ifstream input(_file, std::ios::binary);
+			return { std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+		}
+
+	private:
+		void Restore() {
+			if (_saved < 0)
+				return;
+			std::fflush(stdout);
+			::dup2(_saved, STDOUT_FILENO);
+			::close(_saved);
+			_saved = -1;
+		}
+
+		std::filesystem::path _file;
+		int _saved = -1;
+	};
+#endif
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WorkStealingDeque.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Owner pops in LIFO order, thieves steal in FIFO order", "[WorkStealingDeque]") {
+	int items[4] = { 0, 1, 2, 3 };
+	WorkStealingDeque<int> deque(2);
+	REQUIRE(deque.Empty());
+	REQUIRE(deque.Pop() == nullptr);
+	REQUIRE(deque.Steal() == nullptr);
+
+	for (int& item : items)
+		deque.Push(&item);
+	REQUIRE_FALSE(deque.Empty());
+	REQUIRE(deque.Pop() == &items[3]);
+	REQUIRE(deque.Steal() == &items[0]);
+	REQUIRE(deque.Pop() == &items[2]);
+	REQUIRE(deque.Steal() == &items[1]);
+	REQUIRE(deque.Empty());
+	REQUIRE(deque.Pop() == nullptr);
+}
+
+TEST_CASE("The buffer grows without losing items", "[WorkStealingDeque]") {
+	std::vector<int> items(5000);
+	WorkStealingDeque<int> deque(4);
+	for (auto& item : items)
+		deque.Push(&item);
+	// Половина с верхнего конца, половина с нижнего
+	for (std::size_t i = 0; i < items.size() / 2; ++i)
+		REQUIRE(deque.Steal() == &items[i]);
+	for (std::size_t i = items.size(); i > items.size() / 2; --i)
+		REQUIRE(deque.Pop() == &items[i - 1]);
+	REQUIRE(deque.Empty());
+}
+
+TEST_CASE("Concurrent push, pop and steal lose and duplicate nothing", "[WorkStealingDeque]") {
+	constexpr std::size_t Items = 200000;
+	constexpr unsigned Thieves = 3;
+	// Каждый элемент - счетчик того, сколько раз его забрали
+	std::unique_ptr<std::atomic<int>[]> taken(new std::atomic<int>[Items]);
+	for (std::size_t i = 0; i < Items; ++i)
+		taken[i].store(0, std::memory_order_relaxed);
+
+	// Маленькая начальная емкость: буфер растет, пока его читают перехватчики
+	WorkStealingDeque<std::atomic<int>> deque(16);
+	std::atomic<bool> done{ false };
+	std::atomic<std::size_t> stolen{ 0 };
+	std::vector<std::thread> thieves;
+	for (unsigned t = 0; t < Thieves; ++t) {
+		thieves.emplace_back([&] {
+			while (!done.load(std::memory_order_acquire)) {
+				if (std::atomic<int>* item = deque.Steal()) {
+					item->fetch_add(1, std::memory_order_relaxed);
+					stolen.fetch_add(1, std::memory_order_relaxed);
+				}
+				else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	std::size_t popped = 0;
+	for (std::size_t i = 0; i < Items; ++i) {
+		deque.Push(&taken[i]);
+		// Владелец забирает часть работы сам, соревнуясь за последний элемент
+		if (i % 3 == 0) {
+			if (std::atomic<int>* item = deque.Pop()) {
+				item->fetch_add(1, std::memory_order_relaxed);
+				++popped;
+			}
+		}
+	}
+	// nullptr из Pop означает пустой дек (или проигранный перехватчику последний элемент)
+	while (std::atomic<int>* item = deque.Pop()) {
+		item->fetch_add(1, std::memory_order_relaxed);
+		++popped;
+	}
+	done.store(true, std::memory_order_release);
+	for (auto& thief : thieves)
+		thief.join();
+
+	REQUIRE(deque.Empty());
+	REQUIRE(popped + stolen.load() == Items);
+	std::size_t wrong = 0;
+	for (std::size_t i = 0; i < Items; ++i)
+		wrong += taken[i].load(std::memory_order_relaxed) != 1;
+	REQUIRE(wrong == 0);
+}